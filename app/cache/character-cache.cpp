@@ -0,0 +1,222 @@
+// Copyright 2022 Leonhard S.
+
+#include "cache/character-cache.hpp"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QObject>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <utility>
+
+#include "arx.hpp"
+#include "ps2.hpp"
+
+#include "game/character-info.hpp"
+
+namespace {
+
+constexpr quint32 CACHE_FILE_MAGIC = 0x50524343; // "PRCC"
+constexpr quint16 CACHE_FILE_VERSION = 1;
+
+QString getDefaultCachePath() {
+    QString dir = QStandardPaths::writableLocation(
+        QStandardPaths::CacheLocation);
+    return dir + QDir::separator() + "characters.bin";
+}
+
+} // namespace
+
+namespace PresenceApp {
+
+CharacterCache::CharacterCache()
+    : CharacterCache(getDefaultCachePath()) {}
+
+CharacterCache::CharacterCache(const QString& path)
+    : entries_{}
+    , names_{}
+    , path_{ path }
+    , dirty_{ false }
+    , save_timer_{}
+{
+    // Batch bursts of lookups, e.g. on startup, into a single write
+    save_timer_.setSingleShot(true);
+    QObject::connect(&save_timer_, &QTimer::timeout, [this]() {
+        if (dirty_) {
+            save();
+        }
+    });
+    auto status = load();
+    if (status == 0) {
+        qDebug() << "Loaded" << entries_.size()
+            << "cached characters from" << path_;
+    }
+    else if (status == -2) {
+        qWarning() << "Ignoring invalid character cache" << path_;
+    }
+}
+
+CharacterCache::~CharacterCache() {
+    // Final flush of anything changed since the last timed save
+    save_timer_.stop();
+    if (dirty_) {
+        save();
+    }
+}
+
+int CharacterCache::find(
+    arx::character_id_t id,
+    CharacterData* character
+) const {
+    auto it = entries_.constFind(id);
+    if (it == entries_.constEnd()) {
+        return -1;
+    }
+    *character = it->character_;
+    return status(*it);
+}
+
+int CharacterCache::findByName(
+    const QString& name,
+    CharacterData* character
+) const {
+    auto it = names_.constFind(name.toLower());
+    if (it == names_.constEnd()) {
+        return -1;
+    }
+    return find(*it, character);
+}
+
+void CharacterCache::insert(const CharacterData& character) {
+    if (character.id_ == 0) {
+        return;
+    }
+    // Drop the old name mapping in case the character was renamed
+    auto it = entries_.constFind(character.id_);
+    if (it != entries_.constEnd()) {
+        names_.remove(it->character_.name_.toLower());
+    }
+    entries_.insert(character.id_,
+        Entry{ character, QDateTime::currentMSecsSinceEpoch() });
+    names_.insert(character.name_.toLower(), character.id_);
+    markDirty();
+}
+
+qsizetype CharacterCache::size() const {
+    return entries_.size();
+}
+
+QString CharacterCache::getPath() const {
+    return path_;
+}
+
+int CharacterCache::load() {
+    QFile file(path_);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_4);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok
+        || magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION) {
+        return -2;
+    }
+    QHash<arx::character_id_t, Entry> entries;
+    QHash<QString, arx::character_id_t> names;
+    entries.reserve(static_cast<qsizetype>(count));
+    for (quint32 i = 0; i < count; ++i) {
+        quint64 id = 0;
+        QString name;
+        qint32 faction_id = 0;
+        qint32 profile_id = 0;
+        qint32 world_id = 0;
+        qint64 fetched_at = 0;
+        stream >> id >> name >> faction_id >> profile_id >> world_id
+            >> fetched_at;
+        if (stream.status() != QDataStream::Ok) {
+            return -2;
+        }
+        // IDs are stored rather than enum values so the file stays valid
+        // if the enums are reordered; entries that no longer map are
+        // marked stale to have them refetched.
+        CharacterData character;
+        character.id_ = id;
+        character.name_ = name;
+        if (ps2::faction_from_faction_id(
+            static_cast<arx::faction_id_t>(faction_id),
+            &character.faction_) != 0
+            || ps2::class_from_profile_id(
+                static_cast<arx::profile_id_t>(profile_id),
+                &character.class_) != 0
+            || ps2::server_from_world_id(
+                static_cast<arx::world_id_t>(world_id),
+                &character.server_) != 0) {
+            fetched_at = 0;
+        }
+        entries.insert(character.id_, Entry{ character, fetched_at });
+        names.insert(name.toLower(), character.id_);
+    }
+    entries_ = std::move(entries);
+    names_ = std::move(names);
+    dirty_ = false;
+    return 0;
+}
+
+int CharacterCache::save() {
+    QDir().mkpath(QFileInfo(path_).absolutePath());
+    QSaveFile file(path_);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write character cache" << path_
+            << file.errorString();
+        return -1;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_4);
+    stream << CACHE_FILE_MAGIC << CACHE_FILE_VERSION
+        << static_cast<quint32>(entries_.size());
+    for (const auto& entry : entries_) {
+        const auto& character = entry.character_;
+        stream << static_cast<quint64>(character.id_)
+            << character.name_
+            << static_cast<qint32>(
+                ps2::faction_to_faction_id(character.faction_))
+            << static_cast<qint32>(ps2::class_to_profile_id(
+                character.class_, character.faction_))
+            << static_cast<qint32>(
+                ps2::server_to_world_id(character.server_))
+            << entry.fetched_at_;
+    }
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Unable to write character cache" << path_
+            << file.errorString();
+        return -1;
+    }
+    dirty_ = false;
+    return 0;
+}
+
+int CharacterCache::status(const Entry& entry) const {
+    auto age = QDateTime::currentMSecsSinceEpoch() - entry.fetched_at_;
+    return age < CHARACTER_TTL ? 0 : 1;
+}
+
+void CharacterCache::markDirty() {
+    dirty_ = true;
+    if (!save_timer_.isActive()) {
+        save_timer_.start(SAVE_DELAY);
+    }
+}
+
+} // namespace PresenceApp
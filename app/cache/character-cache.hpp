@@ -0,0 +1,103 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include "arx.hpp"
+
+#include "game/character-info.hpp"
+
+namespace PresenceApp {
+
+/**
+ * On-disk cache of character metadata as returned by the Census API.
+ *
+ * Entries remain usable after they become stale so that the app can show
+ * them immediately; callers are expected to refresh stale entries in the
+ * background. The cache is stored as a compact binary file. Changes are
+ * written back SAVE_DELAY milliseconds after the first modification, so
+ * they survive the app being killed, and once more on destruction.
+ *
+ * The cache must be used from a thread with an event loop.
+ */
+class CharacterCache {
+public:
+    /** Time after which an entry is considered stale, in milliseconds. */
+    static constexpr qint64 CHARACTER_TTL = 24LL * 60 * 60 * 1000;
+    /** Time to wait after a change before writing the cache to disk. */
+    static constexpr int SAVE_DELAY = 10000;
+
+    CharacterCache();
+    explicit CharacterCache(const QString& path);
+    CharacterCache(const CharacterCache& other) = delete;
+    CharacterCache(CharacterCache&& other) noexcept = delete;
+    ~CharacterCache();
+
+    CharacterCache& operator=(const CharacterCache& other) = delete;
+    CharacterCache& operator=(CharacterCache&& other) noexcept = delete;
+
+    /**
+     * Look up a character by ID.
+     *
+     * @param id The character ID to look up.
+     * @param character The character data to be populated.
+     * @return 0 if the entry is fresh, 1 if it is stale, -1 if there is no
+     * entry for the character.
+     */
+    int find(arx::character_id_t id, CharacterData* character) const;
+
+    /**
+     * Look up a character by name, ignoring case.
+     *
+     * @param name The character name to look up.
+     * @param character The character data to be populated.
+     * @return 0 if the entry is fresh, 1 if it is stale, -1 if there is no
+     * entry for the character.
+     */
+    int findByName(const QString& name, CharacterData* character) const;
+
+    /**
+     * Insert or refresh the entry for a character.
+     *
+     * @param character The character data to store.
+     */
+    void insert(const CharacterData& character);
+
+    qsizetype size() const;
+    QString getPath() const;
+
+    /**
+     * Replace the cache contents with the on-disk cache file.
+     *
+     * @return 0 on success, -1 if there is no cache file, -2 if the file
+     * is invalid or of an unsupported version.
+     */
+    int load();
+
+    /**
+     * Write the cache contents to disk.
+     *
+     * @return 0 on success, -1 if the file could not be written.
+     */
+    int save();
+
+private:
+    struct Entry {
+        CharacterData character_;
+        qint64 fetched_at_;
+    };
+
+    int status(const Entry& entry) const;
+    void markDirty();
+
+    QHash<arx::character_id_t, Entry> entries_;
+    QHash<QString, arx::character_id_t> names_;
+    QString path_;
+    bool dirty_;
+    QTimer save_timer_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,472 @@
+// Copyright 2022 Leonhard S.
+
+#include "cache/reference-data.hpp"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "arx.hpp"
+
+#include "appdata/service-id.hpp"
+#include "cache/tlru-cache.hpp"
+#include "census-client.hpp"
+
+namespace {
+
+const QString SNAPSHOT_VERSION = "1.0";
+
+QString getDefaultSnapshotPath() {
+    QString dir = QStandardPaths::writableLocation(
+        QStandardPaths::CacheLocation);
+    return dir + QDir::separator() + "reference-data.json";
+}
+
+qint64 currentTime() {
+    // Wall clock time so expiry times remain valid across runs
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+const char* referenceKindIdField(PresenceApp::ReferenceKind kind) {
+    switch (kind) {
+    case PresenceApp::ReferenceKind::Faction:
+        return "faction_id";
+    case PresenceApp::ReferenceKind::Loadout:
+        return "loadout_id";
+    case PresenceApp::ReferenceKind::Vehicle:
+        return "vehicle_id";
+    case PresenceApp::ReferenceKind::World:
+        return "world_id";
+    case PresenceApp::ReferenceKind::Zone:
+        return "zone_id";
+    }
+    return "";
+}
+
+arx::Query buildReferenceQuery(PresenceApp::ReferenceKind kind) {
+    arx::Query query(
+        PresenceApp::referenceKindCollection(kind), SERVICE_ID);
+    // The ID term is filled in per batch. The Census API treats
+    // comma-separated values as a list of alternatives, which lets a
+    // single query cover the whole batch.
+    query.addTerm(arx::SearchTerm(referenceKindIdField(kind), ""));
+    query.setLimit(PresenceApp::ReferenceDataCache::MAX_BATCH_SIZE);
+    query.setLang("en");
+    switch (kind) {
+    case PresenceApp::ReferenceKind::Faction:
+        query.setShow({ "faction_id", "name", "code_tag" });
+        break;
+    case PresenceApp::ReferenceKind::Loadout:
+        query.setShow({ "loadout_id", "profile_id", "faction_id",
+            "code_name" });
+        break;
+    case PresenceApp::ReferenceKind::Vehicle:
+        query.setShow({ "vehicle_id", "name" });
+        break;
+    case PresenceApp::ReferenceKind::World:
+        query.setShow({ "world_id", "name" });
+        break;
+    case PresenceApp::ReferenceKind::Zone:
+        query.setShow({ "zone_id", "name", "code" });
+        break;
+    }
+    return query;
+}
+
+QString stringFromJson(const arx::json_t& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end()) {
+        return {};
+    }
+    if (it->is_string()) {
+        return QString::fromStdString(it->get<arx::json_string_t>());
+    }
+    // Localised strings are objects keyed by language
+    if (it->is_object()) {
+        auto en = it->find("en");
+        if (en != it->end() && en->is_string()) {
+            return QString::fromStdString(en->get<arx::json_string_t>());
+        }
+    }
+    return {};
+}
+
+qint64 integerFromJson(const arx::json_t& object, const char* key) {
+    // The Census API returns all numbers as quoted strings
+    return stringFromJson(object, key).toLongLong();
+}
+
+PresenceApp::ReferenceRecord recordFromJson(
+    PresenceApp::ReferenceKind kind,
+    const arx::json_t& object
+) {
+    PresenceApp::ReferenceRecord record;
+    record.exists_ = true;
+    switch (kind) {
+    case PresenceApp::ReferenceKind::Faction:
+        record.name_ = stringFromJson(object, "name");
+        record.code_ = stringFromJson(object, "code_tag");
+        record.faction_id_ = static_cast<qint32>(
+            integerFromJson(object, "faction_id"));
+        break;
+    case PresenceApp::ReferenceKind::Loadout:
+        record.name_ = stringFromJson(object, "code_name");
+        record.faction_id_ = static_cast<qint32>(
+            integerFromJson(object, "faction_id"));
+        record.profile_id_ = static_cast<qint32>(
+            integerFromJson(object, "profile_id"));
+        break;
+    case PresenceApp::ReferenceKind::Zone:
+        record.name_ = stringFromJson(object, "name");
+        record.code_ = stringFromJson(object, "code");
+        break;
+    case PresenceApp::ReferenceKind::Vehicle:
+    case PresenceApp::ReferenceKind::World:
+        record.name_ = stringFromJson(object, "name");
+        break;
+    }
+    return record;
+}
+
+} // namespace
+
+namespace PresenceApp {
+
+const char* referenceKindCollection(ReferenceKind kind) {
+    switch (kind) {
+    case ReferenceKind::Faction:
+        return "faction";
+    case ReferenceKind::Loadout:
+        return "loadout";
+    case ReferenceKind::Vehicle:
+        return "vehicle";
+    case ReferenceKind::World:
+        return "world";
+    case ReferenceKind::Zone:
+        return "zone";
+    }
+    return "";
+}
+
+ReferenceDataCache::ReferenceDataCache(QObject* parent)
+    : ReferenceDataCache(getDefaultSnapshotPath(), parent) {}
+
+ReferenceDataCache::ReferenceDataCache(
+    const QString& snapshot_path,
+    QObject* parent
+)
+    : QObject{ parent }
+    , records_{ CAPACITY, RECORD_TTL }
+    , pending_{}
+    , in_flight_{}
+    , queries_{}
+    , snapshot_path_{ snapshot_path }
+    , dirty_{ false }
+{
+    queries_.reserve(REFERENCE_KIND_COUNT);
+    for (std::size_t i = 0; i < REFERENCE_KIND_COUNT; ++i) {
+        queries_.push_back(arx::QueryTemplate::intern(
+            buildReferenceQuery(static_cast<ReferenceKind>(i))));
+    }
+    batch_timer_.reset(new QTimer(this));
+    batch_timer_->setSingleShot(true);
+    QObject::connect(batch_timer_.get(), &QTimer::timeout,
+        this, &ReferenceDataCache::onBatchTimerExpired);
+    retry_timer_.reset(new QTimer(this));
+    retry_timer_->setSingleShot(true);
+    QObject::connect(retry_timer_.get(), &QTimer::timeout,
+        this, &ReferenceDataCache::onRetryTimerExpired);
+    save_timer_.reset(new QTimer(this));
+    save_timer_->setSingleShot(true);
+    QObject::connect(save_timer_.get(), &QTimer::timeout,
+        this, &ReferenceDataCache::onSaveTimerExpired);
+    // Warm start; anything missing is only requested once it is looked up
+    auto status = loadSnapshot();
+    if (status == 0) {
+        qDebug() << "Loaded" << records_.size()
+            << "reference data records from" << snapshot_path_;
+    }
+    else if (status == -2) {
+        qWarning() << "Ignoring invalid reference data snapshot"
+            << snapshot_path_;
+    }
+}
+
+ReferenceDataCache::~ReferenceDataCache() {
+    if (dirty_) {
+        saveSnapshot();
+    }
+}
+
+int ReferenceDataCache::lookup(
+    ReferenceKind kind,
+    qint64 id,
+    ReferenceRecord* record
+) {
+    auto cached = records_.find(makeKey(kind, id), currentTime());
+    if (cached != nullptr) {
+        if (!cached->exists_) {
+            return -2;
+        }
+        *record = *cached;
+        return 0;
+    }
+    // Queue the ID for the next batch unless it is already being fetched
+    // or waiting to be retried
+    auto index = static_cast<std::size_t>(kind);
+    if (!in_flight_[index].contains(id) && !retrying_[index].contains(id)) {
+        pending_[index].insert(id);
+        if (!batch_timer_->isActive()) {
+            batch_timer_->start(BATCH_DELAY);
+        }
+    }
+    return -1;
+}
+
+QString ReferenceDataCache::getName(
+    ReferenceKind kind,
+    qint64 id,
+    const QString& fallback
+) {
+    ReferenceRecord record;
+    if (lookup(kind, id, &record) != 0 || record.name_.isEmpty()) {
+        return fallback;
+    }
+    return record.name_;
+}
+
+std::size_t ReferenceDataCache::size() const {
+    return records_.size();
+}
+
+QString ReferenceDataCache::getSnapshotPath() const {
+    return snapshot_path_;
+}
+
+int ReferenceDataCache::loadSnapshot() {
+    QFile file(snapshot_path_);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    auto document = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    auto json = document.object();
+    if (json["version"].toString() != SNAPSHOT_VERSION) {
+        return -2;
+    }
+    records_.clear();
+    auto now = currentTime();
+    // Records are stored least recently used first, so re-inserting them
+    // in order restores the eviction order.
+    for (auto&& value : json["records"].toArray()) {
+        auto object = value.toObject();
+        auto kind_index = object["kind"].toInt(-1);
+        auto expires_at = object["expires"].toString().toLongLong();
+        if (kind_index < 0
+            || kind_index >= static_cast<int>(REFERENCE_KIND_COUNT)
+            || expires_at <= now) {
+            continue;
+        }
+        ReferenceRecord record;
+        record.name_ = object["name"].toString();
+        record.code_ = object["code"].toString();
+        record.faction_id_ = object["faction_id"].toInt();
+        record.profile_id_ = object["profile_id"].toInt();
+        record.exists_ = object["exists"].toBool();
+        auto key = makeKey(static_cast<ReferenceKind>(kind_index),
+            object["id"].toString().toLongLong());
+        records_.insertUntil(key, record, expires_at);
+    }
+    dirty_ = false;
+    return 0;
+}
+
+int ReferenceDataCache::saveSnapshot() {
+    QJsonArray records;
+    records_.forEach([&records](quint64 key,
+        const ReferenceRecord& record, qint64 expires_at) {
+            QJsonObject object;
+            object["kind"] = static_cast<int>(key >> 32);
+            object["id"] = QString::number(key & 0xFFFFFFFF);
+            object["name"] = record.name_;
+            object["code"] = record.code_;
+            object["faction_id"] = record.faction_id_;
+            object["profile_id"] = record.profile_id_;
+            object["exists"] = record.exists_;
+            object["expires"] = QString::number(expires_at);
+            records.append(object);
+        });
+    QJsonObject json;
+    json["version"] = SNAPSHOT_VERSION;
+    json["records"] = records;
+    QDir().mkpath(QFileInfo(snapshot_path_).absolutePath());
+    QSaveFile file(snapshot_path_);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write reference data snapshot"
+            << snapshot_path_ << file.errorString();
+        return -1;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Unable to write reference data snapshot"
+            << snapshot_path_ << file.errorString();
+        return -1;
+    }
+    dirty_ = false;
+    return 0;
+}
+
+void ReferenceDataCache::onBatchTimerExpired() {
+    for (std::size_t i = 0; i < REFERENCE_KIND_COUNT; ++i) {
+        if (pending_[i].isEmpty()) {
+            continue;
+        }
+        QList<qint64> batch;
+        for (auto id : pending_[i]) {
+            in_flight_[i].insert(id);
+            batch.append(id);
+            if (batch.size() == MAX_BATCH_SIZE) {
+                requestRecords(static_cast<ReferenceKind>(i), batch);
+                batch.clear();
+            }
+        }
+        if (!batch.isEmpty()) {
+            requestRecords(static_cast<ReferenceKind>(i), batch);
+        }
+        pending_[i].clear();
+    }
+}
+
+void ReferenceDataCache::onRetryTimerExpired() {
+    for (std::size_t i = 0; i < REFERENCE_KIND_COUNT; ++i) {
+        pending_[i].unite(retrying_[i]);
+        retrying_[i].clear();
+    }
+    onBatchTimerExpired();
+}
+
+void ReferenceDataCache::onSaveTimerExpired() {
+    if (dirty_) {
+        saveSnapshot();
+    }
+}
+
+quint64 ReferenceDataCache::makeKey(ReferenceKind kind, qint64 id) {
+    return (static_cast<quint64>(kind) << 32)
+        | (static_cast<quint64>(id) & 0xFFFFFFFF);
+}
+
+void ReferenceDataCache::requestRecords(
+    ReferenceKind kind,
+    const QList<qint64>& ids
+) {
+    std::string id_list;
+    for (auto id : ids) {
+        if (!id_list.empty()) {
+            id_list.push_back(',');
+        }
+        id_list.append(std::to_string(id));
+    }
+    std::string_view values[] = { id_list };
+    CensusClient::shared()->get(
+        queries_[static_cast<std::size_t>(kind)], values, this,
+        [this, kind, ids](const CensusResult& result) {
+            handleResult(kind, ids, result);
+        });
+}
+
+void ReferenceDataCache::handleResult(
+    ReferenceKind kind,
+    const QList<qint64>& ids,
+    const CensusResult& result
+) {
+    auto index = static_cast<std::size_t>(kind);
+    for (auto id : ids) {
+        in_flight_[index].remove(id);
+    }
+    if (result.status_ != 0
+        || handlePayload(kind, ids, result.payload_) != 0) {
+        // Retry later rather than hammering the API on every lookup; new
+        // lookups keep using the regular batch delay
+        for (auto id : ids) {
+            retrying_[index].insert(id);
+        }
+        if (!retry_timer_->isActive()) {
+            retry_timer_->start(RETRY_DELAY);
+        }
+        return;
+    }
+    markDirty();
+    emit recordsResolved(kind);
+}
+
+int ReferenceDataCache::handlePayload(
+    ReferenceKind kind,
+    const QList<qint64>& ids,
+    const arx::json_t& payload
+) {
+    const auto* collection = referenceKindCollection(kind);
+    if (arx::validatePayload(collection, payload) != 0) {
+        qWarning() << "ReferenceDataCache::handlePayload(): Invalid"
+            << collection << "payload";
+        return -1;
+    }
+    auto now = currentTime();
+    QSet<qint64> missing{ ids.begin(), ids.end() };
+    for (const auto& object : arx::payloadResultsAsArray(
+        collection, payload)) {
+        auto id = integerFromJson(object, referenceKindIdField(kind));
+        if (!missing.remove(id)) {
+            continue;
+        }
+        records_.insert(makeKey(kind, id), recordFromJson(kind, object), now);
+    }
+    // Remember IDs the API does not know so they are not requested on
+    // every lookup
+    for (auto id : missing) {
+        records_.insertUntil(
+            makeKey(kind, id), ReferenceRecord{}, now + MISSING_RECORD_TTL);
+    }
+    return 0;
+}
+
+void ReferenceDataCache::markDirty() {
+    dirty_ = true;
+    if (!save_timer_->isActive()) {
+        save_timer_->start(SAVE_DELAY);
+    }
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_reference-data.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
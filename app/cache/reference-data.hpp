@@ -0,0 +1,168 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "arx.hpp"
+
+#include "cache/tlru-cache.hpp"
+#include "census-client.hpp"
+
+namespace PresenceApp {
+
+/** Census API collections held by the reference data cache. */
+enum class ReferenceKind {
+    Faction,
+    Loadout,
+    Vehicle,
+    World,
+    Zone,
+};
+
+inline constexpr std::size_t REFERENCE_KIND_COUNT =
+    static_cast<std::size_t>(ReferenceKind::Zone) + 1;
+
+/**
+ * Get the Census API collection name for a reference data kind.
+ */
+const char* referenceKindCollection(ReferenceKind kind);
+
+/**
+ * A single record of static game data as returned by the Census API.
+ *
+ * Fields not provided by a given collection are left empty or zero.
+ * Records for IDs the API does not know are cached with exists_ unset so
+ * they are not requested again until they expire.
+ */
+struct ReferenceRecord {
+    QString name_;
+    QString code_;
+    qint32 faction_id_ = 0;
+    qint32 profile_id_ = 0;
+    bool exists_ = false;
+};
+
+/**
+ * Census-backed cache of static game data such as zone and vehicle names.
+ *
+ * Lookups are answered from memory and never block. Misses are collected
+ * and resolved asynchronously, with all IDs of a given kind requested
+ * within a short window combined into a single query. The cache contents
+ * are persisted to disk so that subsequent runs start warm without any
+ * network requests.
+ */
+class ReferenceDataCache: public QObject {
+    Q_OBJECT
+
+public:
+    /** Maximum number of records held across all kinds. */
+    static constexpr std::size_t CAPACITY = 2048;
+    /** Time after which a record is fetched again, in milliseconds. */
+    static constexpr qint64 RECORD_TTL = 7LL * 24 * 60 * 60 * 1000;
+    /** Time after which an unknown ID is requested again. */
+    static constexpr qint64 MISSING_RECORD_TTL = 60LL * 60 * 1000;
+    /** Time misses are collected for before they are requested. */
+    static constexpr int BATCH_DELAY = 50;
+    /** Time to wait before retrying after a failed request. */
+    static constexpr int RETRY_DELAY = 30000;
+    /** Maximum number of IDs requested per query. */
+    static constexpr int MAX_BATCH_SIZE = 100;
+    /** Time changes are collected for before the snapshot is written. */
+    static constexpr int SAVE_DELAY = 10000;
+
+    explicit ReferenceDataCache(QObject* parent = nullptr);
+    ReferenceDataCache(const QString& snapshot_path, QObject* parent = nullptr);
+    ReferenceDataCache(const ReferenceDataCache& other) = delete;
+    ReferenceDataCache(ReferenceDataCache&& other) noexcept = delete;
+    ~ReferenceDataCache() override;
+
+    ReferenceDataCache& operator=(const ReferenceDataCache& other) = delete;
+    ReferenceDataCache& operator=(ReferenceDataCache&& other) noexcept = delete;
+
+    /**
+     * Look up a record without blocking.
+     *
+     * If the record is not cached, it is requested in the background and
+     * recordsResolved() is emitted once it is available.
+     *
+     * @param kind The kind of record to look up.
+     * @param id The Census API ID of the record.
+     * @param record The record to be populated.
+     * @return 0 on success, -1 if the record is not cached yet, -2 if the
+     * API does not know the ID.
+     */
+    int lookup(ReferenceKind kind, qint64 id, ReferenceRecord* record);
+
+    /**
+     * Look up the display name of a record without blocking.
+     *
+     * @param kind The kind of record to look up.
+     * @param id The Census API ID of the record.
+     * @param fallback The name to return if the record is not available.
+     * @return The cached name, or the fallback.
+     */
+    QString getName(ReferenceKind kind, qint64 id, const QString& fallback);
+
+    std::size_t size() const;
+    QString getSnapshotPath() const;
+
+    /**
+     * Replace the cache contents with the on-disk snapshot.
+     *
+     * Expired records in the snapshot are skipped.
+     *
+     * @return 0 on success, -1 if there is no snapshot, -2 if the snapshot
+     * is invalid or of an unsupported version.
+     */
+    int loadSnapshot();
+
+    /**
+     * Write the cache contents to the on-disk snapshot.
+     *
+     * @return 0 on success, -1 if the snapshot could not be written.
+     */
+    int saveSnapshot();
+
+Q_SIGNALS:
+    void recordsResolved(ReferenceKind kind);
+
+private Q_SLOTS:
+    void onBatchTimerExpired();
+    void onRetryTimerExpired();
+    void onSaveTimerExpired();
+
+private:
+    static quint64 makeKey(ReferenceKind kind, qint64 id);
+
+    void requestRecords(ReferenceKind kind, const QList<qint64>& ids);
+    void handleResult(ReferenceKind kind, const QList<qint64>& ids,
+        const CensusResult& result);
+    int handlePayload(ReferenceKind kind, const QList<qint64>& ids,
+        const arx::json_t& payload);
+    void markDirty();
+
+    TlruCache<quint64, ReferenceRecord> records_;
+    std::array<QSet<qint64>, REFERENCE_KIND_COUNT> pending_;
+    std::array<QSet<qint64>, REFERENCE_KIND_COUNT> in_flight_;
+    /** IDs whose last request failed, waiting for the retry timer. */
+    std::array<QSet<qint64>, REFERENCE_KIND_COUNT> retrying_;
+    /** Request templates, indexed by reference kind. */
+    std::vector<arx::QueryTemplate> queries_;
+    QScopedPointer<QTimer> batch_timer_;
+    QScopedPointer<QTimer> retry_timer_;
+    QScopedPointer<QTimer> save_timer_;
+    QString snapshot_path_;
+    bool dirty_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,176 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace PresenceApp {
+
+/**
+ * Time-aware least recently used cache.
+ *
+ * Entries expire a fixed time after insertion and are evicted in LRU order
+ * once the cache is full. Lookups, insertions and removals are O(1).
+ *
+ * Timestamps are caller-supplied milliseconds, so expiry times may be
+ * persisted and restored across runs when wall clock time is used.
+ *
+ * @tparam Key Key type; must be hashable and equality comparable.
+ * @tparam Value Value type.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class TlruCache {
+public:
+    /**
+     * @param capacity Maximum number of entries; must be at least one.
+     * @param time_to_live Time in milliseconds after which entries expire.
+     */
+    TlruCache(std::size_t capacity, std::int64_t time_to_live)
+        : capacity_{ capacity > 0 ? capacity : 1 }
+        , time_to_live_{ time_to_live }
+        , entries_{}
+        , index_{} {}
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    std::int64_t timeToLive() const {
+        return time_to_live_;
+    }
+
+    std::size_t size() const {
+        return entries_.size();
+    }
+
+    /**
+     * Look up an entry and mark it as most recently used.
+     *
+     * Expired entries are removed and reported as missing.
+     *
+     * @param key The key to look up.
+     * @param now The current time in milliseconds.
+     * @return A pointer to the value, or nullptr if there is no current
+     * entry. The pointer is valid until the cache is next modified.
+     */
+    const Value* find(const Key& key, std::int64_t now) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        if (it->second->expires_at_ <= now) {
+            entries_.erase(it->second);
+            index_.erase(it);
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->value_;
+    }
+
+    /**
+     * Insert or replace an entry, expiring after the time to live.
+     *
+     * @param key The key of the entry.
+     * @param value The value to store.
+     * @param now The current time in milliseconds.
+     */
+    void insert(const Key& key, Value value, std::int64_t now) {
+        insertUntil(key, std::move(value), now + time_to_live_);
+    }
+
+    /**
+     * Insert or replace an entry with an explicit expiry time, e.g. when
+     * restoring a persisted cache.
+     *
+     * @param key The key of the entry.
+     * @param value The value to store.
+     * @param expires_at The time in milliseconds the entry expires at.
+     */
+    void insertUntil(const Key& key, Value value, std::int64_t expires_at) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->value_ = std::move(value);
+            it->second->expires_at_ = expires_at;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (entries_.size() >= capacity_) {
+            index_.erase(entries_.back().key_);
+            entries_.pop_back();
+        }
+        entries_.push_front(Entry{ key, std::move(value), expires_at });
+        index_.emplace(key, entries_.begin());
+    }
+
+    void erase(const Key& key) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            entries_.erase(it->second);
+            index_.erase(it);
+        }
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    /**
+     * Remove all entries that have expired.
+     *
+     * @param now The current time in milliseconds.
+     * @return The number of entries removed.
+     */
+    std::size_t pruneExpired(std::int64_t now) {
+        std::size_t removed = 0;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->expires_at_ <= now) {
+                index_.erase(it->key_);
+                it = entries_.erase(it);
+                ++removed;
+            }
+            else {
+                ++it;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * Visit all entries from least to most recently used, without
+     * affecting their order.
+     *
+     * Re-inserting the entries in the order visited restores the same LRU
+     * order.
+     *
+     * @param visitor Called with the key, value and expiry time of each
+     * entry.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const {
+        for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+            visitor(it->key_, it->value_, it->expires_at_);
+        }
+    }
+
+private:
+    struct Entry {
+        Key key_;
+        Value value_;
+        std::int64_t expires_at_;
+    };
+
+    std::size_t capacity_;
+    std::int64_t time_to_live_;
+    // Most recently used entries first
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index_;
+};
+
+} // namespace PresenceApp
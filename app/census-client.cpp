@@ -0,0 +1,263 @@
+// Copyright 2022 Leonhard S.
+
+#include "census-client.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <exception>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "arx.hpp"
+
+#include "metrics/latency-histogram.hpp"
+#include "utils.hpp"
+
+namespace PresenceApp {
+
+CensusClient::CensusClient(QObject* parent)
+    : QObject{ parent }
+    , queue_{}
+    , in_flight_{ 0 }
+    , base_url_{}
+    , request_count_{ 0 }
+    , retry_count_{ 0 }
+    , failure_count_{ 0 }
+    , latencies_{}
+{
+    manager_.reset(new QNetworkAccessManager(this));
+    manager_->setTransferTimeout(TRANSFER_TIMEOUT);
+}
+
+CensusClient* CensusClient::shared() {
+    static QPointer<CensusClient> instance;
+    if (instance.isNull()) {
+        instance = new CensusClient(QCoreApplication::instance());
+    }
+    return instance.data();
+}
+
+void CensusClient::setBaseUrl(const QUrl& base_url) {
+    base_url_ = base_url;
+}
+
+QUrl CensusClient::getBaseUrl() const {
+    return base_url_;
+}
+
+QUrl CensusClient::getUrl(const arx::Query& query) const {
+    return applyBaseUrl(qUrlFromArxQuery(query));
+}
+
+QUrl CensusClient::getUrl(
+    const arx::QueryTemplate& query_template,
+    std::span<const std::string_view> values
+) const {
+    return applyBaseUrl(qUrlFromArxQuery(query_template, values));
+}
+
+void CensusClient::get(
+    const arx::Query& query,
+    QObject* context,
+    Callback callback
+) {
+    enqueue(getUrl(query), query, context, std::move(callback));
+}
+
+void CensusClient::get(
+    const arx::QueryTemplate& query_template,
+    std::span<const std::string_view> values,
+    QObject* context,
+    Callback callback
+) {
+    enqueue(getUrl(query_template, values), query_template.getQuery(),
+        context, std::move(callback));
+}
+
+qsizetype CensusClient::getInFlightCount() const {
+    return in_flight_;
+}
+
+qsizetype CensusClient::getQueuedCount() const {
+    return queue_.size();
+}
+
+quint64 CensusClient::getRequestCount() const {
+    return request_count_;
+}
+
+quint64 CensusClient::getRetryCount() const {
+    return retry_count_;
+}
+
+quint64 CensusClient::getFailureCount() const {
+    return failure_count_;
+}
+
+const LatencyHistogram& CensusClient::getRequestLatencies() const {
+    return latencies_;
+}
+
+QUrl CensusClient::applyBaseUrl(QUrl url) const {
+    if (base_url_.isValid() && !base_url_.host().isEmpty()) {
+        url.setScheme(base_url_.scheme());
+        url.setHost(base_url_.host());
+        url.setPort(base_url_.port());
+    }
+    return url;
+}
+
+void CensusClient::enqueue(
+    QUrl url,
+    const arx::Query& query,
+    QObject* context,
+    Callback callback
+) {
+    auto request = QSharedPointer<PendingRequest>::create();
+    request->url_ = std::move(url);
+    request->collection_ = QString::fromStdString(query.getCollection());
+    request->retry_ = query.getRetry();
+    request->has_context_ = context != nullptr;
+    request->context_ = context;
+    request->callback_ = std::move(callback);
+    request->attempts_ = 0;
+    request->timer_.start();
+    ++request_count_;
+    queue_.enqueue(request);
+    sendQueued();
+}
+
+void CensusClient::sendQueued() {
+    while (in_flight_ < MAX_IN_FLIGHT && !queue_.isEmpty()) {
+        auto request = queue_.dequeue();
+        // Drop requests nobody is waiting for anymore
+        if (request->has_context_ && request->context_.isNull()) {
+            continue;
+        }
+        send(request);
+    }
+}
+
+void CensusClient::send(const QSharedPointer<PendingRequest>& request) {
+    ++request->attempts_;
+    ++in_flight_;
+    QNetworkRequest network_request(request->url_);
+    network_request.setAttribute(
+        QNetworkRequest::Http2AllowedAttribute, true);
+    auto reply = manager_->get(network_request);
+    QObject::connect(reply, &QNetworkReply::finished, this,
+        [this, request, reply]() { handleReply(request, reply); });
+}
+
+void CensusClient::handleReply(
+    const QSharedPointer<PendingRequest>& request,
+    QNetworkReply* reply
+) {
+    QScopedPointer<QNetworkReply> owned_reply{ reply };
+    --in_flight_;
+    CensusResult result;
+    bool retryable = false;
+    if (owned_reply->error() != QNetworkReply::NoError) {
+        result.status_ = -1;
+        result.error_ = owned_reply->errorString();
+        // Client errors will not go away by asking again
+        auto http_status = owned_reply->attribute(
+            QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        retryable = http_status < 400 || http_status >= 500;
+    }
+    else {
+        try {
+            result.payload_ = getJsonPayload(owned_reply);
+            auto status = arx::validatePayload(
+                request->collection_.toStdString(), result.payload_);
+            if (status == 0) {
+                result.status_ = 0;
+            }
+            else if (status == -1) {
+                // The API reports overload and timeouts in the payload
+                result.status_ = -1;
+                result.error_ = QString::fromStdString(
+                    result.payload_.dump());
+                retryable = true;
+            }
+            else {
+                result.status_ = -2;
+                result.error_ = "Unexpected payload format";
+            }
+        }
+        catch (const std::exception& e) {
+            result.status_ = -2;
+            result.error_ = e.what();
+            retryable = true;
+        }
+    }
+    if (result.status_ != 0 && retryable && request->retry_
+        && request->attempts_ < MAX_ATTEMPTS) {
+        auto delay = RETRY_BASE_DELAY << (request->attempts_ - 1);
+        qDebug() << "Retrying Census request in" << delay << "ms:"
+            << result.error_;
+        ++retry_count_;
+        QTimer::singleShot(delay, this, [this, request]() {
+            queue_.prepend(request);
+            sendQueued();
+        });
+    }
+    else {
+        finish(request, std::move(result));
+    }
+    sendQueued();
+}
+
+void CensusClient::finish(
+    const QSharedPointer<PendingRequest>& request,
+    CensusResult result
+) {
+    result.elapsed_ms_ = request->timer_.elapsed();
+    result.attempts_ = request->attempts_;
+    latencies_.record(result.elapsed_ms_);
+    if (result.status_ != 0) {
+        ++failure_count_;
+        qWarning() << "Census request for" << request->collection_
+            << "failed after" << result.attempts_ << "attempt(s):"
+            << result.error_;
+    }
+    else {
+        qDebug() << "Census request for" << request->collection_
+            << "completed in" << result.elapsed_ms_ << "ms";
+    }
+    if (request->has_context_ && request->context_.isNull()) {
+        return;
+    }
+    request->callback_(result);
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_census-client.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
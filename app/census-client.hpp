@@ -0,0 +1,162 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+
+#include <functional>
+#include <span>
+#include <string_view>
+
+#include "arx.hpp"
+
+#include "metrics/latency-histogram.hpp"
+
+namespace PresenceApp {
+
+/** Outcome of a Census API request. */
+struct CensusResult {
+    /**
+     * 0 on success, -1 if the request failed, -2 if the response was not
+     * a valid payload for the queried collection.
+     */
+    int status_ = -1;
+    arx::json_t payload_;
+    QString error_;
+    /** Time from submission to completion, including retries. */
+    qint64 elapsed_ms_ = 0;
+    int attempts_ = 0;
+};
+
+/**
+ * Shared client for Census API queries.
+ *
+ * All requests go through a single network access manager, so
+ * connections (and HTTP/2 sessions where available) are reused across
+ * lookups. The number of concurrent requests is bounded; excess requests
+ * are queued in submission order. Transient failures are retried with
+ * exponential backoff unless the query disables retries.
+ */
+class CensusClient: public QObject {
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const CensusResult& result)>;
+
+    /** Maximum number of requests in flight at once. */
+    static constexpr int MAX_IN_FLIGHT = 6;
+    /** Maximum number of attempts for retryable requests. */
+    static constexpr int MAX_ATTEMPTS = 3;
+    /** Delay before the first retry; doubled for each further attempt. */
+    static constexpr int RETRY_BASE_DELAY = 500;
+    /** Time after which a stalled request is aborted. */
+    static constexpr int TRANSFER_TIMEOUT = 15000;
+
+    explicit CensusClient(QObject* parent = nullptr);
+    CensusClient(const CensusClient& other) = delete;
+    CensusClient(CensusClient&& other) noexcept = delete;
+
+    CensusClient& operator=(const CensusClient& other) = delete;
+    CensusClient& operator=(CensusClient&& other) noexcept = delete;
+
+    /**
+     * Get the application-wide client.
+     *
+     * The client is created on first use and owned by the application
+     * object, so this must only be called from the main thread.
+     */
+    static CensusClient* shared();
+
+    /**
+     * Send all requests to a different server, e.g. a local stand-in.
+     *
+     * Only the scheme, host and port of the URL are used.
+     */
+    void setBaseUrl(const QUrl& base_url);
+    QUrl getBaseUrl() const;
+
+    /**
+     * Get the URL a query is sent to, taking the base URL into account.
+     */
+    QUrl getUrl(const arx::Query& query) const;
+    QUrl getUrl(const arx::QueryTemplate& query_template,
+        std::span<const std::string_view> values) const;
+
+    /**
+     * Submit a query.
+     *
+     * @param query The query to send.
+     * @param context The callback is skipped if this object is destroyed
+     * before the request completes; may be nullptr.
+     * @param callback Called with the result once the request completes.
+     */
+    void get(const arx::Query& query, QObject* context, Callback callback);
+
+    /**
+     * Submit a templated query.
+     *
+     * @param query_template The query template to send.
+     * @param values The search term values to substitute, see
+     * arx::QueryTemplate::getUrl().
+     * @param context The callback is skipped if this object is destroyed
+     * before the request completes; may be nullptr.
+     * @param callback Called with the result once the request completes.
+     */
+    void get(const arx::QueryTemplate& query_template,
+        std::span<const std::string_view> values,
+        QObject* context, Callback callback);
+
+    qsizetype getInFlightCount() const;
+    qsizetype getQueuedCount() const;
+    quint64 getRequestCount() const;
+    quint64 getRetryCount() const;
+    quint64 getFailureCount() const;
+
+    /**
+     * Get the distribution of request durations in milliseconds,
+     * including queueing and retries.
+     */
+    const LatencyHistogram& getRequestLatencies() const;
+
+private:
+    struct PendingRequest {
+        QUrl url_;
+        QString collection_;
+        bool retry_;
+        bool has_context_;
+        QPointer<QObject> context_;
+        Callback callback_;
+        int attempts_;
+        QElapsedTimer timer_;
+    };
+
+    QUrl applyBaseUrl(QUrl url) const;
+    void enqueue(QUrl url, const arx::Query& query, QObject* context,
+        Callback callback);
+    void sendQueued();
+    void send(const QSharedPointer<PendingRequest>& request);
+    void handleReply(const QSharedPointer<PendingRequest>& request,
+        QNetworkReply* reply);
+    void finish(const QSharedPointer<PendingRequest>& request,
+        CensusResult result);
+
+    QScopedPointer<QNetworkAccessManager> manager_;
+    QQueue<QSharedPointer<PendingRequest>> queue_;
+    qsizetype in_flight_;
+    QUrl base_url_;
+    quint64 request_count_;
+    quint64 retry_count_;
+    quint64 failure_count_;
+    LatencyHistogram latencies_;
+};
+
+} // namespace PresenceApp
@@ -2,6 +2,7 @@
 
 #include "core.hpp"
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QObject>
@@ -9,15 +10,22 @@
 #include <QtCore/QTimer>
 
 #include <algorithm>
-#include <limits>
+#include <cstddef>
+#include <utility>
 
 #include "arx.hpp"
-#include "discord-game-sdk/discord.h"
+#include "arx/ess.hpp"
 
+#include "cache/reference-data.hpp"
 #include "game/character-info.hpp"
 #include "game/state.hpp"
+#include "metrics/pipeline-metrics.hpp"
 #include "presence/handler.hpp"
-#include "tracker.hpp"
+#include "presence/ipc-sink.hpp"
+#include "presence/recording-sink.hpp"
+#include "presence/scheduler.hpp"
+#include "presence/sink.hpp"
+#include "tracker-pool.hpp"
 
 namespace PresenceApp {
 
@@ -26,18 +34,43 @@ RichPresenceApp::RichPresenceApp(QObject* parent)
     , presence_enabled_{ true }
     , event_latency_{ -1 }
 {
+    reference_data_.reset(new ReferenceDataCache(this));
+    QObject::connect(reference_data_.get(),
+        &ReferenceDataCache::recordsResolved,
+        this, &RichPresenceApp::onReferenceDataResolved);
     presence_.reset(new PresenceFactory(this));
-    discord_.reset(new PresenceHandler(this));
+    presence_->setReferenceData(reference_data_.get());
+    auto sink = createPresenceSink(getDefaultPresenceSink());
+    if (!sink) {
+        qWarning() << "Presence sink" << getDefaultPresenceSink()
+            << "unavailable, recording activities instead";
+        sink = createPresenceSink(RecordingSink::NAME);
+    }
+    discord_.reset(new PresenceHandler(std::move(sink), this));
+    scheduler_.reset(new PresenceScheduler(this));
+    QObject::connect(scheduler_.get(), &PresenceScheduler::updateDue,
+        this, &RichPresenceApp::updatePresence);
+    trackers_.reset(new TrackerPool(this));
+    trackers_->setPipelineMetrics(&pipeline_metrics_);
+    QObject::connect(trackers_.get(), &TrackerPool::payloadReceived,
+        this, &RichPresenceApp::onEventPayloadReceived);
+    QObject::connect(trackers_.get(), &TrackerPool::stateChanged,
+        this, &RichPresenceApp::onGameStateChanged);
+    QObject::connect(trackers_.get(), &TrackerPool::replayFinished,
+        this, &RichPresenceApp::onReplayFinished);
+    // Summarise the pipeline periodically and once more on exit
+    QObject::connect(&metrics_timer_, &QTimer::timeout,
+        this, &RichPresenceApp::logPipelineMetrics);
+    QObject::connect(QCoreApplication::instance(),
+        &QCoreApplication::aboutToQuit,
+        this, &RichPresenceApp::logPipelineMetrics);
+    metrics_timer_.start(METRICS_LOG_INTERVAL);
     // Reset timestamps
     last_event_payload_ = QDateTime::fromSecsSinceEpoch(0);
     last_game_state_update_ = QDateTime::fromSecsSinceEpoch(0);
     last_presence_update_ = QDateTime::fromSecsSinceEpoch(0);
-    // Set up rate limiting timer
-    rate_limit_timer_.reset(new QTimer(this));
-    rate_limit_timer_->setSingleShot(true);
-    rate_limit_timer_->start(0);
-    QObject::connect(rate_limit_timer_.get(), &QTimer::timeout,
-        this, &RichPresenceApp::onRateLimitTimerExpired);
+    // Submit the initial idle presence
+    scheduler_->requestUpdate(UpdatePriority::High);
 }
 
 bool RichPresenceApp::getRichPresenceEnabled() const {
@@ -45,11 +78,10 @@ bool RichPresenceApp::getRichPresenceEnabled() const {
 }
 
 void RichPresenceApp::setRichPresenceEnabled(bool enabled) {
-    // If presence was disabled, queue a presence update
-    if (!presence_enabled_) {
-        schedulePresenceUpdate();
+    if (presence_enabled_ != enabled) {
+        presence_enabled_ = enabled;
+        scheduler_->requestUpdate(UpdatePriority::High);
     }
-    presence_enabled_ = enabled;
 }
 
 const CharacterData& RichPresenceApp::getCharacter() const {
@@ -58,22 +90,18 @@ const CharacterData& RichPresenceApp::getCharacter() const {
 
 void RichPresenceApp::setCharacter(const CharacterData& character) {
     if (character_ != character) {
+        trackers_->removeCharacter(character_.id_);
         character_ = character;
-        if (character.id_ != 0) {
-            tracker_.reset(new ActivityTracker(character, this));
-            QObject::connect(tracker_.get(), &ActivityTracker::payloadReceived,
-                this, &RichPresenceApp::onEventPayloadReceived);
-            QObject::connect(tracker_.get(), &ActivityTracker::stateChanged,
-                this, &RichPresenceApp::onGameStateChanged);
-        }
-        else {
-            tracker_.reset();
-        }
+        trackers_->addCharacter(character);
+        trackers_->setDisplayedCharacter(character.id_);
         // Reset timestamps and payload cache
         last_event_payload_ = QDateTime::fromSecsSinceEpoch(0);
         last_game_state_update_ = QDateTime::fromSecsSinceEpoch(0);
         event_latency_ = -1;
-        recent_events_.clear();
+        event_rate_.reset();
+        event_latencies_.reset();
+        logPipelineMetrics();
+        pipeline_metrics_.reset();
         emit eventPayloadReceived();
         emit gameStateChanged();
         emit characterChanged(character_);
@@ -96,99 +124,158 @@ qint32 RichPresenceApp::getEventLatency() const {
     return event_latency_;
 }
 
-double RichPresenceApp::getEventFrequency() {
-    pruneRecentEvents();
-    if (recent_events_.empty()) {
-        return 0.0;
+qint64 RichPresenceApp::getEventLatencyPercentile(double percentile) const {
+    return event_latencies_.getPercentile(percentile);
+}
+
+double RichPresenceApp::getEventFrequency(RateWindow window) {
+    return event_rate_.getRate(
+        window, QDateTime::currentMSecsSinceEpoch());
+}
+
+const PipelineMetrics& RichPresenceApp::getPipelineMetrics() const {
+    return pipeline_metrics_;
+}
+
+void RichPresenceApp::startRecording(const QString& path) {
+    trackers_->startRecording(path);
+}
+
+void RichPresenceApp::setEndpointBaseUrl(const QString& base_url) {
+    trackers_->setEndpointBaseUrl(base_url);
+}
+
+void RichPresenceApp::setConnectionDeadlines(int heartbeat, int connect) {
+    trackers_->setConnectionDeadlines(heartbeat, connect);
+}
+
+void RichPresenceApp::setReconnectBackoff(int base, int max) {
+    trackers_->setReconnectBackoff(base, max);
+}
+
+int RichPresenceApp::startReplay(const QString& path, double speed) {
+    auto status = trackers_->startReplay(path, speed);
+    if (status != 0) {
+        qWarning() << "Unable to replay frame log" << path
+            << "(status" << status << ")";
+        return -1;
     }
-    auto oldest_event = recent_events_.front();
-    auto now = QDateTime::currentDateTimeUtc();
-    double timespan = static_cast<double>(oldest_event.secsTo(now));
-    auto freq = static_cast<double>(recent_events_.size()) / timespan;
-    return freq;
+    qDebug() << "Replaying" << path << "at speed" << speed;
+    return 0;
 }
 
 void RichPresenceApp::onEventPayloadReceived(
-    const QString& event_name,
-    const arx::json_t& payload
+    const arx::EventPayload& payload
 ) {
     // The app only cares about if there are messages coming in. Handling
     // the payloads and dealing with error states is the tracker's problem.
-    Q_UNUSED(event_name)
 
     // Get timestamp of the event
-    auto it = payload.find("timestamp");
-    if (it == payload.end()) {
-        qWarning() << "No timestamp found for" << event_name << "payload";
+    if (payload.timestamp == 0) {
+        qWarning() << "No timestamp found for"
+            << QString::fromStdString(arx::eventToEventName(payload.event))
+            << "payload";
         return;
     }
-    auto timestamp = QString::fromStdString(
-        it.value().get<arx::json_string_t>());
     auto event_time = QDateTime::fromSecsSinceEpoch(
-        timestamp.toLong(), Qt::TimeSpec::UTC);
+        payload.timestamp, Qt::TimeSpec::UTC);
     auto now = QDateTime::currentDateTimeUtc();
     event_latency_ = static_cast<qint32>(event_time.msecsTo(now));
-    // Update recent events list; used for event frequency calculation
+    event_latencies_.record(event_latency_);
+    // Update event rate; used for event frequency calculation
     last_event_payload_ = now;
-    updateRecentEventsList();
+    event_rate_.record(now.toMSecsSinceEpoch());
     emit eventPayloadReceived();
 }
 
 void RichPresenceApp::onGameStateChanged(const GameState& state) {
+    if (state.character_id_ != character_.id_) {
+        return;
+    }
     // Update the presence factory with the new game state
     presence_->setActivityFromGameState(state);
+    discord_->wake();
     emit gameStateChanged();
-    schedulePresenceUpdate();
+    scheduler_->requestUpdate(state);
 }
 
-void RichPresenceApp::onRateLimitTimerExpired() {
-    updatePresence();
+void RichPresenceApp::onReferenceDataResolved(ReferenceKind kind) {
+    // Names shown may have been placeholders until now
+    qDebug() << "Resolved" << referenceKindCollection(kind)
+        << "reference data";
+    presence_->invalidateActivities();
+    scheduler_->requestUpdate(UpdatePriority::Low);
 }
 
-void RichPresenceApp::pruneRecentEvents() {
-    // Remove events older than 30 seconds from the list
-    QList<QDateTime> still_fresh;
-    auto now = QDateTime::currentDateTimeUtc();
-    std::copy_if(recent_events_.begin(), recent_events_.end(),
-        std::back_inserter(still_fresh),
-        [now](const QDateTime& event_time) {
-            return event_time.msecsTo(now) <= 30000;
-        });
+void RichPresenceApp::logPipelineMetrics() const {
+    for (std::size_t i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        auto stage = static_cast<PipelineStage>(i);
+        auto summary = pipeline_metrics_.getSummary(stage);
+        if (summary.count_ == 0) {
+            continue;
+        }
+        qInfo() << "Pipeline stage" << pipelineStageName(stage)
+            << "n =" << summary.count_
+            << "p50 =" << summary.p50_ << "us"
+            << "p99 =" << summary.p99_ << "us"
+            << "p999 =" << summary.p999_ << "us"
+            << "max =" << summary.max_ << "us";
+    }
+    qInfo() << "Presence callback pump:" << discord_->getWakeupCount()
+        << "wakeups," << discord_->getWakeupRate(RateWindow::FiveMinutes)
+        << "per second over 5 min, interval"
+        << discord_->getPumpInterval() << "ms";
+    // Only the recording sink sees every request; Discord rate limits
+    // them on its end
+    auto* recording = dynamic_cast<RecordingSink*>(discord_->getSink());
+    if (recording != nullptr) {
+        qInfo() << "Recorded" << recording->getUpdateCount()
+            << "activity updates and" << recording->getClearCount()
+            << "clears," << recording->getRequestRate(RateWindow::FiveMinutes)
+            << "per second over 5 min";
+    }
+    qInfo() << "Presence scheduler:" << scheduler_->getRequestCount()
+        << "requests," << scheduler_->getSubmittedCount() << "submitted,"
+        << scheduler_->getCoalescedCount() << "coalesced,"
+        << scheduler_->getDroppedCount() << "dropped,"
+        << scheduler_->getThrottledCount() << "throttled";
+    auto* ipc = dynamic_cast<IpcSink*>(discord_->getSink());
+    if (ipc != nullptr) {
+        qInfo() << "Discord IPC:" << ipc->getCoalescedCount()
+            << "activity updates coalesced";
+    }
 }
 
-void RichPresenceApp::schedulePresenceUpdate() {
-    auto rate_limit = PresenceHandler::PRESENCE_UPDATE_RATE_LIMIT;
-    // If it has been longer than the rate limit since the last presence
-    // update, update the presence immediately
-    auto now = QDateTime::currentDateTimeUtc();
-    if (last_presence_update_.msecsTo(now) > rate_limit) {
-        qDebug() << "Scheduling immediate presence update";
-        updatePresence();
-        return;
-    }
-    // We are not allowed to update the presence again yet. If there is no
-    // timer running yet, start one counting down to the next update slot.
-    // Any game state changes will still be passed on to the factory in the
-    // meanwhile, so the next update will be the most up-to-date one.
-    if (rate_limit_timer_->isActive()) {
-        qDebug() << "Presence update timer is already running";
-        return;
+void RichPresenceApp::onReplayFinished(
+    qint64 frames,
+    qint64 elapsed_ms,
+    quint64 dropped
+) {
+    auto seconds = static_cast<double>(std::max(elapsed_ms, qint64{ 1 }))
+        / 1000.0;
+    qDebug() << "Replayed" << frames << "frames in" << elapsed_ms << "ms ("
+        << static_cast<double>(frames) / seconds << "frames/s),"
+        << dropped << "events dropped";
+    if (dropped > 0) {
+        qWarning() << "Replay dropped" << dropped
+            << "events; its timings depend on the machine, not the log";
     }
-    // Calculate the number of seconds until we ar eallowed to update the
-    // presence again.
-    auto ms_until_next_update = static_cast<int>(std::clamp(
-        rate_limit - last_presence_update_.msecsTo(now),
-        0LL, static_cast<long long>(INT_MAX)));
-    qDebug() << "Scheduling presence update in" << ms_until_next_update << "ms";
-    // (Re)start the timer. Presence will be updated when the timer fires.
-    rate_limit_timer_->start(ms_until_next_update);
+    logPipelineMetrics();
 }
 
 void RichPresenceApp::updatePresence() {
     last_presence_update_ = QDateTime::currentDateTimeUtc();
     if (presence_enabled_) {
+        auto started = PipelineClock::now();
         auto activity = presence_->getPresenceAsActivity();
-        discord_->setActivity(activity);
+        auto built = PipelineClock::now();
+        auto submitted = discord_->setActivity(activity);
+        pipeline_metrics_.recordPresence(
+            started, built, PipelineClock::now(), submitted);
+        // Unchanged activities must not use up the rate limit budget
+        if (!submitted) {
+            scheduler_->cancelSubmission();
+        }
     }
     if (!presence_enabled_) {
         discord_->clearActivity();
@@ -196,16 +283,6 @@ void RichPresenceApp::updatePresence() {
     emit presenceUpdated();
 }
 
-void RichPresenceApp::updateRecentEventsList() {
-    auto now = QDateTime::currentDateTimeUtc();
-    // Only keep the 100 most recent events
-    while (recent_events_.size() > 100) {
-        recent_events_.pop_front();
-    }
-    // Add the new event to the list
-    recent_events_.push_back(now);
-}
-
 } // namespace PresenceApp
 
 #if defined(_MSC_VER) && !defined(__clang__)
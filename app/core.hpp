@@ -3,18 +3,23 @@
 #pragma once
 
 #include <QtCore/QDateTime>
-#include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
 
 #include "arx.hpp"
+#include "arx/ess.hpp"
 
+#include "cache/reference-data.hpp"
 #include "game/character-info.hpp"
+#include "metrics/latency-histogram.hpp"
+#include "metrics/pipeline-metrics.hpp"
+#include "metrics/rate-meter.hpp"
 #include "presence/factory.hpp"
 #include "presence/handler.hpp"
-#include "tracker.hpp"
+#include "presence/scheduler.hpp"
+#include "tracker-pool.hpp"
 
 namespace PresenceApp {
 
@@ -22,6 +27,11 @@ class RichPresenceApp: public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * Interval in milliseconds between pipeline metrics summaries.
+     */
+    static constexpr int METRICS_LOG_INTERVAL = 300000;
+
     explicit RichPresenceApp(QObject* parent = nullptr);
     RichPresenceApp(const RichPresenceApp&) = delete;
     RichPresenceApp(RichPresenceApp&&) = delete;
@@ -38,7 +48,53 @@ public:
     QDateTime getLastGameStateUpdate() const;
     QDateTime getLastPresenceUpdate() const;
     qint32 getEventLatency() const;
-    double getEventFrequency();
+
+    /**
+     * Estimate a percentile of the event latency since the current
+     * character was selected.
+     *
+     * @param percentile The percentile to compute, between 0 and 100.
+     * @return The latency in milliseconds, or -1 if no events were received.
+     */
+    qint64 getEventLatencyPercentile(double percentile) const;
+    double getEventFrequency(
+        RateWindow window = RateWindow::ThirtySeconds);
+
+    /**
+     * Get the per-stage timings of the event-to-presence pipeline since
+     * the current character was selected.
+     */
+    const PipelineMetrics& getPipelineMetrics() const;
+
+    /**
+     * Record all ESS frames received to the given frame log.
+     */
+    void startRecording(const QString& path);
+
+    /**
+     * Connect to a different ESS endpoint, e.g. a local load generator.
+     */
+    void setEndpointBaseUrl(const QString& base_url);
+
+    /**
+     * Configure when the ESS connection is considered dead.
+     */
+    void setConnectionDeadlines(int heartbeat, int connect);
+
+    /**
+     * Configure the delays between ESS reconnect attempts.
+     */
+    void setReconnectBackoff(int base, int max);
+
+    /**
+     * Replay a recorded frame log instead of the live ESS connection.
+     *
+     * @param path The path of the frame log to replay.
+     * @param speed The playback speed relative to the recording; zero
+     * replays as fast as possible.
+     * @return 0 on success, -1 if the replay could not be started.
+     */
+    int startReplay(const QString& path, double speed);
 
 Q_SIGNALS:
     void characterChanged(const CharacterData& character);
@@ -47,30 +103,32 @@ Q_SIGNALS:
     void presenceUpdated();
 
 private Q_SLOTS:
-    void onEventPayloadReceived(
-        const QString& event_name,
-        const arx::json_t& payload);
+    void onEventPayloadReceived(const arx::EventPayload& payload);
     void onGameStateChanged(const GameState& state);
-    void onRateLimitTimerExpired();
+    void onReferenceDataResolved(ReferenceKind kind);
+    void onReplayFinished(qint64 frames, qint64 elapsed_ms,
+        quint64 dropped);
 
 private:
-    void pruneRecentEvents();
-    void schedulePresenceUpdate();
+    void logPipelineMetrics() const;
     void updatePresence();
-    void updateRecentEventsList();
 
-    QScopedPointer<QTimer> rate_limit_timer_;
     CharacterData character_;
     bool presence_enabled_;
+    QScopedPointer<ReferenceDataCache> reference_data_;
     QScopedPointer<PresenceFactory> presence_;
     QScopedPointer<PresenceHandler> discord_;
+    QScopedPointer<PresenceScheduler> scheduler_;
     qint32 event_latency_;
-    QScopedPointer<ActivityTracker> tracker_;
+    QScopedPointer<TrackerPool> trackers_;
 
     QDateTime last_event_payload_;
     QDateTime last_game_state_update_;
     QDateTime last_presence_update_;
-    QList<QDateTime> recent_events_;
+    RateMeter event_rate_;
+    LatencyHistogram event_latencies_;
+    PipelineMetrics pipeline_metrics_;
+    QTimer metrics_timer_;
 };
 
 } // namespace PresenceApp
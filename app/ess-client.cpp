@@ -2,43 +2,93 @@
 
 #include "ess-client.hpp"
 
+#include <QtCore/QByteArray>
 #include <QtCore/QDebug>
 #include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QMetaMethod>
 #include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
 #include <QtCore/QUrl>
+#include <QtNetwork/QAbstractSocket>
 #include <QtWebSockets/QWebSocket>
 
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
 #include "arx.hpp"
 #include "arx/ess.hpp"
 
+#include "event-queue.hpp"
+#include "metrics/pipeline-metrics.hpp"
+
 namespace PresenceApp {
 
 EssClient::EssClient(const QString& service_id, QObject* parent)
     : QObject{ parent }
     , service_id_{ service_id }
+    , endpoint_base_url_{ arx::DEFAULT_ENDPOINT_BASE_URL }
+    , event_queue_{ nullptr }
     , subscriptions_{}
+    // Members are parented so they follow the client to its thread
+    , subscription_timer_{ this }
+    , ws_{ QString(), QWebSocketProtocol::VersionLatest, this }
+    , recorder_{}
+    , recording_started_{}
 {
+    subscription_timer_.setSingleShot(true);
+    QObject::connect(&subscription_timer_, &QTimer::timeout,
+        this, &EssClient::flushSubscriptions);
     QObject::connect(&ws_, &QWebSocket::connected,
         this, &EssClient::onConnected);
     QObject::connect(&ws_, &QWebSocket::disconnected,
         this, &EssClient::onDisconnected);
+    // Failed connection attempts only report an error, not a disconnect
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    QObject::connect(&ws_, &QWebSocket::errorOccurred,
+        this, &EssClient::onErrorOccurred);
+#else
+    QObject::connect(&ws_,
+        QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error),
+        this, &EssClient::onErrorOccurred);
+#endif
+    QObject::connect(&ws_, &QWebSocket::binaryMessageReceived,
+        this, &EssClient::onBinaryMessageReceived);
     QObject::connect(&ws_, &QWebSocket::textMessageReceived,
-        this, &EssClient::parseMessage);
+        this, &EssClient::onTextMessageReceived);
 }
 
 bool EssClient::isConnected() const {
     return ws_.isValid() && ws_.state() == QAbstractSocket::SocketState::ConnectedState;
 }
 
-const QList<arx::Subscription>& EssClient::getSubscriptions() const {
-    return subscriptions_;
+void EssClient::setEventQueue(EventQueue* queue) {
+    event_queue_ = queue;
+}
+
+QList<arx::Subscription> EssClient::getSubscriptions() const {
+    if (subscriptions_.isEmpty()) {
+        return {};
+    }
+    return { subscriptions_.toSubscription() };
+}
+
+QString EssClient::getEndpointBaseUrl() const {
+    return endpoint_base_url_;
+}
+
+void EssClient::setEndpointBaseUrl(const QString& base_url) {
+    endpoint_base_url_ = base_url;
 }
 
 void EssClient::connect() {
     const QUrl url = QUrl(QString::fromStdString(
-        arx::getEndpointUrl(service_id_.toStdString())));
+        arx::getEndpointUrl(service_id_.toStdString(),
+            arx::Environment::PS2, endpoint_base_url_.toStdString())));
     ws_.open(url);
     qDebug() << "Connecting to" << url.toString();
 }
@@ -48,26 +98,35 @@ void EssClient::disconnect() {
 }
 
 void EssClient::subscribe(const arx::Subscription subscription) {
-    if (!subscriptions_.contains(subscription)) {
-        subscriptions_.append(subscription);
-        emit subscriptionAdded(subscription);
-    }
-    if (isConnected()) {
-        auto msg = QString::fromStdString(
-            subscription.buildSubscribeMessage());
-        qDebug() << "Sending: " << msg;
-        ws_.sendTextMessage(msg);
-    }
+    subscriptions_.add(subscription);
+    emit subscriptionAdded(subscription);
+    scheduleSubscriptionFlush(SUBSCRIPTION_BATCH_INTERVAL);
 }
 
 void EssClient::unsubscribe(const arx::Subscription subscription) {
-    if (subscriptions_.removeAll(subscription)) {
-        emit subscriptionRemoved(subscription);
-    }
-    if (isConnected()) {
-        ws_.sendTextMessage(QString::fromStdString(
-            subscription.buildUnsubscribeMessage()));
+    subscriptions_.remove(subscription);
+    emit subscriptionRemoved(subscription);
+    scheduleSubscriptionFlush(SUBSCRIPTION_BATCH_INTERVAL);
+}
+
+void EssClient::injectMessage(const QByteArray& message) {
+    parseMessage(message, PipelineClock::now());
+}
+
+void EssClient::startRecording(const QString& path) {
+    stopRecording();
+    recorder_.reset(new arx::FrameLogWriter());
+    if (recorder_->open(path.toStdString()) != 0) {
+        qWarning() << "Unable to create frame log" << path;
+        recorder_.reset();
+        return;
     }
+    recording_started_ = PipelineClock::now();
+    qDebug() << "Recording ESS frames to" << path;
+}
+
+void EssClient::stopRecording() {
+    recorder_.reset();
 }
 
 void EssClient::reconnect() {
@@ -76,42 +135,149 @@ void EssClient::reconnect() {
 }
 
 void EssClient::onConnected() {
-    auto timer = new QTimer(this);
-    timer->setInterval(1000);
-    timer->setSingleShot(true);
-    QObject::connect(timer, &QTimer::timeout, [timer, this]() {
-        qDebug() << "Timer expired, subscribing";
-        timer->deleteLater();
-        std::for_each(subscriptions_.begin(), subscriptions_.end(),
-            [this](const auto& subscription) {
-                subscribe(subscription);
-            });
-        });
-    timer->start();
+    // Give the server a moment before sending the entire subscription set
+    subscription_timer_.stop();
+    scheduleSubscriptionFlush(SUBSCRIPTION_CONNECT_DELAY);
     emit connected();
 }
 
 void EssClient::onDisconnected() {
+    // The server forgets all subscriptions when the connection is closed
+    subscriptions_.invalidate();
     emit disconnected();
 }
 
-void EssClient::parseMessage(const QString& message) {
+void EssClient::onErrorOccurred(QAbstractSocket::SocketError error) {
+    qWarning() << "ESS socket error" << error << ws_.errorString();
+    emit errorOccurred(ws_.errorString());
+}
+
+void EssClient::onBinaryMessageReceived(const QByteArray& message) {
+    auto received = PipelineClock::now();
+    recordMessage(message, received);
+    parseMessage(message, received);
+}
+
+void EssClient::onTextMessageReceived(const QString& message) {
+    auto received = PipelineClock::now();
+    auto utf8 = message.toUtf8();
+    recordMessage(utf8, received);
     emit messageReceived(message);
-    // Convert the text message to a JSON object
-    auto json = arx::json_t::parse(message.toStdString());
+    parseMessage(utf8, received);
+}
+
+void EssClient::parseMessage(
+    const QByteArray& message,
+    PipelineClock::time_point received
+) {
+    // Decode the UTF-8 frame buffer directly into a typed payload; no JSON
+    // document is built for this.
+    arx::MessageType type;
+    arx::EventPayload payload;
+    auto status = arx::decodeMessage(
+        std::string_view(message.constData(),
+            static_cast<std::size_t>(message.size())),
+        &type, &payload);
+    if (status == -1) {
+        qWarning() << "Ignoring malformed message:" << message;
+        return;
+    }
+    if (type == arx::MessageType::HEARTBEAT) {
+        // Heartbeats are rare enough to afford a full parse for the
+        // endpoint states the typed decoder skips
+        QMap<QString, bool> endpoints;
+        std::vector<arx::EndpointStatus> statuses;
+        const auto json = arx::json_t::parse(
+            message.constData(), message.constData() + message.size(),
+            nullptr, false);
+        if (arx::getEndpointStatuses(json, &statuses) == 0) {
+            for (const auto& status : statuses) {
+                endpoints.insert(QString::fromStdString(status.name),
+                    status.online);
+            }
+        }
+        emit heartbeatReceived(endpoints);
+        return;
+    }
     // Ignore anything but event subscription messages
-    if (arx::getMessageType(json) != arx::MessageType::SERVICE_MESSAGE) {
+    if (type != arx::MessageType::SERVICE_MESSAGE) {
         return;
     }
-    auto payload = arx::getPayload(json);
-    if (payload.empty()) {
+    if (status != 0) {
         qWarning() << "Ignoring bad service message:" << message;
         return;
     }
-    // Dispatch payload
-    auto event_name = QString::fromStdString(
-        payload["event_name"].get<arx::json_string_t>());
-    emit payloadReceived(event_name, payload);
+    if (event_queue_ != nullptr) {
+        QueuedEvent event{ payload, { received, PipelineClock::now() } };
+        if (!event_queue_->push(event)) {
+            qWarning() << "Event queue full, dropping"
+                << QString::fromStdString(
+                    arx::eventToEventName(payload.event))
+                << "payload";
+        }
+    }
+    else {
+        emit eventReceived(payload);
+    }
+    // The raw JSON payload is only parsed if anyone is listening for it
+    if (isSignalConnected(QMetaMethod::fromSignal(
+        &EssClient::payloadReceived))) {
+        dispatchPayload(message);
+    }
+}
+
+void EssClient::recordMessage(
+    const QByteArray& message,
+    PipelineClock::time_point received
+) {
+    if (!recorder_) {
+        return;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        received - recording_started_);
+    auto status = recorder_->append(elapsed.count(),
+        std::string_view(message.constData(),
+            static_cast<std::size_t>(message.size())));
+    if (status != 0) {
+        qWarning() << "Unable to write frame log, recording stopped";
+        recorder_.reset();
+    }
+}
+
+void EssClient::dispatchPayload(const QByteArray& message) {
+    // Parse the frame buffer in place; the payload is only ever handed out
+    // as a view into this document, never as a copy.
+    const auto json = arx::json_t::parse(
+        message.constData(), message.constData() + message.size(),
+        nullptr, false);
+    const auto payload = arx::findPayload(json);
+    if (payload == nullptr) {
+        return;
+    }
+    const auto& event_name = payload->find("event_name")
+        ->get_ref<const arx::json_string_t&>();
+    emit payloadReceived(
+        QString::fromUtf8(event_name.data(),
+            static_cast<qsizetype>(event_name.size())),
+        *payload);
+}
+
+void EssClient::flushSubscriptions() {
+    if (!isConnected()) {
+        return;
+    }
+    for (const auto& message : subscriptions_.takePendingMessages()) {
+        auto msg = QString::fromStdString(message);
+        qDebug() << "Sending: " << msg;
+        ws_.sendTextMessage(msg);
+    }
+}
+
+void EssClient::scheduleSubscriptionFlush(int delay) {
+    // Do not cut short a pending flush, e.g. the one following a connect
+    if (!subscription_timer_.isActive()) {
+        subscription_timer_.start(delay);
+    }
 }
 
 } // namespace PresenceApp
@@ -2,23 +2,56 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QList>
+#include <QtCore/QMap>
 #include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
 #include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtNetwork/QAbstractSocket>
 #include <QtWebSockets/QWebSocket>
 
 #include "arx.hpp"
 #include "arx/ess.hpp"
 
+#include "event-queue.hpp"
+#include "metrics/pipeline-metrics.hpp"
+
 namespace PresenceApp {
 
 /**
  * WebSocket client for the PS2 event streaming service.
+ *
+ * Subscriptions are merged into a single arx::SubscriptionSet. Changes are
+ * batched for SUBSCRIPTION_BATCH_INTERVAL milliseconds and then sent as the
+ * minimal set of subscribe and clearSubscribe messages.
+ *
+ * The client may be moved to a dedicated network thread. In that case,
+ * all slots must be invoked through queued connections and decoded events
+ * should be consumed via an EventQueue rather than the eventReceived()
+ * signal.
+ *
+ * Incoming frames can be recorded to an arx frame log, and recorded
+ * frames fed back in through injectMessage() to replay a session without
+ * a network connection.
  */
 class EssClient: public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * Time in milliseconds to collect subscription changes before they are
+     * sent to the server.
+     */
+    static constexpr int SUBSCRIPTION_BATCH_INTERVAL = 50;
+
+    /**
+     * Time in milliseconds to wait after connecting before subscriptions
+     * are sent to the server.
+     */
+    static constexpr int SUBSCRIPTION_CONNECT_DELAY = 1000;
+
     explicit EssClient(const QString& service_id,
         QObject* parent = nullptr);
     EssClient(const EssClient& other) = delete;
@@ -28,13 +61,36 @@ public:
     EssClient& operator=(EssClient&& other) noexcept = delete;
 
     bool isConnected() const;
-    const QList<arx::Subscription>& getSubscriptions() const;
+    QList<arx::Subscription> getSubscriptions() const;
+    QString getEndpointBaseUrl() const;
+
+    /**
+     * Deliver decoded events through the given queue instead of the
+     * eventReceived() signal.
+     *
+     * The queue must outlive the client. This must be called before the
+     * client is moved to another thread.
+     *
+     * @param queue The queue to push events into, or nullptr to revert
+     * to the eventReceived() signal.
+     */
+    void setEventQueue(EventQueue* queue);
 
 Q_SIGNALS:
     void connected();
     void disconnected();
+    void errorOccurred(const QString& error);
+    /**
+     * A heartbeat arrived.
+     *
+     * @param endpoints Whether each event server endpoint listed in the
+     * heartbeat is online, by endpoint name.
+     */
+    void heartbeatReceived(const QMap<QString, bool>& endpoints);
     void messageReceived(QString message);
-    void payloadReceived(QString event_name, arx::json_t payload);
+    void eventReceived(const arx::EventPayload& payload);
+    void payloadReceived(const QString& event_name,
+        const arx::json_t& payload);
     void subscriptionAdded(const arx::Subscription subscription);
     void subscriptionRemoved(const arx::Subscription subscription);
     void subscriptionsCleared();
@@ -46,15 +102,57 @@ public Q_SLOTS:
     void subscribe(const arx::Subscription subscription);
     void unsubscribe(const arx::Subscription subscription);
 
+    /**
+     * Handle a frame as if it had been received from the server.
+     *
+     * @param message The raw frame contents.
+     */
+    void injectMessage(const QByteArray& message);
+
+    /**
+     * Write every frame received from the server to a frame log.
+     *
+     * Timestamps are relative to the start of the recording. Any previous
+     * recording is stopped.
+     *
+     * @param path The path of the frame log to create.
+     */
+    void startRecording(const QString& path);
+    void stopRecording();
+
+    /**
+     * Connect to a different ESS endpoint, e.g. a local load generator.
+     *
+     * Takes effect on the next connection attempt.
+     *
+     * @param base_url The base URL of the endpoint, without query.
+     */
+    void setEndpointBaseUrl(const QString& base_url);
+
 private Q_SLOTS:
     void onConnected();
     void onDisconnected();
-    void parseMessage(const QString& message);
+    void onErrorOccurred(QAbstractSocket::SocketError error);
+    void onBinaryMessageReceived(const QByteArray& message);
+    void onTextMessageReceived(const QString& message);
+    void flushSubscriptions();
 
 private:
+    void parseMessage(const QByteArray& message,
+        PipelineClock::time_point received);
+    void recordMessage(const QByteArray& message,
+        PipelineClock::time_point received);
+    void dispatchPayload(const QByteArray& message);
+    void scheduleSubscriptionFlush(int delay);
+
     QString service_id_;
-    QList<arx::Subscription> subscriptions_;
+    QString endpoint_base_url_;
+    EventQueue* event_queue_;
+    arx::SubscriptionSet subscriptions_;
+    QTimer subscription_timer_;
     QWebSocket ws_;
+    QScopedPointer<arx::FrameLogWriter> recorder_;
+    PipelineClock::time_point recording_started_;
 };
 
 } // namespace PresenceApp
@@ -0,0 +1,154 @@
+// Copyright 2022 Leonhard S.
+
+#include "ess-replay.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <chrono>
+#include <cstdint>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "event-queue.hpp"
+#include "metrics/pipeline-metrics.hpp"
+
+namespace PresenceApp {
+
+EssReplay::EssReplay(QObject* parent)
+    : QObject{ parent }
+    , reader_{}
+    , queue_{ nullptr }
+    , pending_frame_{}
+    , has_pending_frame_{ false }
+    , speed_{ 1.0 }
+    , first_timestamp_ns_{ 0 }
+    , started_{}
+    , frames_{ 0 }
+    // Parented so it follows the replay to its thread
+    , timer_{ this }
+{
+    timer_.setSingleShot(true);
+    timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&timer_, &QTimer::timeout,
+        this, &EssReplay::onTimerExpired);
+}
+
+int EssReplay::open(const QString& path) {
+    has_pending_frame_ = false;
+    return reader_.open(path.toStdString());
+}
+
+double EssReplay::getSpeed() const {
+    return speed_;
+}
+
+void EssReplay::setSpeed(double speed) {
+    speed_ = speed;
+}
+
+void EssReplay::setEventQueue(const EventQueue* queue) {
+    queue_ = queue;
+}
+
+void EssReplay::start() {
+    started_ = PipelineClock::now();
+    frames_ = 0;
+    if (!reader_.isOpen() || !readNextFrame()) {
+        finish();
+        return;
+    }
+    first_timestamp_ns_ = pending_frame_.timestamp_ns;
+    timer_.start(0);
+}
+
+void EssReplay::stop() {
+    timer_.stop();
+    reader_.close();
+    has_pending_frame_ = false;
+}
+
+void EssReplay::onTimerExpired() {
+    if (speed_ <= 0.0) {
+        // As fast as possible, yielding after every batch
+        for (int i = 0; i < MAX_FRAMES_PER_BATCH && has_pending_frame_
+            && hasQueueRoom(); ++i) {
+            emit messageReady(QByteArray::fromStdString(pending_frame_.data));
+            ++frames_;
+            readNextFrame();
+        }
+        if (has_pending_frame_) {
+            timer_.start(hasQueueRoom() ? 0 : QUEUE_FULL_DELAY);
+        }
+        else {
+            finish();
+        }
+        return;
+    }
+    // Emit every frame that is due, then sleep until the next one
+    while (has_pending_frame_) {
+        auto offset = std::chrono::nanoseconds(static_cast<std::int64_t>(
+            static_cast<double>(
+                pending_frame_.timestamp_ns - first_timestamp_ns_) / speed_));
+        auto due = started_ + offset;
+        auto now = PipelineClock::now();
+        if (due > now) {
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                due - now);
+            timer_.start(static_cast<int>(wait.count()));
+            return;
+        }
+        if (!hasQueueRoom()) {
+            timer_.start(QUEUE_FULL_DELAY);
+            return;
+        }
+        emit messageReady(QByteArray::fromStdString(pending_frame_.data));
+        ++frames_;
+        readNextFrame();
+    }
+    finish();
+}
+
+bool EssReplay::readNextFrame() {
+    auto status = reader_.next(&pending_frame_);
+    if (status == -1) {
+        qWarning() << "Frame log is corrupt, stopping replay after"
+            << frames_ << "frames";
+    }
+    has_pending_frame_ = status == 0;
+    return has_pending_frame_;
+}
+
+bool EssReplay::hasQueueRoom() const {
+    // Each frame decodes into at most one event
+    return queue_ == nullptr || queue_->size() < EventQueue::CAPACITY;
+}
+
+void EssReplay::finish() {
+    reader_.close();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        PipelineClock::now() - started_);
+    emit finished(frames_, static_cast<qint64>(elapsed.count()));
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_ess-replay.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
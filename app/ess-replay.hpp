@@ -0,0 +1,106 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <cstdint>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "event-queue.hpp"
+#include "metrics/pipeline-metrics.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Plays back an arx frame log recorded by EssClient.
+ *
+ * Frames are emitted through messageReady(), which is meant to be
+ * connected to EssClient::injectMessage(). Playback can follow the
+ * recorded timing, scaled by a speed factor, or run as fast as possible.
+ * In the latter case, frames are emitted in batches of at most
+ * MAX_FRAMES_PER_BATCH per event loop iteration.
+ *
+ * If an event queue is set, playback waits while it is full rather than
+ * letting the client drop events, so fast replays process the whole log.
+ */
+class EssReplay: public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_FRAMES_PER_BATCH = 256;
+    /** Time in milliseconds to wait for the event queue to drain. */
+    static constexpr int QUEUE_FULL_DELAY = 1;
+
+    explicit EssReplay(QObject* parent = nullptr);
+    EssReplay(const EssReplay& other) = delete;
+    EssReplay(EssReplay&& other) noexcept = delete;
+
+    EssReplay& operator=(const EssReplay& other) = delete;
+    EssReplay& operator=(EssReplay&& other) noexcept = delete;
+
+    /**
+     * Open the frame log to play back.
+     *
+     * @param path The path of the frame log.
+     * @return 0 on success, -1 if the file could not be opened, and -2 if
+     * it is not a valid frame log.
+     */
+    int open(const QString& path);
+
+    double getSpeed() const;
+
+    /**
+     * Set the playback speed relative to the recording.
+     *
+     * @param speed The speed factor, e.g. 2.0 for twice the recorded
+     * speed. A factor of zero or less replays as fast as possible.
+     */
+    void setSpeed(double speed);
+
+    /**
+     * Hold back frames while the given queue has no room for their events.
+     *
+     * @param queue The queue the replayed events end up in; must outlive
+     * the replay.
+     */
+    void setEventQueue(const EventQueue* queue);
+
+Q_SIGNALS:
+    void messageReady(const QByteArray& message);
+    void finished(qint64 frames, qint64 elapsed_ms);
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void onTimerExpired();
+
+private:
+    /**
+     * Read the next frame into pending_frame_.
+     *
+     * @return true if a frame is pending, false at the end of the log.
+     */
+    bool readNextFrame();
+    bool hasQueueRoom() const;
+    void finish();
+
+    arx::FrameLogReader reader_;
+    const EventQueue* queue_;
+    arx::RecordedFrame pending_frame_;
+    bool has_pending_frame_;
+    double speed_;
+    std::int64_t first_timestamp_ns_;
+    PipelineClock::time_point started_;
+    qint64 frames_;
+    QTimer timer_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,305 @@
+// Copyright 2022 Leonhard S.
+
+#include "ess-supervisor.hpp"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include <algorithm>
+
+#include "ess-client.hpp"
+
+namespace PresenceApp {
+
+EndpointHealth::EndpointHealth()
+    : online_{ true }
+    , downtime_ms_{ 0 }
+    , last_heartbeat_{}
+    , down_since_{} {}
+
+qint64 EndpointHealth::getDowntime(const QDateTime& now) const {
+    if (!down_since_.isValid()) {
+        return downtime_ms_;
+    }
+    return downtime_ms_ + down_since_.msecsTo(now);
+}
+
+ConnectionMetrics::ConnectionMetrics()
+    : reconnects_{ 0 }
+    , stalls_{ 0 }
+    , downtime_ms_{ 0 }
+    , last_heartbeat_{}
+    , down_since_{}
+    , endpoints_{} {}
+
+QStringList ConnectionMetrics::getOfflineEndpoints() const {
+    QStringList offline;
+    for (auto it = endpoints_.cbegin(); it != endpoints_.cend(); ++it) {
+        if (!it->online_) {
+            offline.append(it.key());
+        }
+    }
+    return offline;
+}
+
+qint64 ConnectionMetrics::getDowntime(const QDateTime& now) const {
+    if (!down_since_.isValid()) {
+        return downtime_ms_;
+    }
+    return downtime_ms_ + down_since_.msecsTo(now);
+}
+
+EssSupervisor::EssSupervisor(EssClient* client, QObject* parent)
+    : QObject(parent)
+    , client_{ client }
+    // Timers are parented so they follow the supervisor to its thread
+    , watchdog_{ this }
+    , backoff_timer_{ this }
+    , metrics_{}
+    , heartbeat_deadline_{ DEFAULT_HEARTBEAT_DEADLINE }
+    , connect_timeout_{ DEFAULT_CONNECT_TIMEOUT }
+    , backoff_base_{ DEFAULT_BACKOFF_BASE }
+    , backoff_max_{ DEFAULT_BACKOFF_MAX }
+    , attempt_{ 0 }
+    , active_{ false }
+    , connecting_{ false }
+    , connected_{ false }
+{
+    watchdog_.setSingleShot(true);
+    backoff_timer_.setSingleShot(true);
+    QObject::connect(&watchdog_, &QTimer::timeout,
+        this, &EssSupervisor::onWatchdogExpired);
+    QObject::connect(&backoff_timer_, &QTimer::timeout,
+        this, &EssSupervisor::onBackoffExpired);
+    QObject::connect(client_, &EssClient::connected,
+        this, &EssSupervisor::onConnected);
+    QObject::connect(client_, &EssClient::disconnected,
+        this, &EssSupervisor::onDisconnected);
+    QObject::connect(client_, &EssClient::errorOccurred,
+        this, &EssSupervisor::onErrorOccurred);
+    QObject::connect(client_, &EssClient::heartbeatReceived,
+        this, &EssSupervisor::onHeartbeatReceived);
+}
+
+const ConnectionMetrics& EssSupervisor::getMetrics() const {
+    return metrics_;
+}
+
+void EssSupervisor::setDeadlines(int heartbeat, int connect) {
+    heartbeat_deadline_ = heartbeat;
+    connect_timeout_ = connect;
+}
+
+void EssSupervisor::setBackoff(int base, int max) {
+    backoff_base_ = base;
+    backoff_max_ = std::max(base, max);
+}
+
+void EssSupervisor::start() {
+    if (active_) {
+        return;
+    }
+    active_ = true;
+    attempt_ = 0;
+    client_->connect();
+    connecting_ = true;
+    watchdog_.start(connect_timeout_);
+}
+
+void EssSupervisor::stop() {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    connecting_ = false;
+    connected_ = false;
+    watchdog_.stop();
+    backoff_timer_.stop();
+    client_->disconnect();
+    // An intentional disconnect is not downtime
+    markUp();
+}
+
+void EssSupervisor::onConnected() {
+    connecting_ = false;
+    connected_ = true;
+    if (active_) {
+        // The connection only counts as restored once a heartbeat arrives
+        watchdog_.start(heartbeat_deadline_);
+    }
+}
+
+void EssSupervisor::onDisconnected() {
+    if (!active_) {
+        return;
+    }
+    if (connecting_) {
+        connectFailed(QStringLiteral("connection closed"));
+        return;
+    }
+    if (!connected_) {
+        return;
+    }
+    connected_ = false;
+    qWarning() << "ESS connection lost";
+    watchdog_.stop();
+    markDown();
+    scheduleReconnect();
+}
+
+void EssSupervisor::onErrorOccurred(const QString& error) {
+    // Errors on an established connection are followed by a disconnect
+    if (!active_ || !connecting_) {
+        return;
+    }
+    connectFailed(error);
+}
+
+void EssSupervisor::onHeartbeatReceived(
+    const QMap<QString, bool>& endpoints
+) {
+    auto now = QDateTime::currentDateTimeUtc();
+    metrics_.last_heartbeat_ = now;
+    attempt_ = 0;
+    updateEndpoints(endpoints, now);
+    markUp();
+    if (active_) {
+        watchdog_.start(heartbeat_deadline_);
+    }
+}
+
+void EssSupervisor::onWatchdogExpired() {
+    if (!active_) {
+        return;
+    }
+    if (connected_) {
+        qWarning() << "No ESS heartbeat received for"
+            << heartbeat_deadline_ << "ms, assuming stream has stalled";
+        ++metrics_.stalls_;
+        emit stalled();
+        connected_ = false;
+        client_->disconnect();
+    }
+    else {
+        qWarning() << "Timed out connecting to ESS";
+        connecting_ = false;
+    }
+    markDown();
+    scheduleReconnect();
+}
+
+void EssSupervisor::onBackoffExpired() {
+    if (!active_) {
+        return;
+    }
+    ++metrics_.reconnects_;
+    emit metricsChanged(metrics_);
+    qDebug() << "Reconnecting to ESS, attempt" << attempt_;
+    // Closing the previous socket is not a failure of the new attempt
+    connecting_ = false;
+    connected_ = false;
+    client_->reconnect();
+    connecting_ = true;
+    watchdog_.start(connect_timeout_);
+}
+
+void EssSupervisor::connectFailed(const QString& reason) {
+    // Retry right away instead of waiting for the connect timeout
+    qWarning() << "Unable to connect to ESS:" << reason;
+    connecting_ = false;
+    watchdog_.stop();
+    markDown();
+    scheduleReconnect();
+}
+
+int EssSupervisor::nextBackoffDelay() const {
+    // Cap the exponent to avoid overflowing the shift
+    auto exponent = std::min(attempt_, 16);
+    auto delay = static_cast<int>(std::min<qint64>(
+        static_cast<qint64>(backoff_base_) << exponent, backoff_max_));
+    // Equal jitter: keep half of the delay, randomise the other half
+    auto half = delay / 2;
+    return half + static_cast<int>(
+        QRandomGenerator::global()->bounded(half + 1));
+}
+
+void EssSupervisor::markDown() {
+    if (metrics_.down_since_.isValid()) {
+        return;
+    }
+    metrics_.down_since_ = QDateTime::currentDateTimeUtc();
+    emit metricsChanged(metrics_);
+}
+
+void EssSupervisor::markUp() {
+    if (!metrics_.down_since_.isValid()) {
+        return;
+    }
+    metrics_.downtime_ms_ = metrics_.getDowntime(
+        QDateTime::currentDateTimeUtc());
+    metrics_.down_since_ = QDateTime();
+    emit metricsChanged(metrics_);
+}
+
+void EssSupervisor::updateEndpoints(
+    const QMap<QString, bool>& endpoints,
+    const QDateTime& now
+) {
+    auto changed = false;
+    for (auto it = endpoints.cbegin(); it != endpoints.cend(); ++it) {
+        // Endpoints are assumed online until a heartbeat says otherwise
+        auto& health = metrics_.endpoints_[it.key()];
+        health.last_heartbeat_ = now;
+        if (health.online_ == it.value()) {
+            continue;
+        }
+        health.online_ = it.value();
+        changed = true;
+        if (health.online_) {
+            health.downtime_ms_ = health.getDowntime(now);
+            health.down_since_ = QDateTime();
+            qDebug() << "ESS endpoint" << it.key() << "is back online";
+        }
+        else {
+            health.down_since_ = now;
+            qWarning() << "ESS endpoint" << it.key() << "went offline";
+        }
+    }
+    if (changed) {
+        emit metricsChanged(metrics_);
+    }
+}
+
+void EssSupervisor::scheduleReconnect() {
+    if (backoff_timer_.isActive()) {
+        return;
+    }
+    auto delay = nextBackoffDelay();
+    ++attempt_;
+    qDebug() << "Scheduling ESS reconnect in" << delay << "ms";
+    backoff_timer_.start(delay);
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_ess-supervisor.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
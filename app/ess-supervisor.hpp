@@ -0,0 +1,157 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMap>
+#include <QtCore/QMetaType>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include "ess-client.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Availability of a single event server endpoint, e.g. one world, as
+ * reported by ESS heartbeats.
+ */
+struct EndpointHealth {
+    EndpointHealth();
+
+    /**
+     * Get the total time the endpoint was reported offline.
+     *
+     * @param now The current time, used for any ongoing outage.
+     * @return The total downtime in milliseconds.
+     */
+    qint64 getDowntime(const QDateTime& now) const;
+
+    bool online_;
+    qint64 downtime_ms_;
+    QDateTime last_heartbeat_; // Last heartbeat listing this endpoint
+    QDateTime down_since_; // Invalid while the endpoint is online
+};
+
+/**
+ * Connection health statistics collected by an EssSupervisor.
+ */
+struct ConnectionMetrics {
+    ConnectionMetrics();
+
+    /**
+     * Get the names of all endpoints last reported offline.
+     */
+    QStringList getOfflineEndpoints() const;
+
+    /**
+     * Get the total time spent without a working connection.
+     *
+     * @param now The current time, used for any ongoing outage.
+     * @return The total downtime in milliseconds.
+     */
+    qint64 getDowntime(const QDateTime& now) const;
+
+    quint64 reconnects_;
+    quint64 stalls_;
+    qint64 downtime_ms_;
+    QDateTime last_heartbeat_;
+    QDateTime down_since_; // Invalid while the connection is healthy
+    QMap<QString, EndpointHealth> endpoints_;
+};
+
+/**
+ * Keeps an EssClient connected.
+ *
+ * The supervisor expects a heartbeat from the server at least every
+ * heartbeat deadline. If none arrives, the connection is lost, or a
+ * connection attempt fails, it reconnects with jittered exponential
+ * backoff. The client restores its subscriptions by itself once connected.
+ *
+ * Heartbeats also list the state of each event server endpoint. These are
+ * tracked separately, since a single world going offline does not stop
+ * the heartbeats themselves.
+ *
+ * The supervisor must live in the same thread as its client.
+ */
+class EssSupervisor: public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_HEARTBEAT_DEADLINE = 75000;
+    static constexpr int DEFAULT_CONNECT_TIMEOUT = 10000;
+    static constexpr int DEFAULT_BACKOFF_BASE = 1000;
+    static constexpr int DEFAULT_BACKOFF_MAX = 60000;
+
+    explicit EssSupervisor(EssClient* client, QObject* parent = nullptr);
+    EssSupervisor(const EssSupervisor& other) = delete;
+    EssSupervisor(EssSupervisor&& other) noexcept = delete;
+
+    EssSupervisor& operator=(const EssSupervisor& other) = delete;
+    EssSupervisor& operator=(EssSupervisor&& other) noexcept = delete;
+
+    const ConnectionMetrics& getMetrics() const;
+
+    /**
+     * Set the deadlines after which a connection is considered dead.
+     *
+     * @param heartbeat Time in milliseconds between heartbeats.
+     * @param connect Time in milliseconds to establish a connection.
+     */
+    void setDeadlines(int heartbeat, int connect);
+
+    /**
+     * Set the reconnect delay range.
+     *
+     * The delay doubles with every failed attempt, starting at base and
+     * capped at max. A random jitter of up to half the delay is applied.
+     *
+     * @param base Delay in milliseconds before the first retry.
+     * @param max Upper bound for the delay in milliseconds.
+     */
+    void setBackoff(int base, int max);
+
+Q_SIGNALS:
+    void metricsChanged(const ConnectionMetrics& metrics);
+    void stalled();
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void onConnected();
+    void onDisconnected();
+    void onErrorOccurred(const QString& error);
+    void onHeartbeatReceived(const QMap<QString, bool>& endpoints);
+    void onWatchdogExpired();
+    void onBackoffExpired();
+
+private:
+    void connectFailed(const QString& reason);
+    int nextBackoffDelay() const;
+    void markDown();
+    void markUp();
+    void updateEndpoints(const QMap<QString, bool>& endpoints,
+        const QDateTime& now);
+    void scheduleReconnect();
+
+    EssClient* client_;
+    QTimer watchdog_;
+    QTimer backoff_timer_;
+    ConnectionMetrics metrics_;
+    int heartbeat_deadline_;
+    int connect_timeout_;
+    int backoff_base_;
+    int backoff_max_;
+    int attempt_;
+    bool active_;
+    bool connecting_;
+    bool connected_;
+};
+
+} // namespace PresenceApp
+
+Q_DECLARE_METATYPE(PresenceApp::ConnectionMetrics)
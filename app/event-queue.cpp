@@ -0,0 +1,64 @@
+// Copyright 2022 Leonhard S.
+
+#include "event-queue.hpp"
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <cstddef>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+namespace PresenceApp {
+
+EventQueue::EventQueue(QObject* parent)
+    : QObject(parent)
+    , buffer_{}
+    , notify_pending_{ false }
+    , dropped_{ 0 }
+{}
+
+bool EventQueue::push(const QueuedEvent& event) {
+    if (!buffer_.push(event)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Only notify the consumer if it is not already about to drain. The
+    // fence orders the push before the flag check, see drain().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!notify_pending_.exchange(true, std::memory_order_acq_rel)) {
+        emit eventsAvailable();
+    }
+    return true;
+}
+
+bool EventQueue::isEmpty() const {
+    return buffer_.isEmpty();
+}
+
+std::size_t EventQueue::size() const {
+    return buffer_.size();
+}
+
+quint64 EventQueue::getDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_event-queue.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
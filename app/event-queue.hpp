@@ -0,0 +1,95 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <cstddef>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "metrics/pipeline-metrics.hpp"
+#include "ring-buffer.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Decoded event along with the timestamps of its way to the queue.
+ */
+struct QueuedEvent {
+    arx::EventPayload payload_;
+    EventTimestamps timestamps_;
+};
+
+/**
+ * Hands decoded ESS events from the network thread to the main thread.
+ *
+ * The network thread pushes events into a lock-free ring buffer. The
+ * eventsAvailable() signal is only emitted when the consumer has no
+ * notification pending, so a burst of events results in a single queued
+ * signal that is then drained in batches.
+ */
+class EventQueue: public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t CAPACITY = 8192;
+
+    explicit EventQueue(QObject* parent = nullptr);
+    EventQueue(const EventQueue& other) = delete;
+    EventQueue(EventQueue&& other) noexcept = delete;
+
+    EventQueue& operator=(const EventQueue& other) = delete;
+    EventQueue& operator=(EventQueue&& other) noexcept = delete;
+
+    /**
+     * Append an event to the queue. Producer thread only.
+     *
+     * If the queue is full, the event is dropped and counted.
+     *
+     * @param event The event to append.
+     * @return true on success, false if the event was dropped.
+     */
+    bool push(const QueuedEvent& event);
+
+    /**
+     * Remove up to the given number of events. Consumer thread only.
+     *
+     * @param handler Callable invoked with each event in order.
+     * @param max_count The maximum number of events to remove.
+     * @return The number of events removed.
+     */
+    template <typename Handler>
+    std::size_t drain(Handler&& handler, std::size_t max_count) {
+        // Clear the flag before draining; anything pushed after this point
+        // will either be drained below or trigger another notification.
+        // The fence pairs with the one in push(): without it, this thread
+        // could read a stale tail while the producer still sees the flag
+        // set, stranding the event until the next push.
+        notify_pending_.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::size_t count = 0;
+        QueuedEvent event;
+        while (count < max_count && buffer_.pop(&event)) {
+            handler(event);
+            ++count;
+        }
+        return count;
+    }
+
+    bool isEmpty() const;
+    std::size_t size() const;
+    quint64 getDroppedCount() const;
+
+Q_SIGNALS:
+    void eventsAvailable();
+
+private:
+    SpscRingBuffer<QueuedEvent, CAPACITY> buffer_;
+    std::atomic<bool> notify_pending_;
+    std::atomic<quint64> dropped_;
+};
+
+} // namespace PresenceApp
@@ -7,16 +7,15 @@
 #include <QtCore/QDebug>
 #include <QtCore/QJsonObject>
 #include <QtCore/QObject>
-#include <QtCore/QScopedPointer>
 #include <QtCore/QString>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkRequest>
-#include <QtNetwork/QNetworkReply>
 
 #include "arx.hpp"
 #include "ps2.hpp"
 
 #include "appdata/service-id.hpp"
+#include "cache/character-cache.hpp"
+#include "game/character-resolver.hpp"
+#include "census-client.hpp"
 #include "utils.hpp"
 
 namespace PresenceApp {
@@ -59,12 +58,33 @@ QDebug operator<<(QDebug dbg, const CharacterData& info) {
     return dbg << info.name_ << "[" << QString::fromStdString(tag) << "]";
 }
 
+CharacterData characterDataFromJson(const arx::json_t& object) {
+    CharacterData character;
+    character.id_ = characterIdFromJson(object);
+    character.name_ = QString::fromStdString(characterNameFromJson(object));
+    character.faction_ = factionFromJson(object);
+    character.class_ = classFromJsonProfile(object);
+    // Resolve characters_world join
+    auto world_data = object.find("world");
+    if (world_data == object.end()) {
+        qWarning() << "characterDataFromJson():"
+            << "No world join data in payload";
+    }
+    else if (!world_data->is_object()) {
+        qWarning() << "characterDataFromJson():"
+            << "World join data is not an object";
+    }
+    else {
+        character.server_ = serverFromJson(*world_data);
+    }
+    return character;
+}
+
 CharacterInfo::CharacterInfo(QObject* parent)
     : QObject(parent)
     , info_{}
-{
-    manager_.reset(new QNetworkAccessManager(this));
-}
+    , cache_{ nullptr }
+    , resolver_{ nullptr } {}
 
 CharacterInfo::CharacterInfo(arx::character_id_t id, QObject* parent)
     : CharacterInfo(parent)
@@ -107,44 +127,72 @@ ps2::Server CharacterInfo::getServer() const {
     return info_.server_;
 }
 
+void CharacterInfo::setCache(CharacterCache* cache) {
+    cache_ = cache;
+}
+
+void CharacterInfo::setResolver(CharacterResolver* resolver) {
+    resolver_ = resolver;
+}
+
 void CharacterInfo::populate() {
     // Only look up sensible character IDs
     if (info_.id_ <= 0) {
         qWarning() << "Call to CharacterInfo::populate() ignored due to "
             "invalid character ID:"
             << info_.id_;
+        // Still report completion so owners waiting on it can clean up
+        emit populated();
+        return;
+    }
+    // Use cached data where available; stale entries are shown right
+    // away and refreshed in the background.
+    if (cache_ != nullptr) {
+        CharacterData cached;
+        auto status = cache_->find(info_.id_, &cached);
+        if (status >= 0) {
+            updateFieldsIfChanged(cached.id_, cached.name_,
+                cached.faction_, cached.class_, cached.server_);
+        }
+        if (status == 0) {
+            emit populated();
+            return;
+        }
+    }
+    // Let the shared resolver batch this with other lookups
+    if (resolver_ != nullptr) {
+        resolver_->request(info_.id_, this,
+            [this](int status, const CharacterData& character) {
+                if (status == 0) {
+                    updateFieldsIfChanged(character.id_, character.name_,
+                        character.faction_, character.class_,
+                        character.server_);
+                }
+                emit populated();
+            });
         return;
     }
-    // Generate request
-    auto request = getCharacterInfoRequest();
-    // Reply object will be deleted by reply handler
-    auto reply = manager_->get(request);
-    QObject::connect(reply, &QNetworkReply::finished,
-        this, &CharacterInfo::onCharacterInfoRequestFinished);
+    // The shared client reuses connections across lookups
+    CensusClient::shared()->get(getCharacterInfoQuery(), this,
+        [this](const CensusResult& result) {
+            onCharacterInfoRequestFinished(result);
+        });
 }
 
-void CharacterInfo::onCharacterInfoRequestFinished() {
-    // Get reply object from caller
-    QScopedPointer<QNetworkReply> reply {
-        qobject_cast<QNetworkReply*>(QObject::sender())
-    };
-    if (!reply) {
-        qWarning() << "CharacterInfo::onCharacterInfoRequestFinished()"
-            << "Signal sender is not a QNetworkReply object.";
-    }
-    // Check for network errors
-    if (reply->error() != QNetworkReply::NoError) {
+void CharacterInfo::onCharacterInfoRequestFinished(
+    const CensusResult& result
+) {
+    if (result.status_ != 0) {
         qWarning() << "CharacterInfo::onCharacterInfoRequestFinished()"
-            << "Network error:" << reply->errorString();
+            << "Request failed:" << result.error_;
+        emit populated();
         return;
     }
-    // Get payload from reply
-    auto payload = getJsonPayload(reply);
-    // Handle payload
-    handleCharacterInfoPayload(payload);
+    handleCharacterInfoPayload(result.payload_);
+    emit populated();
 }
 
-QNetworkRequest CharacterInfo::getCharacterInfoRequest() {
+arx::Query CharacterInfo::getCharacterInfoQuery() const {
     // Create Query via ARX
     arx::Query query("character", SERVICE_ID);
     query.addTerm(
@@ -152,43 +200,31 @@ QNetworkRequest CharacterInfo::getCharacterInfoRequest() {
     query.setShow({ "character_id", "name.first", "faction_id", "profile_id" });
     auto join = arx::JoinData("characters_world");
     join.show_.push_back("world_id");
+    join.inject_at_ = "world";
     query.addJoin(join);
-    // Generate URL
-    auto url = qUrlFromArxQuery(query);
-    // Create request
-    return QNetworkRequest(url);
+    return query;
 }
 
 void CharacterInfo::handleCharacterInfoPayload(const arx::json_t& payload) {
-    if (!arx::validatePayload("character", payload)) {
+    if (arx::validatePayload("character", payload) != 0) {
         qWarning() << "CharacterInfo::handleCharacterInfoPayload(): "
             "Invalid JSON payload";
         return;
     }
-    // Get character object
-    auto data = arx::payloadResultAsObject("character", payload);
-    // Get new fields from payload
-    auto new_id = characterIdFromJson(data);
-    auto new_name = QString::fromStdString(characterNameFromJson(data));
-    auto new_faction = factionFromJson(data);
-    auto new_class = classFromJsonProfile(data);
-    // Resolve characters_world join
-    auto new_server = ps2::Server::Connery;
-    auto world_data = data.find("world");
-    if (world_data == data.end()) {
-        qWarning() << "CharacterInfo::handleCharacterInfoPayload():"
-            << "No world join data in payload";
-    }
-    else if (!world_data->is_object()) {
-        qWarning() << "CharacterInfo::handleCharacterInfoPayload():"
-            << "World join data is not an object";
-    }
-    else {
-        new_server = serverFromJson(*world_data);
+    if (arx::isPayloadEmpty("character", payload)) {
+        qWarning() << "CharacterInfo::handleCharacterInfoPayload(): "
+            "Character not found";
+        return;
     }
+    // Get character object
+    auto data = characterDataFromJson(
+        arx::payloadResultAsObject("character", payload));
     // Update fields
     updateFieldsIfChanged(
-        new_id, new_name, new_faction, new_class, new_server);
+        data.id_, data.name_, data.faction_, data.class_, data.server_);
+    if (cache_ != nullptr) {
+        cache_->insert(info_);
+    }
 }
 
 void CharacterInfo::updateFieldsIfChanged(
@@ -5,16 +5,18 @@
 #include <QtCore/QDebug>
 #include <QtCore/QMetaType>
 #include <QtCore/QObject>
-#include <QtCore/QScopedPointer>
 #include <QtCore/QString>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkRequest>
 
 #include "arx.hpp"
 #include "ps2.hpp"
 
+#include "census-client.hpp"
+
 namespace PresenceApp {
 
+class CharacterCache;
+class CharacterResolver;
+
 struct CharacterData {
     CharacterData();
     CharacterData(
@@ -43,6 +45,19 @@ struct CharacterData {
 
 QDebug operator<<(QDebug dbg, const CharacterData& info);
 
+/**
+ * Create character data from a Census API character object.
+ *
+ * The object is expected to contain the character_id, name.first,
+ * faction_id and profile_id fields, as well as a characters_world join
+ * injected at "world".
+ *
+ * @param object The JSON object to parse.
+ * @return The parsed character data; missing fields are left at their
+ * defaults.
+ */
+CharacterData characterDataFromJson(const arx::json_t& object);
+
 class CharacterInfo: public QObject {
     Q_OBJECT
 
@@ -68,19 +83,34 @@ public:
     ps2::Class getClass() const;
     ps2::Server getServer() const;
 
+    /**
+     * Serve lookups from the given cache where possible and store the
+     * results of any API requests in it.
+     *
+     * @param cache The character cache; must outlive this object.
+     */
+    void setCache(CharacterCache* cache);
+
+    /**
+     * Resolve the character via the given batch resolver instead of
+     * sending a dedicated request.
+     *
+     * @param resolver The shared resolver; must outlive this object.
+     */
+    void setResolver(CharacterResolver* resolver);
+
     void handleCharacterInfoPayload(const arx::json_t& payload);
 
 Q_SIGNALS:
     void infoChanged();
+    void populated();
 
 public Q_SLOTS:
     void populate();
 
-private Q_SLOTS:
-    void onCharacterInfoRequestFinished();
-
 private:
-    QNetworkRequest getCharacterInfoRequest();
+    arx::Query getCharacterInfoQuery() const;
+    void onCharacterInfoRequestFinished(const CensusResult& result);
     void updateFieldsIfChanged(arx::character_id_t id,
         const QString& name,
         ps2::Faction faction,
@@ -88,7 +118,8 @@ private:
         ps2::Server server);
 
     CharacterData info_;
-    QScopedPointer<QNetworkAccessManager> manager_;
+    CharacterCache* cache_;
+    CharacterResolver* resolver_;
 };
 
 } // namespace PresenceApp
@@ -0,0 +1,173 @@
+// Copyright 2022 Leonhard S.
+
+#include "game/character-resolver.hpp"
+
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+#include <string>
+#include <utility>
+#include <string_view>
+
+#include "arx.hpp"
+
+#include "appdata/service-id.hpp"
+#include "cache/character-cache.hpp"
+#include "game/character-info.hpp"
+#include "census-client.hpp"
+
+namespace PresenceApp {
+
+CharacterResolver::CharacterResolver(QObject* parent)
+    : QObject{ parent }
+    , pending_{}
+    , in_flight_{}
+    , waiters_{}
+    , cache_{ nullptr }
+    , batch_query_{ arx::QueryTemplate::intern(getBatchQuery()) }
+{
+    batch_timer_.reset(new QTimer(this));
+    batch_timer_->setSingleShot(true);
+    QObject::connect(batch_timer_.get(), &QTimer::timeout,
+        this, &CharacterResolver::onBatchTimerExpired);
+}
+
+void CharacterResolver::setCache(CharacterCache* cache) {
+    cache_ = cache;
+}
+
+void CharacterResolver::request(
+    arx::character_id_t id,
+    QObject* context,
+    Callback callback
+) {
+    if (id == 0) {
+        callback(-1, CharacterData());
+        return;
+    }
+    waiters_[id].append(Waiter{ context, std::move(callback) });
+    if (in_flight_.contains(id)) {
+        return;
+    }
+    pending_.insert(id);
+    if (!batch_timer_->isActive()) {
+        batch_timer_->start(BATCH_DELAY);
+    }
+}
+
+qsizetype CharacterResolver::getPendingCount() const {
+    return pending_.size() + in_flight_.size();
+}
+
+void CharacterResolver::onBatchTimerExpired() {
+    QList<arx::character_id_t> batch;
+    for (auto id : pending_) {
+        in_flight_.insert(id);
+        batch.append(id);
+        if (batch.size() == MAX_BATCH_SIZE) {
+            sendBatch(batch);
+            batch.clear();
+        }
+    }
+    if (!batch.isEmpty()) {
+        sendBatch(batch);
+    }
+    pending_.clear();
+}
+
+arx::Query CharacterResolver::getBatchQuery() {
+    // The character ID term is filled in per batch. The Census API treats
+    // comma-separated values as a list of alternatives, so one query
+    // covers the whole batch; the limit only needs to be large enough.
+    arx::Query query("character", SERVICE_ID);
+    query.addTerm(arx::SearchTerm("character_id", ""));
+    query.setShow({ "character_id", "name.first", "faction_id", "profile_id" });
+    query.setLimit(MAX_BATCH_SIZE);
+    auto join = arx::JoinData("characters_world");
+    join.show_.push_back("world_id");
+    join.inject_at_ = "world";
+    query.addJoin(join);
+    return query;
+}
+
+void CharacterResolver::sendBatch(const QList<arx::character_id_t>& ids) {
+    qDebug() << "Resolving" << ids.size() << "characters";
+    std::string id_list;
+    for (auto id : ids) {
+        if (!id_list.empty()) {
+            id_list.push_back(',');
+        }
+        id_list.append(std::to_string(id));
+    }
+    std::string_view values[] = { id_list };
+    CensusClient::shared()->get(batch_query_, values, this,
+        [this, ids](const CensusResult& result) { handleResult(ids, result); });
+}
+
+void CharacterResolver::handleResult(
+    const QList<arx::character_id_t>& ids,
+    const CensusResult& result
+) {
+    for (auto id : ids) {
+        in_flight_.remove(id);
+    }
+    QSet<arx::character_id_t> missing{ ids.begin(), ids.end() };
+    if (result.status_ != 0) {
+        qWarning() << "CharacterResolver::handleResult(): Request failed:"
+            << result.error_;
+    }
+    else {
+        for (const auto& object : arx::payloadResultsAsArray(
+            "character", result.payload_)) {
+            auto character = characterDataFromJson(object);
+            if (!missing.remove(character.id_)) {
+                continue;
+            }
+            if (cache_ != nullptr) {
+                cache_->insert(character);
+            }
+            notifyWaiters(character.id_, 0, character);
+        }
+    }
+    for (auto id : missing) {
+        notifyWaiters(id, -1, CharacterData());
+    }
+}
+
+void CharacterResolver::notifyWaiters(
+    arx::character_id_t id,
+    int status,
+    const CharacterData& character
+) {
+    // Take the waiters first; callbacks may request the ID again
+    auto waiters = waiters_.take(id);
+    for (const auto& waiter : waiters) {
+        if (!waiter.context_.isNull()) {
+            waiter.callback_(status, character);
+        }
+    }
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_character-resolver.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
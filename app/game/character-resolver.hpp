@@ -0,0 +1,101 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+#include <functional>
+
+#include "arx.hpp"
+
+#include "cache/character-cache.hpp"
+#include "game/character-info.hpp"
+#include "census-client.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Resolves character IDs via the Census API in batches.
+ *
+ * IDs requested within a short window are combined into a single query;
+ * requests for IDs that are already queued or in flight are coalesced.
+ * Each result is only delivered to the callbacks waiting for that ID, so
+ * resolving many characters at once stays linear in their number.
+ */
+class CharacterResolver: public QObject {
+    Q_OBJECT
+
+public:
+    /** Time requests are collected for before they are sent. */
+    static constexpr int BATCH_DELAY = 50;
+    /** Maximum number of character IDs requested per query. */
+    static constexpr int MAX_BATCH_SIZE = 100;
+
+    /**
+     * Called with 0 and the resolved character, or with -1 and empty
+     * character data if the character could not be resolved.
+     */
+    using Callback = std::function<void(int status,
+        const CharacterData& character)>;
+
+    explicit CharacterResolver(QObject* parent = nullptr);
+    CharacterResolver(const CharacterResolver& other) = delete;
+    CharacterResolver(CharacterResolver&& other) noexcept = delete;
+
+    CharacterResolver& operator=(const CharacterResolver& other) = delete;
+    CharacterResolver& operator=(CharacterResolver&& other) noexcept = delete;
+
+    /**
+     * Store resolved characters in the given cache.
+     *
+     * @param cache The character cache; must outlive the resolver.
+     */
+    void setCache(CharacterCache* cache);
+
+    /**
+     * Queue a character ID for resolution.
+     *
+     * The callback is invoked exactly once, when the batch the ID is part
+     * of has completed, and then forgotten.
+     *
+     * @param id The character ID to resolve.
+     * @param context The callback is skipped if this object is destroyed
+     * before the result arrives.
+     * @param callback The function to call with the result.
+     */
+    void request(arx::character_id_t id, QObject* context,
+        Callback callback);
+
+    qsizetype getPendingCount() const;
+
+private Q_SLOTS:
+    void onBatchTimerExpired();
+
+private:
+    static arx::Query getBatchQuery();
+    void sendBatch(const QList<arx::character_id_t>& ids);
+    void handleResult(const QList<arx::character_id_t>& ids,
+        const CensusResult& result);
+    void notifyWaiters(arx::character_id_t id, int status,
+        const CharacterData& character);
+
+    struct Waiter {
+        QPointer<QObject> context_;
+        Callback callback_;
+    };
+
+    QSet<arx::character_id_t> pending_;
+    QSet<arx::character_id_t> in_flight_;
+    QHash<arx::character_id_t, QList<Waiter>> waiters_;
+    CharacterCache* cache_;
+    arx::QueryTemplate batch_query_;
+    QScopedPointer<QTimer> batch_timer_;
+};
+
+} // namespace PresenceApp
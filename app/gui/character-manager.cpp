@@ -6,12 +6,7 @@
 #include <QtCore/QRegularExpression>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
-#include <QtCore/QUrl>
-#include <QtCore/QUrlQuery>
 #include <QtGui/QRegularExpressionValidator>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkRequest>
-#include <QtNetwork/QNetworkReply>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QDialog>
 #include <QtWidgets/QGridLayout>
@@ -28,15 +23,16 @@
 #include "ps2.hpp"
 
 #include "appdata/service-id.hpp"
+#include "cache/character-cache.hpp"
 #include "game/character-info.hpp"
-#include "utils.hpp"
+#include "census-client.hpp"
 
 namespace PresenceApp {
 
 CharacterManager::CharacterManager(QWidget* parent
 )
     : QDialog{ parent }
-    , manager_{ new QNetworkAccessManager() }
+    , cache_{ nullptr }
 {
     // Configure the modal dialog
     setWindowTitle(tr("Manage Characters"));
@@ -68,6 +64,10 @@ void CharacterManager::addCharacter(const CharacterData& character) {
     }
 }
 
+void CharacterManager::setCharacterCache(CharacterCache* cache) {
+    cache_ = cache;
+}
+
 void CharacterManager::onAddButtonClicked() {
     QScopedPointer<QDialog> dialog(createCharacterNameInputDialog());
     if (dialog->exec() == QDialog::DialogCode::Rejected) {
@@ -89,16 +89,22 @@ void CharacterManager::onAddButtonClicked() {
             return;
         }
     }
-    // Validate that this character exists
-    auto reply = manager_->get(QNetworkRequest(getCharacterInfoUrl(name)));
-    QObject::connect(reply, &QNetworkReply::finished,
-        this, &CharacterManager::onCharacterInfoReceived);
+    // Recently resolved characters do not need to be validated again
+    CharacterData cached;
+    if (cache_ != nullptr && cache_->findByName(name, &cached) == 0) {
+        addCharacter(cached);
+        return;
+    }
     // Create temp character entry to show while waiting for reply
     auto item = new QListWidgetItem(tr("Loading '%1'…").arg(name));
     // Make unselectable
     item->setFlags(item->flags() & ~Qt::ItemIsSelectable);
-    item->setData(Qt::UserRole, QVariant::fromValue(reply));
     list_->addItem(item);
+    // Validate that this character exists
+    CensusClient::shared()->get(getCharacterInfoQuery(name), this,
+        [this, item](const CensusResult& result) {
+            onCharacterInfoReceived(item, result);
+        });
 }
 
 void CharacterManager::onRemoveButtonClicked() {
@@ -124,22 +130,17 @@ void CharacterManager::onCharacterSelected() {
     button_remove_->setEnabled(list_->currentRow() != -1);
 }
 
-void CharacterManager::onCharacterInfoReceived() {
-    // Get reply (cast to ScopedPointer to ensure it is deleted when this
-    // function returns)
-    QScopedPointer<QNetworkReply> reply {
-        qobject_cast<QNetworkReply*>(QObject::sender())
-    };
+void CharacterManager::onCharacterInfoReceived(
+    QListWidgetItem* item,
+    const CensusResult& result
+) {
     // Remove temporary list entry
-    for (int i = 0; i < list_->count(); ++i) {
-        auto item_data = list_->item(i)->data(Qt::UserRole);
-        if (item_data.value<QNetworkReply*>() == reply.data()) {
-            list_->takeItem(i);
-            break;
-        }
+    auto row = list_->row(item);
+    if (row >= 0) {
+        delete list_->takeItem(row);
     }
     // Check for errors
-    if (reply->error() != QNetworkReply::NetworkError::NoError) {
+    if (result.status_ == -1) {
         QMessageBox::critical(this,
             tr("Character Manager"),
             tr("Failed to retrieve character info."),
@@ -148,8 +149,8 @@ void CharacterManager::onCharacterInfoReceived() {
     }
     // Validate payload
     const std::string collection = "character";
-    auto payload = getJsonPayload(reply);
-    if (!arx::validatePayload(collection, payload)) {
+    const auto& payload = result.payload_;
+    if (result.status_ != 0) {
         QMessageBox::critical(this,
             tr("Character Manager"),
             tr("Invalid character info payload."),
@@ -165,6 +166,7 @@ void CharacterManager::onCharacterInfoReceived() {
     }
     // HACK: Parse character data
     CharacterInfo temp;
+    temp.setCache(cache_);
     temp.handleCharacterInfoPayload(payload);
     CharacterData info{ temp.getId(), temp.getName(), temp.getFaction(),
                        temp.getClass(), temp.getServer() };
@@ -174,7 +176,8 @@ void CharacterManager::onCharacterInfoReceived() {
     list_->addItem(item);
 }
 
-QUrl CharacterManager::getCharacterInfoUrl(const QString& character) const {
+arx::Query CharacterManager::getCharacterInfoQuery(
+    const QString& character) const {
     auto name = character.toLower().toStdString();
     // Create API query
     arx::Query query("character", SERVICE_ID);
@@ -184,8 +187,7 @@ QUrl CharacterManager::getCharacterInfoUrl(const QString& character) const {
     join.inject_at_ = "world";
     query.addJoin(join);
     query.setShow({ "character_id", "name.first", "faction_id", "profile_id" });
-    // Build QUrl object
-    return qUrlFromArxQuery(query);
+    return query;
 }
 
 CharacterData CharacterManager::parseCharacterPayload(
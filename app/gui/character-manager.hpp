@@ -6,15 +6,15 @@
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
-#include <QtCore/QUrl>
-#include <QtNetwork/QNetworkAccessManager>
 #include <QtWidgets/QDialog>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QPushButton>
 
 #include "arx.hpp"
 
+#include "cache/character-cache.hpp"
 #include "game/character-info.hpp"
+#include "census-client.hpp"
 
 namespace PresenceApp {
 
@@ -31,6 +31,14 @@ public:
 
     void addCharacter(const CharacterData& character);
 
+    /**
+     * Resolve character names via the given cache before querying the
+     * API, and store any API results in it.
+     *
+     * @param cache The character cache; must outlive the dialog.
+     */
+    void setCharacterCache(CharacterCache* cache);
+
 Q_SIGNALS:
     void characterAdded(int index, const CharacterData& name);
     void characterRemoved(int index, const CharacterData& name);
@@ -39,15 +47,16 @@ private Q_SLOTS:
     void onAddButtonClicked();
     void onRemoveButtonClicked();
     void onCharacterSelected();
-    void onCharacterInfoReceived();
 
 private:
-    QUrl getCharacterInfoUrl(const QString& character) const;
+    arx::Query getCharacterInfoQuery(const QString& character) const;
+    void onCharacterInfoReceived(QListWidgetItem* item,
+        const CensusResult& result);
     CharacterData parseCharacterPayload(const arx::json_t& payload);
     QDialog* createCharacterNameInputDialog();
     void setupUi();
 
-    QScopedPointer<QNetworkAccessManager> manager_;
+    CharacterCache* cache_;
 
     QListWidget* list_;
     QPushButton* button_add_;
@@ -20,7 +20,11 @@
 
 #include <numeric>
 
+#include "arx.hpp"
+
+#include "cache/character-cache.hpp"
 #include "game/character-info.hpp"
+#include "game/character-resolver.hpp"
 #include "gui/character-manager.hpp"
 #include "gui/timeago.hpp"
 #include "persistence.hpp"
@@ -58,6 +62,10 @@ MainWindow::MainWindow()
     QObject::connect(app_.get(), &RichPresenceApp::eventPayloadReceived,
         this, &MainWindow::onEventPayloadReceived);
 
+    character_cache_.reset(new CharacterCache());
+    character_resolver_.reset(new CharacterResolver(this));
+    character_resolver_->setCache(character_cache_.get());
+
     // Restore last app state
     loadConfig();
 
@@ -70,6 +78,10 @@ MainWindow::MainWindow()
     last_seen_timer_->start();
 }
 
+RichPresenceApp* MainWindow::getApp() const {
+    return app_.get();
+}
+
 bool MainWindow::isPresenceEnabled() const {
     // TODO: Hook up enable/disable switch
     return true;
@@ -105,9 +117,19 @@ void MainWindow::loadConfig() {
     std::for_each(characters.begin(), characters.end(),
         [this](const QVariant& character) {
             auto info = character.value<CharacterData>();
+            // Prefer cached data as it is updated more often than the
+            // config; only stale characters are fetched from the API.
+            CharacterData cached;
+            auto status = character_cache_->find(info.id_, &cached);
+            if (status >= 0) {
+                info = cached;
+            }
+            if (status != 0) {
+                refreshCharacter(info.id_);
+            }
             characters_combo_box_->insertItem(
                 characters_combo_box_->count() - 2,
-                info.name_, character);
+                info.name_, QVariant::fromValue(info));
         });
     // TODO: Load GUI config
 }
@@ -142,6 +164,14 @@ void MainWindow::onCharacterChanged(int index) {
     if (info.id_ == 0) {
         return;
     }
+    CharacterData cached;
+    auto status = character_cache_->find(info.id_, &cached);
+    if (status >= 0) {
+        info = cached;
+    }
+    if (status != 0) {
+        refreshCharacter(info.id_);
+    }
     // If the tracker is already running for another character, stop it
     if (isTrackerRunning()) {
         const auto& current = app_->getCharacter();
@@ -169,6 +199,7 @@ void MainWindow::onLastSeenTimerExpired() {
 void MainWindow::openCharacterManager(
     const QList<CharacterData>& characters) {
     auto dialog = new CharacterManager(this);
+    dialog->setCharacterCache(character_cache_.get());
     // Add existing characters
     std::for_each(characters.begin(), characters.end(),
         [dialog](const CharacterData& character) {
@@ -212,6 +243,34 @@ void MainWindow::openCharacterManager(
     }
 }
 
+void MainWindow::refreshCharacter(arx::character_id_t id) {
+    // Stale characters are resolved in batches; the info object deletes
+    // itself once its character has been resolved
+    auto info = new CharacterInfo(id, this);
+    info->setCache(character_cache_.get());
+    info->setResolver(character_resolver_.get());
+    QObject::connect(info, &CharacterInfo::infoChanged, this,
+        [this, info]() {
+            updateCharacterEntry(CharacterData{ info->getId(),
+                info->getName(), info->getFaction(), info->getClass(),
+                info->getServer() });
+        });
+    QObject::connect(info, &CharacterInfo::populated,
+        info, &QObject::deleteLater);
+    info->populate();
+}
+
+void MainWindow::updateCharacterEntry(const CharacterData& character) {
+    for (int i = 0; i < characters_combo_box_->count() - 2; ++i) {
+        auto info = characters_combo_box_->itemData(i).value<CharacterData>();
+        if (info.id_ == character.id_ && info != character) {
+            characters_combo_box_->setItemText(i, character.name_);
+            characters_combo_box_->setItemData(
+                i, QVariant::fromValue(character));
+        }
+    }
+}
+
 void MainWindow::updateEventLatency() {
     setEventLatency(app_->getEventLatency());
 }
@@ -12,7 +12,11 @@
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QWidget>
 
+#include "arx.hpp"
+
+#include "cache/character-cache.hpp"
 #include "game/character-info.hpp"
+#include "game/character-resolver.hpp"
 #include "core.hpp"
 
 namespace PresenceApp {
@@ -28,6 +32,7 @@ public:
     MainWindow& operator=(const MainWindow& other) = delete;
     MainWindow& operator=(MainWindow&& other) noexcept = delete;
 
+    RichPresenceApp* getApp() const;
     bool isPresenceEnabled() const;
     bool isTrackerRunning() const;
 
@@ -45,6 +50,8 @@ private Q_SLOTS:
 
 private:
     void openCharacterManager(const QList<CharacterData>& characters = {});
+    void refreshCharacter(arx::character_id_t id);
+    void updateCharacterEntry(const CharacterData& character);
     void updateEventLatency();
     void updateEventFrequency();
     void updateLastSeenLabels();
@@ -61,6 +68,8 @@ private:
     void setupUi();
 
     QScopedPointer<RichPresenceApp> app_;
+    QScopedPointer<CharacterCache> character_cache_;
+    QScopedPointer<CharacterResolver> character_resolver_;
     QScopedPointer<QTimer> last_seen_timer_;
 
     // GUI elements
@@ -1,10 +1,17 @@
 // Copyright 2022 Leonhard S.
 
 #include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
 #include <QCoreApplication>
+#include <QDebug>
+#include <QUrl>
 
 #include "gui/main-window.hpp"
+#include "census-client.hpp"
 #include "config.hpp"
+#include "ess-supervisor.hpp"
+#include "presence/sink.hpp"
 
 
 int main(int argc, char* argv[]) {
@@ -13,7 +20,111 @@ int main(int argc, char* argv[]) {
     QCoreApplication::setApplicationName("PS2 Rich Presence");
     QCoreApplication::setApplicationVersion(PRESENCE_APP_VERSION);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption endpoint_option("ess-url",
+        "Connect to the ESS endpoint at <url> instead of the public one.",
+        "url");
+    QCommandLineOption census_option("census-url",
+        "Send Census API requests to <url> instead of the public API.",
+        "url");
+    QCommandLineOption record_option("record",
+        "Record all ESS frames received to <file>.", "file");
+    QCommandLineOption replay_option("replay",
+        "Replay ESS frames from <file> instead of connecting.", "file");
+    QCommandLineOption speed_option("replay-speed",
+        "Replay at <factor> times the recorded speed; 0 replays as fast "
+        "as possible.", "factor", "1");
+    QCommandLineOption heartbeat_option("ess-heartbeat-deadline",
+        "Reconnect if no ESS heartbeat arrives within <ms> milliseconds.",
+        "ms", QString::number(
+            PresenceApp::EssSupervisor::DEFAULT_HEARTBEAT_DEADLINE));
+    QCommandLineOption connect_option("ess-connect-timeout",
+        "Give up on ESS connection attempts after <ms> milliseconds.",
+        "ms", QString::number(
+            PresenceApp::EssSupervisor::DEFAULT_CONNECT_TIMEOUT));
+    QCommandLineOption backoff_base_option("ess-backoff-base",
+        "Wait <ms> milliseconds before the first ESS reconnect attempt.",
+        "ms", QString::number(
+            PresenceApp::EssSupervisor::DEFAULT_BACKOFF_BASE));
+    QCommandLineOption backoff_max_option("ess-backoff-max",
+        "Wait at most <ms> milliseconds between ESS reconnect attempts.",
+        "ms", QString::number(
+            PresenceApp::EssSupervisor::DEFAULT_BACKOFF_MAX));
+    QCommandLineOption sink_option("presence-sink",
+        "Submit activities to <sink>: "
+        + PresenceApp::getPresenceSinkNames().join(", ") + ".", "sink",
+        PresenceApp::getDefaultPresenceSink());
+    parser.addOption(endpoint_option);
+    parser.addOption(census_option);
+    parser.addOption(record_option);
+    parser.addOption(replay_option);
+    parser.addOption(speed_option);
+    parser.addOption(heartbeat_option);
+    parser.addOption(connect_option);
+    parser.addOption(backoff_base_option);
+    parser.addOption(backoff_max_option);
+    parser.addOption(sink_option);
+    parser.process(app);
+
+    // Must be set up before the main window issues its first requests
+    if (parser.isSet(census_option)) {
+        QUrl census_url(parser.value(census_option));
+        if (!census_url.isValid() || census_url.host().isEmpty()) {
+            qCritical() << "Invalid Census API URL:"
+                << parser.value(census_option);
+            return 1;
+        }
+        PresenceApp::CensusClient::shared()->setBaseUrl(census_url);
+    }
+
+    if (PresenceApp::setDefaultPresenceSink(
+        parser.value(sink_option)) != 0) {
+        qCritical() << "Unknown presence sink:" << parser.value(sink_option);
+        return 1;
+    }
+
     PresenceApp::MainWindow main_window;
+    if (parser.isSet(endpoint_option)) {
+        main_window.getApp()->setEndpointBaseUrl(
+            parser.value(endpoint_option));
+    }
+    bool heartbeat_ok = false;
+    bool connect_ok = false;
+    bool backoff_base_ok = false;
+    bool backoff_max_ok = false;
+    auto heartbeat = parser.value(heartbeat_option).toInt(&heartbeat_ok);
+    auto connect = parser.value(connect_option).toInt(&connect_ok);
+    auto backoff_base = parser.value(backoff_base_option)
+        .toInt(&backoff_base_ok);
+    auto backoff_max = parser.value(backoff_max_option)
+        .toInt(&backoff_max_ok);
+    if (!heartbeat_ok || heartbeat <= 0 || !connect_ok || connect <= 0
+        || !backoff_base_ok || backoff_base <= 0
+        || !backoff_max_ok || backoff_max <= 0) {
+        qCritical() << "ESS deadlines and backoff delays must be positive"
+            << "numbers of milliseconds";
+        return 1;
+    }
+    main_window.getApp()->setConnectionDeadlines(heartbeat, connect);
+    main_window.getApp()->setReconnectBackoff(backoff_base, backoff_max);
+    if (parser.isSet(record_option)) {
+        main_window.getApp()->startRecording(parser.value(record_option));
+    }
+    if (parser.isSet(replay_option)) {
+        bool ok = false;
+        auto speed = parser.value(speed_option).toDouble(&ok);
+        if (!ok || speed < 0.0) {
+            qCritical() << "Invalid replay speed:"
+                << parser.value(speed_option);
+            return 1;
+        }
+        if (main_window.getApp()->startReplay(
+            parser.value(replay_option), speed) != 0) {
+            return 1;
+        }
+    }
     main_window.show();
 
     return app.exec();
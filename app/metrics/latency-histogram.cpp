@@ -0,0 +1,86 @@
+// Copyright 2022 Leonhard S.
+
+#include "metrics/latency-histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace PresenceApp {
+
+LatencyHistogram::LatencyHistogram()
+    : buckets_{}
+    , count_{ 0 }
+    , max_{ 0 } {}
+
+void LatencyHistogram::record(std::int64_t value) {
+    auto clamped = std::clamp<std::int64_t>(value, 0, MAX_VALUE);
+    ++buckets_[bucketIndex(clamped)];
+    ++count_;
+    max_ = std::max(max_, clamped);
+}
+
+std::int64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (count_ == 0) {
+        return -1;
+    }
+    // Rank of the sample at the requested percentile, starting at 1
+    auto rank = static_cast<std::uint64_t>(std::ceil(
+        std::clamp(percentile, 0.0, 100.0) / 100.0
+        * static_cast<double>(count_)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // The bucket bound may overshoot the largest actual sample
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::uint64_t LatencyHistogram::getCount() const {
+    return count_;
+}
+
+std::int64_t LatencyHistogram::getMax() const {
+    return max_;
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    max_ = 0;
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::int64_t value) {
+    if (value < LINEAR_LIMIT) {
+        return static_cast<std::size_t>(value);
+    }
+    auto unsigned_value = static_cast<std::uint64_t>(value);
+    auto exponent = static_cast<int>(std::bit_width(unsigned_value)) - 1;
+    auto shift = exponent - SUB_BUCKET_BITS;
+    auto sub_bucket = static_cast<std::size_t>(
+        (unsigned_value >> shift) & (SUB_BUCKETS - 1));
+    return static_cast<std::size_t>(LINEAR_LIMIT)
+        + static_cast<std::size_t>(exponent - MIN_EXPONENT) * SUB_BUCKETS
+        + sub_bucket;
+}
+
+std::int64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+    if (index < static_cast<std::size_t>(LINEAR_LIMIT)) {
+        return static_cast<std::int64_t>(index);
+    }
+    auto offset = index - static_cast<std::size_t>(LINEAR_LIMIT);
+    auto exponent = static_cast<int>(offset / SUB_BUCKETS) + MIN_EXPONENT;
+    auto sub_bucket = static_cast<std::int64_t>(offset % SUB_BUCKETS);
+    auto shift = exponent - SUB_BUCKET_BITS;
+    auto lower = (static_cast<std::int64_t>(SUB_BUCKETS) + sub_bucket)
+        << shift;
+    return lower + (std::int64_t{ 1 } << shift) - 1;
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,66 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace PresenceApp {
+
+/**
+ * Fixed-size histogram of latency samples for percentile estimation.
+ *
+ * The histogram is unit-agnostic. Values below 16 are counted exactly.
+ * Larger values are grouped into eight linear sub-buckets per power of two,
+ * similar to an HDR histogram, which bounds the relative error of any
+ * percentile to 12.5%. Recording and querying never allocate.
+ */
+class LatencyHistogram {
+public:
+    /** Largest value tracked; larger samples are clamped to it. */
+    static constexpr std::int64_t MAX_VALUE = (std::int64_t{ 1 } << 32) - 1;
+
+    LatencyHistogram();
+
+    /**
+     * Add a sample to the histogram.
+     *
+     * @param value The latency to add. Negative values, e.g. caused by
+     * clock skew, are counted as zero.
+     */
+    void record(std::int64_t value);
+
+    /**
+     * Estimate the given percentile of all recorded samples.
+     *
+     * @param percentile The percentile to compute, between 0 and 100.
+     * @return The upper bound of the bucket containing the percentile, or
+     * -1 if no samples have been recorded.
+     */
+    std::int64_t getPercentile(double percentile) const;
+
+    std::uint64_t getCount() const;
+    std::int64_t getMax() const;
+
+    void reset();
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr std::size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    /** Values below this are counted exactly. */
+    static constexpr std::int64_t LINEAR_LIMIT = 2 * SUB_BUCKETS;
+    static constexpr int MIN_EXPONENT = SUB_BUCKET_BITS + 1;
+    static constexpr int MAX_EXPONENT = 31;
+    static constexpr std::size_t BUCKET_COUNT = LINEAR_LIMIT
+        + (MAX_EXPONENT - MIN_EXPONENT + 1) * SUB_BUCKETS;
+
+    static std::size_t bucketIndex(std::int64_t value);
+    static std::int64_t bucketUpperBound(std::size_t index);
+
+    std::array<std::uint64_t, BUCKET_COUNT> buckets_;
+    std::uint64_t count_;
+    std::int64_t max_;
+};
+
+} // namespace PresenceApp
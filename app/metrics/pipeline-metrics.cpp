@@ -0,0 +1,110 @@
+// Copyright 2022 Leonhard S.
+
+#include "metrics/pipeline-metrics.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "metrics/latency-histogram.hpp"
+
+namespace PresenceApp {
+
+PipelineMetrics::PipelineMetrics()
+    : histograms_{}
+    , pending_since_{}
+    , has_pending_state_{ false } {}
+
+void PipelineMetrics::record(
+    PipelineStage stage,
+    PipelineClock::duration duration
+) {
+    histogram(stage).record(static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            duration).count()));
+}
+
+void PipelineMetrics::recordEvent(
+    const EventTimestamps& timestamps,
+    PipelineClock::time_point dequeued,
+    PipelineClock::time_point routed,
+    PipelineClock::time_point handled,
+    bool state_changed
+) {
+    record(PipelineStage::Decode, timestamps.decoded_ - timestamps.received_);
+    record(PipelineStage::QueueWait, dequeued - timestamps.decoded_);
+    record(PipelineStage::StateUpdate, handled - routed);
+    // Only the oldest change matters; later ones are merged into the same
+    // presence update.
+    if (state_changed && !has_pending_state_) {
+        pending_since_ = timestamps.received_;
+        has_pending_state_ = true;
+    }
+}
+
+void PipelineMetrics::recordPresence(
+    PipelineClock::time_point started,
+    PipelineClock::time_point built,
+    PipelineClock::time_point submitted,
+    bool sent
+) {
+    record(PipelineStage::PresenceBuild, built - started);
+    if (!sent) {
+        has_pending_state_ = false;
+        return;
+    }
+    record(PipelineStage::DiscordSubmit, submitted - built);
+    if (has_pending_state_) {
+        record(PipelineStage::EndToEnd, submitted - pending_since_);
+        has_pending_state_ = false;
+    }
+}
+
+StageSummary PipelineMetrics::getSummary(PipelineStage stage) const {
+    const auto& hist = histogram(stage);
+    return StageSummary{
+        hist.getCount(),
+        hist.getPercentile(50.0),
+        hist.getPercentile(99.0),
+        hist.getPercentile(99.9),
+        hist.getCount() > 0 ? hist.getMax() : -1,
+    };
+}
+
+void PipelineMetrics::reset() {
+    for (auto& hist : histograms_) {
+        hist.reset();
+    }
+    has_pending_state_ = false;
+}
+
+const LatencyHistogram& PipelineMetrics::histogram(
+    PipelineStage stage
+) const {
+    return histograms_[static_cast<std::size_t>(stage)];
+}
+
+LatencyHistogram& PipelineMetrics::histogram(PipelineStage stage) {
+    return histograms_[static_cast<std::size_t>(stage)];
+}
+
+const char* pipelineStageName(PipelineStage stage) {
+    switch (stage) {
+    case PipelineStage::Decode:
+        return "decode";
+    case PipelineStage::QueueWait:
+        return "queue";
+    case PipelineStage::StateUpdate:
+        return "state";
+    case PipelineStage::PresenceBuild:
+        return "presence";
+    case PipelineStage::DiscordSubmit:
+        return "discord";
+    case PipelineStage::EndToEnd:
+        return "end-to-end";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,116 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "metrics/latency-histogram.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Monotonic clock used for pipeline timestamps across threads.
+ */
+using PipelineClock = std::chrono::steady_clock;
+
+/**
+ * Stages of the event pipeline that are timed individually.
+ */
+enum class PipelineStage {
+    Decode,         // Frame received by EssClient -> payload decoded
+    QueueWait,      // Payload decoded -> dequeued on the main thread
+    StateUpdate,    // Routed to the trackers -> trackers updated
+    PresenceBuild,  // Time spent building the presence activity
+    DiscordSubmit,  // Time spent submitting the activity to Discord
+    EndToEnd,       // First frame changing the state -> Discord submit
+};
+
+inline constexpr std::size_t PIPELINE_STAGE_COUNT =
+    static_cast<std::size_t>(PipelineStage::EndToEnd) + 1;
+
+/**
+ * Timestamps recorded for an event before it reaches the main thread.
+ */
+struct EventTimestamps {
+    PipelineClock::time_point received_;
+    PipelineClock::time_point decoded_;
+};
+
+/**
+ * Percentile summary of a single pipeline stage, in microseconds.
+ */
+struct StageSummary {
+    std::uint64_t count_;
+    std::int64_t p50_;
+    std::int64_t p99_;
+    std::int64_t p999_;
+    std::int64_t max_;
+};
+
+/**
+ * Per-stage latency histograms for the event-to-presence pipeline.
+ *
+ * All durations are recorded in microseconds. This class is not thread
+ * safe; timestamps taken on other threads are carried to the main thread
+ * alongside the event and recorded there.
+ */
+class PipelineMetrics {
+public:
+    PipelineMetrics();
+
+    void record(PipelineStage stage, PipelineClock::duration duration);
+
+    /**
+     * Record the timed stages of an event once it has been dequeued.
+     *
+     * @param timestamps The timestamps carried with the event.
+     * @param dequeued When the event was taken off the queue.
+     * @param routed When the trackers started processing the event.
+     * @param handled When the trackers finished processing the event.
+     * @param state_changed Whether the displayed game state changed.
+     */
+    void recordEvent(
+        const EventTimestamps& timestamps,
+        PipelineClock::time_point dequeued,
+        PipelineClock::time_point routed,
+        PipelineClock::time_point handled,
+        bool state_changed);
+
+    /**
+     * Record the presence stages of a Discord update.
+     *
+     * If a game state change is pending, this also records the end-to-end
+     * latency from the frame that caused it. Activities that were not sent
+     * because they were unchanged only record their build time; the
+     * pending change is discarded since it never reached Discord.
+     *
+     * @param started When the presence build started.
+     * @param built When the presence build finished.
+     * @param submitted When the presence was submitted to Discord.
+     * @param sent Whether the activity was actually sent.
+     */
+    void recordPresence(
+        PipelineClock::time_point started,
+        PipelineClock::time_point built,
+        PipelineClock::time_point submitted,
+        bool sent);
+
+    StageSummary getSummary(PipelineStage stage) const;
+
+    void reset();
+
+private:
+    const LatencyHistogram& histogram(PipelineStage stage) const;
+    LatencyHistogram& histogram(PipelineStage stage);
+
+    std::array<LatencyHistogram, PIPELINE_STAGE_COUNT> histograms_;
+    PipelineClock::time_point pending_since_;
+    bool has_pending_state_;
+};
+
+const char* pipelineStageName(PipelineStage stage);
+
+} // namespace PresenceApp
@@ -0,0 +1,85 @@
+// Copyright 2022 Leonhard S.
+
+#include "metrics/rate-meter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PresenceApp {
+
+RateMeter::RateMeter()
+    : buckets_{}
+    , current_second_{ 0 }
+    , short_total_{ 0 }
+    , medium_total_{ 0 }
+    , long_total_{ 0 } {}
+
+void RateMeter::record(std::int64_t now_ms) {
+    advance(now_ms);
+    ++bucket(current_second_);
+    ++short_total_;
+    ++medium_total_;
+    ++long_total_;
+}
+
+std::uint64_t RateMeter::getCount(RateWindow window, std::int64_t now_ms) {
+    advance(now_ms);
+    switch (window) {
+    case RateWindow::OneSecond:
+        return short_total_;
+    case RateWindow::ThirtySeconds:
+        return medium_total_;
+    case RateWindow::FiveMinutes:
+    default:
+        return long_total_;
+    }
+}
+
+double RateMeter::getRate(RateWindow window, std::int64_t now_ms) {
+    std::int64_t length = LONG_WINDOW;
+    if (window == RateWindow::OneSecond) {
+        length = SHORT_WINDOW;
+    }
+    else if (window == RateWindow::ThirtySeconds) {
+        length = MEDIUM_WINDOW;
+    }
+    return static_cast<double>(getCount(window, now_ms))
+        / static_cast<double>(length);
+}
+
+void RateMeter::reset() {
+    buckets_.fill(0);
+    short_total_ = 0;
+    medium_total_ = 0;
+    long_total_ = 0;
+}
+
+std::uint32_t& RateMeter::bucket(std::int64_t second) {
+    auto index = static_cast<std::size_t>(
+        ((second % LONG_WINDOW) + LONG_WINDOW) % LONG_WINDOW);
+    return buckets_[index];
+}
+
+void RateMeter::advance(std::int64_t now_ms) {
+    auto second = now_ms / 1000;
+    if (second <= current_second_) {
+        return;
+    }
+    // Nothing survives a gap longer than the wheel; skip the replay
+    if (second - current_second_ >= LONG_WINDOW) {
+        reset();
+        current_second_ = second;
+        return;
+    }
+    while (current_second_ < second) {
+        ++current_second_;
+        // Deduct the buckets leaving each window, then recycle the oldest
+        short_total_ -= bucket(current_second_ - SHORT_WINDOW);
+        medium_total_ -= bucket(current_second_ - MEDIUM_WINDOW);
+        auto& recycled = bucket(current_second_);
+        long_total_ -= recycled;
+        recycled = 0;
+    }
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,80 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace PresenceApp {
+
+/**
+ * Time windows supported by RateMeter.
+ */
+enum class RateWindow {
+    OneSecond,
+    ThirtySeconds,
+    FiveMinutes,
+};
+
+/**
+ * Rolling event counter over fixed time windows.
+ *
+ * Events are counted in a wheel of one-second buckets covering the longest
+ * window. Running totals are kept for every window and updated as buckets
+ * leave them, so both recording and querying are O(1) and never allocate.
+ *
+ * Each window covers the current, partial second plus the preceding full
+ * seconds up to its length.
+ */
+class RateMeter {
+public:
+    static constexpr std::size_t WHEEL_SIZE = 300;
+
+    RateMeter();
+
+    /**
+     * Count a single event.
+     *
+     * @param now_ms The current time in milliseconds. Must not decrease
+     * between calls.
+     */
+    void record(std::int64_t now_ms);
+
+    /**
+     * Get the number of events within the given window.
+     *
+     * @param window The window to query.
+     * @param now_ms The current time in milliseconds.
+     * @return The number of events recorded within the window.
+     */
+    std::uint64_t getCount(RateWindow window, std::int64_t now_ms);
+
+    /**
+     * Get the average event rate within the given window.
+     *
+     * @param window The window to query.
+     * @param now_ms The current time in milliseconds.
+     * @return The average number of events per second.
+     */
+    double getRate(RateWindow window, std::int64_t now_ms);
+
+    void reset();
+
+private:
+    static constexpr std::int64_t SHORT_WINDOW = 1;
+    static constexpr std::int64_t MEDIUM_WINDOW = 30;
+    static constexpr std::int64_t LONG_WINDOW =
+        static_cast<std::int64_t>(WHEEL_SIZE);
+
+    std::uint32_t& bucket(std::int64_t second);
+    void advance(std::int64_t now_ms);
+
+    std::array<std::uint32_t, WHEEL_SIZE> buckets_;
+    std::int64_t current_second_;
+    std::uint64_t short_total_;
+    std::uint64_t medium_total_;
+    std::uint64_t long_total_;
+};
+
+} // namespace PresenceApp
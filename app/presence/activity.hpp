@@ -0,0 +1,26 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <string>
+
+namespace PresenceApp {
+
+/**
+ * Backend-neutral description of a rich presence activity.
+ *
+ * This only holds the fields the app fills in; sinks convert it to their
+ * own representation when it is submitted.
+ */
+struct PresenceActivity {
+    std::string details_;
+    std::string state_;
+    std::string large_image_;
+    std::string large_text_;
+    std::string small_image_;
+    std::string small_text_;
+
+    bool operator==(const PresenceActivity& other) const = default;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,87 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/discord-sink.hpp"
+
+#include <QtCore/QDebug>
+#include <QtCore/QString>
+
+#include <memory>
+#include <utility>
+
+#include "discord-game-sdk/discord.h"
+
+#include "appdata/appid.hpp"
+#include "presence/activity.hpp"
+
+namespace PresenceApp {
+
+DiscordSink::DiscordSink()
+    : core_{}
+{
+    discord::Core* core = nullptr;
+    auto result = discord::Core::Create(
+        appid, DiscordCreateFlags_Default, &core);
+    core_.reset(core);
+    if (!core_) {
+        qCritical() << "Failed to create discord core (error code"
+            << static_cast<int>(result) << ")";
+        return;
+    }
+    core_->SetLogHook(discord::LogLevel::Debug,
+        [](discord::LogLevel level, const char* message) {
+            qDebug() << "Discord: " << static_cast<int>(level) << ": "
+                << message;
+        });
+}
+
+QString DiscordSink::getName() const {
+    return NAME;
+}
+
+void DiscordSink::updateActivity(
+    const PresenceActivity& activity,
+    Callback callback
+) {
+    if (!core_) {
+        callback(-1);
+        return;
+    }
+    core_->ActivityManager().UpdateActivity(toDiscordActivity(activity),
+        [callback = std::move(callback)](discord::Result result) {
+            callback(result == discord::Result::Ok ? 0 : -1);
+        });
+}
+
+void DiscordSink::clearActivity(Callback callback) {
+    if (!core_) {
+        callback(-1);
+        return;
+    }
+    core_->ActivityManager().ClearActivity(
+        [callback = std::move(callback)](discord::Result result) {
+            callback(result == discord::Result::Ok ? 0 : -1);
+        });
+}
+
+void DiscordSink::runCallbacks() {
+    if (core_) {
+        core_->RunCallbacks();
+    }
+}
+
+discord::Activity DiscordSink::toDiscordActivity(
+    const PresenceActivity& activity
+) {
+    discord::Activity result{};
+    result.SetType(discord::ActivityType::Playing);
+    result.SetDetails(activity.details_.c_str());
+    result.SetState(activity.state_.c_str());
+    auto& assets = result.GetAssets();
+    assets.SetLargeImage(activity.large_image_.c_str());
+    assets.SetLargeText(activity.large_text_.c_str());
+    assets.SetSmallImage(activity.small_image_.c_str());
+    assets.SetSmallText(activity.small_text_.c_str());
+    return result;
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,41 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include <memory>
+
+#include "discord-game-sdk/discord.h"
+
+#include "presence/activity.hpp"
+#include "presence/sink.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Submits activities to the local Discord client via the Game SDK.
+ *
+ * If the SDK fails to initialise, e.g. because Discord is not running,
+ * all requests fail immediately.
+ */
+class DiscordSink: public PresenceSink {
+public:
+    static constexpr const char* NAME = "discord";
+
+    DiscordSink();
+
+    QString getName() const override;
+    void updateActivity(const PresenceActivity& activity,
+        Callback callback) override;
+    void clearActivity(Callback callback) override;
+    void runCallbacks() override;
+
+    static discord::Activity toDiscordActivity(
+        const PresenceActivity& activity);
+
+private:
+    std::unique_ptr<discord::Core> core_;
+};
+
+} // namespace PresenceApp
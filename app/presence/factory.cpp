@@ -2,36 +2,86 @@
 
 #include "presence/factory.hpp"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QObject>
+#include <QtCore/QString>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 
-#include "discord-game-sdk/discord.h"
 #include "ps2.hpp"
 
 #include "appdata/assets.hpp"
+#include "cache/reference-data.hpp"
+#include "cache/tlru-cache.hpp"
 #include "game/state.hpp"
+#include "presence/activity.hpp"
 
 namespace PresenceApp {
 PresenceFactory::PresenceFactory(QObject* parent)
     : QObject{ parent }
     , is_idle_{ true }
+    , reference_data_{ nullptr }
+    , activities_{ ACTIVITY_CACHE_CAPACITY, ACTIVITY_TTL }
+    , activity_cache_hits_{ 0 }
+    , activity_cache_misses_{ 0 }
 {
     // Emit initial idle activity
     setActivityIdle();
     emit activityChanged(getPresenceAsActivity());
 }
 
-discord::Activity PresenceFactory::getPresenceAsActivity() {
-    discord::Activity activity{};
-    if (is_idle_) {
-        activity = buildIdleActivity();
-    }
-    else {
-        activity = buildGameActivity(state_);
+PresenceActivity PresenceFactory::getPresenceAsActivity() {
+    auto key = is_idle_ ? IDLE_ACTIVITY_KEY : getActivityKey(state_);
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    const auto* cached = activities_.find(key, now);
+    if (cached != nullptr) {
+        ++activity_cache_hits_;
+        return *cached;
     }
+    ++activity_cache_misses_;
+    auto activity = is_idle_
+        ? buildIdleActivity() : buildGameActivity(state_);
+    activities_.insert(key, activity, now);
     return activity;
 }
 
+void PresenceFactory::setReferenceData(ReferenceDataCache* cache) {
+    reference_data_ = cache;
+    invalidateActivities();
+}
+
+std::uint64_t PresenceFactory::getActivityKey(const GameState& state) {
+    // The character ID is not shown, so any character in the same
+    // situation shares the activity
+    auto narrow = [](auto value) {
+        return static_cast<std::uint64_t>(value) & 0xFF;
+    };
+    auto wide = [](auto value) {
+        return static_cast<std::uint64_t>(value) & 0xFFFF;
+    };
+    return narrow(state.faction_)
+        | narrow(state.team_) << 8
+        | narrow(state.server_) << 16
+        | narrow(state.class_) << 24
+        | wide(state.vehicle_) << 32
+        | wide(state.zone_) << 48;
+}
+
+quint64 PresenceFactory::getActivityCacheHits() const {
+    return activity_cache_hits_;
+}
+
+quint64 PresenceFactory::getActivityCacheMisses() const {
+    return activity_cache_misses_;
+}
+
+void PresenceFactory::invalidateActivities() {
+    activities_.clear();
+}
+
 void PresenceFactory::setActivityIdle() {
     if (!is_idle_) {
         is_idle_ = true;
@@ -47,61 +97,73 @@ void PresenceFactory::setActivityFromGameState(const GameState& state) {
     }
 }
 
-discord::Activity PresenceFactory::buildIdleActivity() {
-    discord::Activity activity{};
-    activity.SetState("Idling");
-    activity.SetType(discord::ActivityType::Playing);
-    auto& assets = activity.GetAssets();
-    std::string temp;
-    assets::imageKeyFromZone(ps2::Zone::Sanctuary, &temp);
-    assets.SetLargeImage(temp.c_str());
+PresenceActivity PresenceFactory::buildIdleActivity() {
+    PresenceActivity activity{};
+    activity.state_ = "Idling";
+    assets::imageKeyFromZone(ps2::Zone::Sanctuary, &activity.large_image_);
     // TODO: Tidy up asset/text pair generation
-    assets.SetLargeText("Sanctuary");
+    activity.large_text_ = "Sanctuary";
     return activity;
 }
 
-discord::Activity PresenceFactory::buildGameActivity(const GameState& state) {
-    discord::Activity activity{};
-    std::string temp;
+PresenceActivity PresenceFactory::buildGameActivity(const GameState& state) {
+    PresenceActivity activity{};
     // Details
-    ps2::faction_to_display_name(state.faction_, &temp);
-    QString details;
+    auto faction_name = getDisplayName(ReferenceKind::Faction,
+        ps2::faction_to_faction_id(state.faction_),
+        ps2::faction_to_display_name(state.faction_));
     if (state.faction_ == state.team_) {
-        details = QString::fromStdString(temp);
+        activity.details_ = std::move(faction_name);
     }
     else {
-        ps2::faction_to_display_name(state.team_, &temp);
-        details = "Freelancing for " + QString::fromStdString(temp);
+        auto team_name = getDisplayName(ReferenceKind::Faction,
+            ps2::faction_to_faction_id(state.team_),
+            ps2::faction_to_display_name(state.team_));
+        activity.details_ = "Freelancing for " + team_name;
     }
-    activity.SetDetails(details.toStdString().c_str());
     // State
-    ps2::server_to_display_name(state.server_, &temp);
-    activity.SetState(temp.c_str());
-    auto& assets = activity.GetAssets();
+    activity.state_ = getDisplayName(ReferenceKind::World,
+        ps2::server_to_world_id(state.server_),
+        ps2::server_to_display_name(state.server_));
     // Large image
-    assets::imageKeyFromZone(state.zone_, &temp);
-    assets.SetLargeImage(temp.c_str());
-    ps2::zone_to_display_name(state.zone_, &temp);
-    assets.SetLargeText(temp.c_str());
+    assets::imageKeyFromZone(state.zone_, &activity.large_image_);
+    auto zone_index = static_cast<std::size_t>(state.zone_);
+    if (zone_index < ps2::ZONE_COUNT) {
+        activity.large_text_ = getDisplayName(ReferenceKind::Zone,
+            ps2::ZONE_TABLE[zone_index].zone_ids[0],
+            ps2::zone_to_display_name(state.zone_));
+    }
     // Small image
-    std::string key, text;
-    if (state.vehicle_ != ps2::Vehicle::None) {
-        assets::imageKeyFromVehicle(state.vehicle_, &temp);
-        key = temp;
-        ps2::vehicle_to_display_name(state.vehicle_, &temp);
-        text = temp;
+    auto vehicle_index = static_cast<std::size_t>(state.vehicle_);
+    if (state.vehicle_ != ps2::Vehicle::None
+        && vehicle_index < ps2::VEHICLE_COUNT) {
+        assets::imageKeyFromVehicle(state.vehicle_, &activity.small_image_);
+        activity.small_text_ = getDisplayName(ReferenceKind::Vehicle,
+            ps2::VEHICLE_TABLE[vehicle_index].vehicle_ids[0],
+            ps2::vehicle_to_display_name(state.vehicle_));
     }
     else {
-        assets::imageKeyFromClass(state.class_, &temp);
-        key = temp;
-        ps2::class_to_display_name(state.class_, &temp);
-        text = temp;
+        assets::imageKeyFromClass(state.class_, &activity.small_image_);
+        ps2::class_to_display_name(state.class_, &activity.small_text_);
     }
-    assets.SetSmallImage(key.c_str());
-    assets.SetSmallText(text.c_str());
     return activity;
 }
 
+std::string PresenceFactory::getDisplayName(
+    ReferenceKind kind,
+    qint64 id,
+    std::string_view fallback
+) {
+    if (reference_data_ == nullptr) {
+        return std::string(fallback);
+    }
+    // Never blocks; misses are resolved in the background and trigger a
+    // presence refresh once available.
+    return reference_data_->getName(kind, id,
+        QString::fromUtf8(fallback.data(),
+            static_cast<qsizetype>(fallback.size()))).toStdString();
+}
+
 } // namespace PresenceApp
 
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -5,16 +5,33 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
-#include "discord-game-sdk/discord.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
 
+#include "cache/reference-data.hpp"
+#include "cache/tlru-cache.hpp"
 #include "game/state.hpp"
+#include "presence/activity.hpp"
 
 namespace PresenceApp {
 
+/**
+ * Builds presence activities from the game state.
+ *
+ * Built activities are memoised by game state, so flapping between a few
+ * states (e.g. entering and leaving a vehicle) does not repeat the
+ * display name lookups and string conversions.
+ */
 class PresenceFactory: public QObject {
     Q_OBJECT
 
 public:
+    /** Maximum number of memoised activities. */
+    static constexpr std::size_t ACTIVITY_CACHE_CAPACITY = 64;
+    /** Time in milliseconds after which a memoised activity is rebuilt. */
+    static constexpr std::int64_t ACTIVITY_TTL = 10 * 60 * 1000;
+
     explicit PresenceFactory(QObject* parent = nullptr);
     PresenceFactory(const PresenceFactory& other) = delete;
     PresenceFactory(PresenceFactory&& other) noexcept = delete;
@@ -22,21 +39,53 @@ public:
     PresenceFactory& operator=(const PresenceFactory& other) = delete;
     PresenceFactory& operator=(PresenceFactory&& other) noexcept = delete;
 
-    discord::Activity getPresenceAsActivity();
+    PresenceActivity getPresenceAsActivity();
+
+    /**
+     * Use the given cache for display names, falling back to the static
+     * game data for records it has not resolved yet.
+     *
+     * @param cache The reference data cache; must outlive the factory.
+     */
+    void setReferenceData(ReferenceDataCache* cache);
+
+    /**
+     * Get the memoisation key of the activity for a game state.
+     *
+     * Only the parts of the state shown in the activity are included.
+     */
+    static std::uint64_t getActivityKey(const GameState& state);
+
+    quint64 getActivityCacheHits() const;
+    quint64 getActivityCacheMisses() const;
 
 Q_SIGNALS:
-    void activityChanged(discord::Activity activity);
+    void activityChanged(const PresenceActivity& activity);
 
 public Q_SLOTS:
     void setActivityFromGameState(const GameState& state);
     void setActivityIdle();
 
+    /**
+     * Drop all memoised activities, e.g. because display names changed.
+     */
+    void invalidateActivities();
+
 private:
-    discord::Activity buildIdleActivity();
-    discord::Activity buildGameActivity(const GameState& state);
+    /** Key of the idle activity; never produced by getActivityKey(). */
+    static constexpr std::uint64_t IDLE_ACTIVITY_KEY = ~std::uint64_t{ 0 };
+
+    PresenceActivity buildIdleActivity();
+    PresenceActivity buildGameActivity(const GameState& state);
+    std::string getDisplayName(ReferenceKind kind, qint64 id,
+        std::string_view fallback);
 
     GameState state_;
     bool is_idle_;
+    ReferenceDataCache* reference_data_;
+    TlruCache<std::uint64_t, PresenceActivity> activities_;
+    quint64 activity_cache_hits_;
+    quint64 activity_cache_misses_;
 };
 
 } // namespace PresenceApp
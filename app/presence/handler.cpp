@@ -3,48 +3,128 @@
 #include "presence/handler.hpp"
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
 
-#include "discord-game-sdk/discord.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
 
-#include "appdata/appid.hpp"
+#include "metrics/rate-meter.hpp"
+#include "presence/activity.hpp"
+#include "presence/sink.hpp"
 
 namespace PresenceApp {
 
-PresenceHandler::PresenceHandler(QObject* parent)
+PresenceHandler::PresenceHandler(
+    std::unique_ptr<PresenceSink> sink,
+    QObject* parent
+)
     : QObject{ parent }
+    , sink_{ std::move(sink) }
+    , last_activity_{}
+    , has_last_activity_{ false }
+    , submission_{ 0 }
+    , suppressed_count_{ 0 }
+    , pending_callbacks_{ 0 }
+    , clock_{}
+    , fast_until_{ FAST_PUMP_LINGER }
+    , wakeup_count_{ 0 }
+    , wakeups_{}
 {
-    // Create discord core
-    auto result = discord::Core::Create(appid, DiscordCreateFlags_Default, &discord_core_);
-    if (!discord_core_) {
-        qCritical() << "Failed to create discord core (error code" << static_cast<int>(result) << ")";
+    clock_.start();
+    qDebug() << "Submitting activities to" << sink_->getName() << "sink";
+
+    // Create the callback pump; fast at first while the sink connects
+    timer_ = new QTimer(this);
+    QObject::connect(timer_, &QTimer::timeout,
+        this, &PresenceHandler::onPumpTimerExpired);
+    if (sink_->needsPolling()) {
+        timer_->start(FAST_PUMP_INTERVAL);
     }
+}
 
-    // Configure logging
-    discord_core_->SetLogHook(
-        discord::LogLevel::Debug, [](discord::LogLevel level, const char* message) { qDebug() << "Discord: " << static_cast<int>(level) << ": " << message; });
+PresenceSink* PresenceHandler::getSink() const {
+    return sink_.get();
+}
 
-    // Create presence update timer
-    timer_ = new QTimer(this);
-    timer_->setInterval(16); // ~60 FPS
-    QObject::connect(timer_, &QTimer::timeout, [this]() { discord_core_->RunCallbacks(); });
-    timer_->start();
+quint64 PresenceHandler::getSuppressedCount() const {
+    return suppressed_count_;
+}
+
+quint64 PresenceHandler::getWakeupCount() const {
+    return wakeup_count_;
+}
+
+double PresenceHandler::getWakeupRate(RateWindow window) {
+    return wakeups_.getRate(window, clock_.elapsed());
+}
+
+int PresenceHandler::getPumpInterval() const {
+    return timer_->isActive() ? timer_->interval() : 0;
+}
+
+void PresenceHandler::wake() {
+    if (!sink_->needsPolling()) {
+        return;
+    }
+    fast_until_ = clock_.elapsed() + FAST_PUMP_LINGER;
+    if (timer_->interval() > FAST_PUMP_INTERVAL) {
+        timer_->start(FAST_PUMP_INTERVAL);
+    }
+}
+
+void PresenceHandler::onPumpTimerExpired() {
+    auto now = clock_.elapsed();
+    ++wakeup_count_;
+    wakeups_.record(now);
+    sink_->runCallbacks();
+    if (pending_callbacks_ > 0 || now < fast_until_) {
+        return;
+    }
+    // Back off gradually; more work often follows shortly after
+    auto interval = std::min(timer_->interval() * 2, IDLE_PUMP_INTERVAL);
+    if (interval != timer_->interval()) {
+        timer_->setInterval(interval);
+    }
 }
 
 void PresenceHandler::clearActivity() {
-    discord_core_->ActivityManager().ClearActivity(
-        [](discord::Result result) { qDebug() << ((result == discord::Result::Ok) ? "Succeeded" : "Failed")
-        << "clearing activity!"; });
+    has_last_activity_ = false;
+    ++submission_;
+    ++pending_callbacks_;
+    wake();
+    sink_->clearActivity([this](int status) {
+        --pending_callbacks_;
+        qDebug() << (status == 0 ? "Succeeded" : "Failed")
+            << "clearing activity!";
+    });
 }
 
-void PresenceHandler::setActivity(discord::Activity activity) {
-    discord_core_->ActivityManager().UpdateActivity(activity,
-        [](discord::Result result) {
-            qDebug()
-                << ((result == discord::Result::Ok) ? "Succeeded" : "Failed")
-                << "updating activity!"; });
+bool PresenceHandler::setActivity(const PresenceActivity& activity) {
+    if (has_last_activity_ && activity == last_activity_) {
+        ++suppressed_count_;
+        qDebug() << "Activity unchanged, skipping update";
+        return false;
+    }
+    last_activity_ = activity;
+    has_last_activity_ = true;
+    auto submission = ++submission_;
+    ++pending_callbacks_;
+    wake();
+    sink_->updateActivity(activity, [this, submission](int status) {
+        --pending_callbacks_;
+        qDebug() << (status == 0 ? "Succeeded" : "Failed")
+            << "updating activity!";
+        // Allow resubmitting the activity unless a newer one is pending
+        if (status != 0 && submission == submission_) {
+            has_last_activity_ = false;
+        }
+    });
+    return true;
 }
 
 } // namespace PresenceApp
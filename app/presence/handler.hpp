@@ -2,33 +2,109 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 
-#include "discord-game-sdk/discord.h"
+#include <cstdint>
+#include <memory>
+
+#include "metrics/rate-meter.hpp"
+#include "presence/activity.hpp"
+#include "presence/sink.hpp"
 
 namespace PresenceApp {
 
+/**
+ * Submits activities to a presence sink, usually the Discord client.
+ *
+ * Sinks like the Discord SDK only make progress when their callbacks are
+ * run. The handler pumps them quickly while requests are outstanding and
+ * shortly after any activity, and backs off to a slow idle interval
+ * otherwise to keep the process from waking up needlessly. Sinks that
+ * complete requests from the event loop are not pumped at all.
+ */
 class PresenceHandler: public QObject {
     Q_OBJECT
 
 public:
-    static constexpr qint16 PRESENCE_UPDATE_RATE_LIMIT = 15000;
+    /** Pump interval while callbacks are outstanding, ~60 FPS. */
+    static constexpr int FAST_PUMP_INTERVAL = 16;
+    /** Pump interval once nothing has happened for a while. */
+    static constexpr int IDLE_PUMP_INTERVAL = 1000;
+    /** Time the fast interval is kept after the last activity. */
+    static constexpr std::int64_t FAST_PUMP_LINGER = 1000;
 
-    explicit PresenceHandler(QObject* parent = nullptr);
+    /**
+     * @param sink The sink to submit activities to; must not be null.
+     * @param parent The parent object.
+     */
+    explicit PresenceHandler(std::unique_ptr<PresenceSink> sink,
+        QObject* parent = nullptr);
     PresenceHandler(const PresenceHandler& other) = delete;
     PresenceHandler(PresenceHandler&& other) noexcept = delete;
 
     PresenceHandler& operator=(const PresenceHandler& other) = delete;
     PresenceHandler& operator=(PresenceHandler&& other) noexcept = delete;
 
+    PresenceSink* getSink() const;
+
+    /** Number of activity updates skipped as identical to the last one. */
+    quint64 getSuppressedCount() const;
+
+    /** Number of times the sink callbacks were pumped. */
+    quint64 getWakeupCount() const;
+
+    /**
+     * Get the average number of callback pumps per second.
+     *
+     * @param window The window to average over.
+     */
+    double getWakeupRate(RateWindow window);
+
+    /**
+     * Current interval between callback pumps in milliseconds, or 0 if the
+     * sink does not need polling.
+     */
+    int getPumpInterval() const;
+
 public Q_SLOTS:
     void clearActivity();
-    void setActivity(discord::Activity activity);
+
+    /**
+     * Switch to fast callback pumping for a short while, e.g. because the
+     * game state changed and an activity update is likely to follow.
+     */
+    void wake();
+
+    /**
+     * Submit an activity to the sink.
+     *
+     * Activities identical to the last one submitted are dropped, unless
+     * that submission failed or the activity was cleared since.
+     *
+     * @return Whether the activity was passed on to the sink.
+     */
+    bool setActivity(const PresenceActivity& activity);
+
+private Q_SLOTS:
+    void onPumpTimerExpired();
 
 private:
-    discord::Core* discord_core_;
+    std::unique_ptr<PresenceSink> sink_;
     QTimer* timer_;
+    PresenceActivity last_activity_;
+    bool has_last_activity_;
+    /** Incremented per submission; lets callbacks detect newer ones. */
+    quint64 submission_;
+    quint64 suppressed_count_;
+    /** Number of sink requests awaiting a result. */
+    int pending_callbacks_;
+    QElapsedTimer clock_;
+    /** Time on clock_ until which the fast interval is kept. */
+    std::int64_t fast_until_;
+    quint64 wakeup_count_;
+    RateMeter wakeups_;
 };
 
 } // namespace PresenceApp
@@ -0,0 +1,48 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/ipc-frame.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace PresenceApp {
+
+QByteArray encodeIpcFrame(IpcOpcode opcode, const QByteArray& payload) {
+    QByteArray frame(IPC_HEADER_SIZE + payload.size(), Qt::Uninitialized);
+    auto* data = reinterpret_cast<uchar*>(frame.data());
+    qToLittleEndian(static_cast<std::uint32_t>(opcode), data);
+    qToLittleEndian(static_cast<std::uint32_t>(payload.size()), data + 4);
+    std::copy(payload.cbegin(), payload.cend(),
+        frame.begin() + IPC_HEADER_SIZE);
+    return frame;
+}
+
+int decodeIpcFrame(
+    QByteArray* buffer,
+    IpcOpcode* opcode,
+    QByteArray* payload
+) {
+    if (buffer->size() < IPC_HEADER_SIZE) {
+        return 0;
+    }
+    const auto* data = reinterpret_cast<const uchar*>(buffer->constData());
+    auto raw_opcode = qFromLittleEndian<std::uint32_t>(data);
+    auto length = qFromLittleEndian<std::uint32_t>(data + 4);
+    if (raw_opcode > static_cast<std::uint32_t>(IpcOpcode::Pong)
+        || length > static_cast<std::uint32_t>(IPC_MAX_PAYLOAD_SIZE)) {
+        return -1;
+    }
+    auto size = static_cast<qsizetype>(length);
+    if (buffer->size() < IPC_HEADER_SIZE + size) {
+        return 0;
+    }
+    *opcode = static_cast<IpcOpcode>(raw_opcode);
+    *payload = buffer->mid(IPC_HEADER_SIZE, size);
+    buffer->remove(0, IPC_HEADER_SIZE + size);
+    return 1;
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,51 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+
+#include <cstdint>
+
+namespace PresenceApp {
+
+/**
+ * Opcodes of the Discord RPC IPC protocol.
+ */
+enum class IpcOpcode: std::uint32_t {
+    Handshake = 0,
+    Frame = 1,
+    Close = 2,
+    Ping = 3,
+    Pong = 4,
+};
+
+/** Size of the opcode and length header preceding each payload. */
+inline constexpr qsizetype IPC_HEADER_SIZE = 8;
+/** Largest payload accepted; Discord uses the same limit. */
+inline constexpr qsizetype IPC_MAX_PAYLOAD_SIZE = 64 * 1024;
+
+/**
+ * Encode a frame of the Discord IPC protocol.
+ *
+ * Frames consist of the opcode and payload length as little endian 32-bit
+ * integers, followed by the JSON payload.
+ *
+ * @param opcode The opcode of the frame.
+ * @param payload The JSON payload.
+ * @return The encoded frame.
+ */
+QByteArray encodeIpcFrame(IpcOpcode opcode, const QByteArray& payload);
+
+/**
+ * Take the first complete frame off a receive buffer.
+ *
+ * @param buffer The bytes received so far; the frame is removed from it.
+ * @param opcode Receives the opcode of the frame.
+ * @param payload Receives the payload of the frame.
+ * @return 1 if a frame was decoded, 0 if the buffer does not contain a
+ * complete frame yet, -1 if the frame is malformed.
+ */
+int decodeIpcFrame(QByteArray* buffer, IpcOpcode* opcode,
+    QByteArray* payload);
+
+} // namespace PresenceApp
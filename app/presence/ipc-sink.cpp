@@ -0,0 +1,354 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/ipc-sink.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalSocket>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "appdata/appid.hpp"
+#include "presence/activity.hpp"
+#include "presence/ipc-frame.hpp"
+
+namespace {
+
+/** Version of the IPC protocol sent with the handshake. */
+constexpr int IPC_VERSION = 1;
+
+void insertIfSet(QJsonObject* object, const char* key,
+    const std::string& value
+) {
+    // Discord rejects empty strings, omitted fields are fine
+    if (!value.empty()) {
+        object->insert(key, QString::fromStdString(value));
+    }
+}
+
+} // namespace
+
+namespace PresenceApp {
+
+IpcSink::IpcSink()
+    : socket_{}
+    , reconnect_timer_{}
+    , response_timer_{}
+    , socket_names_{ getSocketNames() }
+    , socket_index_{ 0 }
+    , buffer_{}
+    , connected_{ false }
+    , ready_{ false }
+    , queued_{}
+    , in_flight_{}
+    , in_flight_nonce_{}
+    , nonce_{ 0 }
+    , coalesced_count_{ 0 }
+{
+    QObject::connect(&socket_, &QLocalSocket::connected,
+        &socket_, [this]() { onConnected(); });
+    QObject::connect(&socket_, &QLocalSocket::disconnected,
+        &socket_, [this]() { onDisconnected(); });
+    QObject::connect(&socket_, &QLocalSocket::errorOccurred,
+        &socket_, [this](QLocalSocket::LocalSocketError) {
+            // Errors on established connections end in disconnected()
+            if (!connected_) {
+                onConnectionFailed();
+            }
+        });
+    QObject::connect(&socket_, &QLocalSocket::readyRead,
+        &socket_, [this]() { onReadyRead(); });
+    reconnect_timer_.setSingleShot(true);
+    QObject::connect(&reconnect_timer_, &QTimer::timeout,
+        &reconnect_timer_, [this]() { connectNext(); });
+    response_timer_.setSingleShot(true);
+    QObject::connect(&response_timer_, &QTimer::timeout,
+        &response_timer_, [this]() { onResponseTimeout(); });
+    reconnect_timer_.start(0);
+}
+
+IpcSink::~IpcSink() {
+    // Aborting emits signals whose handlers use already destroyed members
+    socket_.disconnect();
+    socket_.abort();
+}
+
+QString IpcSink::getName() const {
+    return NAME;
+}
+
+void IpcSink::updateActivity(
+    const PresenceActivity& activity,
+    Callback callback
+) {
+    enqueue(false, activity, std::move(callback));
+}
+
+void IpcSink::clearActivity(Callback callback) {
+    enqueue(true, PresenceActivity{}, std::move(callback));
+}
+
+void IpcSink::runCallbacks() {}
+
+bool IpcSink::needsPolling() const {
+    return false;
+}
+
+bool IpcSink::isReady() const {
+    return ready_;
+}
+
+quint64 IpcSink::getCoalescedCount() const {
+    return coalesced_count_;
+}
+
+QStringList IpcSink::getSocketNames() {
+    QStringList names;
+#if defined(Q_OS_WIN)
+    // Qt maps plain names to \\.\pipe\<name>
+    QString prefix = "discord-ipc-";
+#else
+    QString directory = "/tmp";
+    // Same lookup order as the Discord client
+    for (const char* variable :
+        { "XDG_RUNTIME_DIR", "TMPDIR", "TMP", "TEMP" }) {
+        auto value = qEnvironmentVariable(variable);
+        if (!value.isEmpty()) {
+            directory = value;
+            break;
+        }
+    }
+    QString prefix = directory + "/discord-ipc-";
+#endif
+    for (int i = 0; i < SOCKET_COUNT; ++i) {
+        names.append(prefix + QString::number(i));
+    }
+    return names;
+}
+
+QByteArray IpcSink::buildSetActivity(
+    const PresenceActivity* activity,
+    qint64 pid,
+    const QString& nonce
+) {
+    QJsonObject args;
+    args["pid"] = pid;
+    if (activity != nullptr) {
+        QJsonObject assets;
+        insertIfSet(&assets, "large_image", activity->large_image_);
+        insertIfSet(&assets, "large_text", activity->large_text_);
+        insertIfSet(&assets, "small_image", activity->small_image_);
+        insertIfSet(&assets, "small_text", activity->small_text_);
+        QJsonObject object;
+        insertIfSet(&object, "details", activity->details_);
+        insertIfSet(&object, "state", activity->state_);
+        if (!assets.isEmpty()) {
+            object["assets"] = assets;
+        }
+        object["instance"] = false;
+        args["activity"] = object;
+    }
+    QJsonObject command;
+    command["cmd"] = "SET_ACTIVITY";
+    command["args"] = args;
+    command["nonce"] = nonce;
+    return QJsonDocument(command).toJson(QJsonDocument::Compact);
+}
+
+void IpcSink::enqueue(
+    bool clear,
+    const PresenceActivity& activity,
+    Callback callback
+) {
+    if (queued_) {
+        // Only the latest activity matters; merge into the queued command
+        ++coalesced_count_;
+        queued_->clear_ = clear;
+        queued_->activity_ = activity;
+    }
+    else {
+        queued_ = Request{ clear, activity, {} };
+    }
+    if (!ready_) {
+        // Keep the activity for when Discord shows up, but do not leave
+        // the caller waiting for it
+        callback(-1);
+        return;
+    }
+    queued_->callbacks_.push_back(std::move(callback));
+    sendQueued();
+}
+
+void IpcSink::sendQueued() {
+    if (!ready_ || in_flight_ || !queued_) {
+        return;
+    }
+    in_flight_ = std::move(queued_);
+    queued_.reset();
+    in_flight_nonce_ = QString::number(++nonce_);
+    write(IpcOpcode::Frame, buildSetActivity(
+        in_flight_->clear_ ? nullptr : &in_flight_->activity_,
+        QCoreApplication::applicationPid(), in_flight_nonce_));
+    response_timer_.start(RESPONSE_TIMEOUT);
+}
+
+void IpcSink::failInFlight() {
+    if (!in_flight_) {
+        return;
+    }
+    response_timer_.stop();
+    auto callbacks = std::move(in_flight_->callbacks_);
+    // The command may not have been applied; send it again after
+    // reconnecting unless a newer one replaces it anyway
+    if (!queued_) {
+        queued_ = Request{ in_flight_->clear_,
+            std::move(in_flight_->activity_), {} };
+    }
+    in_flight_.reset();
+    for (auto& callback : callbacks) {
+        callback(-1);
+    }
+}
+
+void IpcSink::onResponseTimeout() {
+    qWarning() << "Discord did not answer within" << RESPONSE_TIMEOUT
+        << "ms, reconnecting";
+    failInFlight();
+    socket_.abort();
+}
+
+void IpcSink::connectNext() {
+    socket_.connectToServer(socket_names_[socket_index_++]);
+}
+
+void IpcSink::onConnected() {
+    connected_ = true;
+    buffer_.clear();
+    QJsonObject handshake;
+    handshake["v"] = IPC_VERSION;
+    handshake["client_id"] = QString::number(appid);
+    write(IpcOpcode::Handshake,
+        QJsonDocument(handshake).toJson(QJsonDocument::Compact));
+    // A client that never becomes ready is as useless as no client
+    response_timer_.start(RESPONSE_TIMEOUT);
+}
+
+void IpcSink::onDisconnected() {
+    if (ready_) {
+        qWarning() << "Lost connection to Discord";
+    }
+    connected_ = false;
+    ready_ = false;
+    failInFlight();
+    // Requests merged into the queued command while connected would
+    // otherwise wait for the reconnect
+    if (queued_) {
+        auto callbacks = std::move(queued_->callbacks_);
+        queued_->callbacks_.clear();
+        for (auto& callback : callbacks) {
+            callback(-1);
+        }
+    }
+    socket_index_ = 0;
+    reconnect_timer_.start(RECONNECT_INTERVAL);
+}
+
+void IpcSink::onConnectionFailed() {
+    // Try the next socket right away, then wait for Discord to start
+    if (socket_index_ < socket_names_.size()) {
+        reconnect_timer_.start(0);
+        return;
+    }
+    socket_index_ = 0;
+    reconnect_timer_.start(RECONNECT_INTERVAL);
+}
+
+void IpcSink::onReadyRead() {
+    buffer_.append(socket_.readAll());
+    IpcOpcode opcode{};
+    QByteArray payload;
+    while (true) {
+        auto status = decodeIpcFrame(&buffer_, &opcode, &payload);
+        if (status == 0) {
+            return;
+        }
+        if (status < 0) {
+            qWarning() << "Malformed frame from Discord, reconnecting";
+            socket_.abort();
+            return;
+        }
+        handleFrame(opcode, payload);
+        if (!connected_) {
+            return;
+        }
+    }
+}
+
+void IpcSink::handleFrame(IpcOpcode opcode, const QByteArray& payload) {
+    switch (opcode) {
+    case IpcOpcode::Frame:
+        handleMessage(QJsonDocument::fromJson(payload).object());
+        break;
+    case IpcOpcode::Ping:
+        write(IpcOpcode::Pong, payload);
+        break;
+    case IpcOpcode::Close: {
+        auto message = QJsonDocument::fromJson(payload).object();
+        qWarning() << "Discord closed the connection:"
+            << message["code"].toInt() << message["message"].toString();
+        socket_.disconnectFromServer();
+        break;
+    }
+    case IpcOpcode::Handshake:
+    case IpcOpcode::Pong:
+        break;
+    }
+}
+
+void IpcSink::handleMessage(const QJsonObject& message) {
+    auto command = message["cmd"].toString();
+    auto event = message["evt"].toString();
+    if (command == "DISPATCH" && event == "READY") {
+        qDebug() << "Connected to Discord via" << socket_.serverName();
+        ready_ = true;
+        response_timer_.stop();
+        sendQueued();
+        return;
+    }
+    if (!in_flight_ || message["nonce"].toString() != in_flight_nonce_) {
+        return;
+    }
+    auto status = 0;
+    if (event == "ERROR") {
+        auto data = message["data"].toObject();
+        qWarning() << "Discord rejected activity:" << data["code"].toInt()
+            << data["message"].toString();
+        status = -1;
+    }
+    // Callbacks may enqueue again, so finish this request first
+    response_timer_.stop();
+    auto callbacks = std::move(in_flight_->callbacks_);
+    in_flight_.reset();
+    for (auto& callback : callbacks) {
+        callback(status);
+    }
+    sendQueued();
+}
+
+void IpcSink::write(IpcOpcode opcode, const QByteArray& payload) {
+    // Buffered by the socket; never blocks the event loop
+    socket_.write(encodeIpcFrame(opcode, payload));
+}
+
+} // namespace PresenceApp
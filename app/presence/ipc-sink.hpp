@@ -0,0 +1,115 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalSocket>
+
+#include <optional>
+#include <vector>
+
+#include "presence/activity.hpp"
+#include "presence/ipc-frame.hpp"
+#include "presence/sink.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Submits activities to the local Discord client over its RPC IPC socket.
+ *
+ * This speaks the IPC protocol directly instead of going through the Game
+ * SDK, so it works on any platform Qt supports local sockets on and needs
+ * no polling; responses are handled from the event loop.
+ *
+ * Only one SET_ACTIVITY command is in flight at a time. Requests made in
+ * the meantime are coalesced into a single queued command carrying the
+ * latest activity; all of their callbacks receive its result. Commands
+ * or handshakes left unanswered for RESPONSE_TIMEOUT fail and force a
+ * reconnect.
+ *
+ * While Discord is unavailable, requests fail right away, but the latest
+ * activity is kept and sent once the sink has reconnected.
+ */
+class IpcSink: public PresenceSink {
+public:
+    static constexpr const char* NAME = "ipc";
+    /** Interval in milliseconds between connection attempts. */
+    static constexpr int RECONNECT_INTERVAL = 5000;
+    /** Number of numbered IPC sockets the Discord client may listen on. */
+    static constexpr int SOCKET_COUNT = 10;
+    /** Time in milliseconds to wait for the response to a command. */
+    static constexpr int RESPONSE_TIMEOUT = 10000;
+
+    IpcSink();
+    ~IpcSink() override;
+
+    QString getName() const override;
+    void updateActivity(const PresenceActivity& activity,
+        Callback callback) override;
+    void clearActivity(Callback callback) override;
+    void runCallbacks() override;
+    bool needsPolling() const override;
+
+    /** Whether the handshake with the Discord client has completed. */
+    bool isReady() const;
+
+    /** Number of requests merged into a later one before being sent. */
+    quint64 getCoalescedCount() const;
+
+    /**
+     * Get the names of the sockets the Discord client may listen on, in
+     * the order they are tried.
+     */
+    static QStringList getSocketNames();
+
+    /**
+     * Build the payload of a SET_ACTIVITY command.
+     *
+     * @param activity The activity to set, or nullptr to clear it.
+     * @param pid The ID of the process the activity belongs to.
+     * @param nonce The nonce identifying the response.
+     */
+    static QByteArray buildSetActivity(const PresenceActivity* activity,
+        qint64 pid, const QString& nonce);
+
+private:
+    struct Request {
+        bool clear_;
+        PresenceActivity activity_;
+        std::vector<Callback> callbacks_;
+    };
+
+    void enqueue(bool clear, const PresenceActivity& activity,
+        Callback callback);
+    void sendQueued();
+    void failInFlight();
+    void onResponseTimeout();
+    void connectNext();
+    void onConnected();
+    void onDisconnected();
+    void onConnectionFailed();
+    void onReadyRead();
+    void handleFrame(IpcOpcode opcode, const QByteArray& payload);
+    void handleMessage(const QJsonObject& message);
+    void write(IpcOpcode opcode, const QByteArray& payload);
+
+    QLocalSocket socket_;
+    QTimer reconnect_timer_;
+    QTimer response_timer_;
+    QStringList socket_names_;
+    qsizetype socket_index_;
+    QByteArray buffer_;
+    bool connected_;
+    bool ready_;
+    std::optional<Request> queued_;
+    std::optional<Request> in_flight_;
+    QString in_flight_nonce_;
+    quint64 nonce_;
+    quint64 coalesced_count_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,99 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/recording-sink.hpp"
+
+#include <QtCore/QDebug>
+#include <QtCore/QString>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "metrics/pipeline-metrics.hpp"
+#include "metrics/rate-meter.hpp"
+#include "presence/activity.hpp"
+
+namespace PresenceApp {
+
+RecordingSink::RecordingSink()
+    : created_{ PipelineClock::now() }
+    , records_{}
+    , pending_{}
+    , update_count_{ 0 }
+    , clear_count_{ 0 }
+    , requests_{}
+{}
+
+QString RecordingSink::getName() const {
+    return NAME;
+}
+
+void RecordingSink::updateActivity(
+    const PresenceActivity& activity,
+    Callback callback
+) {
+    ++update_count_;
+    record(activity, false);
+    pending_.push_back(std::move(callback));
+}
+
+void RecordingSink::clearActivity(Callback callback) {
+    ++clear_count_;
+    record(PresenceActivity{}, true);
+    pending_.push_back(std::move(callback));
+}
+
+void RecordingSink::runCallbacks() {
+    // Callbacks may submit again; those are completed on the next run
+    auto pending = std::move(pending_);
+    pending_.clear();
+    for (auto& callback : pending) {
+        callback(0);
+    }
+}
+
+const std::deque<RecordedActivity>& RecordingSink::getRecords() const {
+    return records_;
+}
+
+std::uint64_t RecordingSink::getUpdateCount() const {
+    return update_count_;
+}
+
+std::uint64_t RecordingSink::getClearCount() const {
+    return clear_count_;
+}
+
+double RecordingSink::getRequestRate(RateWindow window) {
+    return requests_.getRate(window, getElapsedMs(PipelineClock::now()));
+}
+
+void RecordingSink::record(const PresenceActivity& activity, bool cleared) {
+    auto now = PipelineClock::now();
+    requests_.record(getElapsedMs(now));
+    if (records_.size() >= MAX_RECORDS) {
+        records_.pop_front();
+    }
+    records_.push_back(RecordedActivity{ activity, now, cleared });
+    if (cleared) {
+        qDebug() << "Recorded activity clear at" << getElapsedMs(now)
+            << "ms";
+        return;
+    }
+    qDebug() << "Recorded activity at" << getElapsedMs(now) << "ms:"
+        << QString::fromStdString(activity.details_) << "|"
+        << QString::fromStdString(activity.state_) << "|"
+        << QString::fromStdString(activity.large_text_) << "|"
+        << QString::fromStdString(activity.small_text_);
+}
+
+std::int64_t RecordingSink::getElapsedMs(
+    PipelineClock::time_point now
+) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - created_).count();
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,77 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "metrics/pipeline-metrics.hpp"
+#include "metrics/rate-meter.hpp"
+#include "presence/activity.hpp"
+#include "presence/sink.hpp"
+
+namespace PresenceApp {
+
+/**
+ * A request received by RecordingSink.
+ */
+struct RecordedActivity {
+    PresenceActivity activity_;
+    /** When the request was made. */
+    PipelineClock::time_point submitted_;
+    /** Whether this was a clearActivity() request. */
+    bool cleared_;
+};
+
+/**
+ * In-process stand-in for Discord that records all submitted activities.
+ *
+ * Requests always succeed. Like the SDK, their callbacks are deferred to
+ * the next runCallbacks(), so the handler behaves as it would with a
+ * Discord client attached. Timestamps use the pipeline clock and can be
+ * compared to the frame timestamps in PipelineMetrics.
+ */
+class RecordingSink: public PresenceSink {
+public:
+    static constexpr const char* NAME = "recording";
+    /** Maximum number of records kept; older ones are dropped. */
+    static constexpr std::size_t MAX_RECORDS = 4096;
+
+    RecordingSink();
+
+    QString getName() const override;
+    void updateActivity(const PresenceActivity& activity,
+        Callback callback) override;
+    void clearActivity(Callback callback) override;
+    void runCallbacks() override;
+
+    /** The most recent requests, oldest first. */
+    const std::deque<RecordedActivity>& getRecords() const;
+
+    std::uint64_t getUpdateCount() const;
+    std::uint64_t getClearCount() const;
+
+    /**
+     * Get the average number of requests per second.
+     *
+     * @param window The window to average over.
+     */
+    double getRequestRate(RateWindow window);
+
+private:
+    void record(const PresenceActivity& activity, bool cleared);
+    std::int64_t getElapsedMs(PipelineClock::time_point now) const;
+
+    PipelineClock::time_point created_;
+    std::deque<RecordedActivity> records_;
+    std::vector<Callback> pending_;
+    std::uint64_t update_count_;
+    std::uint64_t clear_count_;
+    RateMeter requests_;
+};
+
+} // namespace PresenceApp
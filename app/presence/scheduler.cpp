@@ -0,0 +1,210 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/scheduler.hpp"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "ps2.hpp"
+
+#include "game/state.hpp"
+#include "presence/token-bucket.hpp"
+
+namespace PresenceApp {
+
+PresenceScheduler::PresenceScheduler(QObject* parent)
+    : QObject{ parent }
+    , timer_{ new QTimer(this) }
+    , clock_{}
+    , bucket_{ BUCKET_CAPACITY, BUCKET_REFILL_INTERVAL }
+    , latest_state_{}
+    , has_latest_state_{ false }
+    , submitted_state_{}
+    , has_submitted_state_{ false }
+    , state_priority_{ UpdatePriority::None }
+    , forced_priority_{ UpdatePriority::None }
+    , pending_since_{ 0 }
+    , changed_at_{ 0 }
+    , throttled_{ false }
+    , request_count_{ 0 }
+    , submitted_count_{ 0 }
+    , coalesced_count_{ 0 }
+    , dropped_count_{ 0 }
+    , throttled_count_{ 0 }
+{
+    clock_.start();
+    timer_->setSingleShot(true);
+    QObject::connect(timer_, &QTimer::timeout,
+        this, &PresenceScheduler::onTimerExpired);
+}
+
+UpdatePriority PresenceScheduler::classifyChange(
+    const GameState& from,
+    const GameState& to
+) {
+    if (from.faction_ != to.faction_ || from.team_ != to.team_
+        || from.server_ != to.server_ || from.zone_ != to.zone_) {
+        return UpdatePriority::High;
+    }
+    if (from.vehicle_ != to.vehicle_) {
+        return UpdatePriority::Medium;
+    }
+    // The class is only shown while on foot
+    if (from.class_ != to.class_ && to.vehicle_ == ps2::Vehicle::None) {
+        return UpdatePriority::Low;
+    }
+    return UpdatePriority::None;
+}
+
+UpdatePriority PresenceScheduler::getPendingPriority() const {
+    return std::max(state_priority_, forced_priority_);
+}
+
+quint64 PresenceScheduler::getRequestCount() const {
+    return request_count_;
+}
+
+quint64 PresenceScheduler::getSubmittedCount() const {
+    return submitted_count_;
+}
+
+quint64 PresenceScheduler::getCoalescedCount() const {
+    return coalesced_count_;
+}
+
+quint64 PresenceScheduler::getDroppedCount() const {
+    return dropped_count_;
+}
+
+quint64 PresenceScheduler::getThrottledCount() const {
+    return throttled_count_;
+}
+
+void PresenceScheduler::cancelSubmission() {
+    if (submitted_count_ == 0) {
+        return;
+    }
+    --submitted_count_;
+    bucket_.refund(clock_.elapsed());
+}
+
+void PresenceScheduler::requestUpdate(const GameState& state) {
+    ++request_count_;
+    auto was_pending = getPendingPriority() != UpdatePriority::None;
+    latest_state_ = state;
+    has_latest_state_ = true;
+    state_priority_ = has_submitted_state_
+        ? classifyChange(submitted_state_, state) : UpdatePriority::High;
+    if (state_priority_ == UpdatePriority::None) {
+        // Back to what is shown already, e.g. after a transient flip
+        if (was_pending && forced_priority_ == UpdatePriority::None) {
+            ++dropped_count_;
+        }
+        schedule();
+        return;
+    }
+    auto now = clock_.elapsed();
+    if (was_pending) {
+        ++coalesced_count_;
+    }
+    else {
+        pending_since_ = now;
+    }
+    // The new state has to persist for its own dwell time
+    changed_at_ = now;
+    schedule();
+}
+
+void PresenceScheduler::requestUpdate(UpdatePriority priority) {
+    ++request_count_;
+    if (priority == UpdatePriority::None) {
+        return;
+    }
+    if (getPendingPriority() != UpdatePriority::None) {
+        ++coalesced_count_;
+    }
+    else {
+        pending_since_ = clock_.elapsed();
+        changed_at_ = pending_since_;
+    }
+    forced_priority_ = std::max(forced_priority_, priority);
+    schedule();
+}
+
+void PresenceScheduler::onTimerExpired() {
+    schedule();
+}
+
+std::int64_t PresenceScheduler::getDwellTime(UpdatePriority priority) {
+    switch (priority) {
+    case UpdatePriority::High:
+        return HIGH_PRIORITY_DWELL;
+    case UpdatePriority::Medium:
+        return MEDIUM_PRIORITY_DWELL;
+    case UpdatePriority::Low:
+    case UpdatePriority::None:
+    default:
+        return LOW_PRIORITY_DWELL;
+    }
+}
+
+void PresenceScheduler::schedule() {
+    auto priority = getPendingPriority();
+    if (priority == UpdatePriority::None) {
+        timer_->stop();
+        throttled_ = false;
+        return;
+    }
+    auto now = clock_.elapsed();
+    auto due = std::min(changed_at_ + getDwellTime(priority),
+        pending_since_ + MAX_DWELL_DELAY);
+    auto dwell_wait = due - now;
+    auto reserve = priority == UpdatePriority::Low
+        ? LOW_PRIORITY_RESERVE : std::int64_t{ 0 };
+    auto budget_wait = bucket_.getWaitTime(now, reserve);
+    if (dwell_wait <= 0 && budget_wait == 0) {
+        bucket_.take(now, reserve);
+        submit();
+        return;
+    }
+    if (budget_wait > dwell_wait && !throttled_) {
+        throttled_ = true;
+        ++throttled_count_;
+    }
+    timer_->start(static_cast<int>(std::max(dwell_wait, budget_wait)));
+}
+
+void PresenceScheduler::submit() {
+    if (has_latest_state_) {
+        submitted_state_ = latest_state_;
+        has_submitted_state_ = true;
+    }
+    state_priority_ = UpdatePriority::None;
+    forced_priority_ = UpdatePriority::None;
+    throttled_ = false;
+    ++submitted_count_;
+    timer_->stop();
+    emit updateDue();
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_scheduler.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
@@ -0,0 +1,156 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <cstdint>
+
+#include "game/state.hpp"
+#include "presence/token-bucket.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Importance of a pending presence update, lowest first.
+ */
+enum class UpdatePriority {
+    None,   // Nothing shown in the presence changed
+    Low,    // Class changed, or display names were resolved
+    Medium, // Vehicle changed
+    High,   // Zone, team, faction or server changed
+};
+
+/**
+ * Decides when game state changes are submitted as presence updates.
+ *
+ * Updates are rate limited by a token bucket sized so that no 20 second
+ * window sees more than the five updates Discord allows. Changes must
+ * persist for a minimum dwell time that grows as their priority falls,
+ * so transient flips such as a single event reporting a different
+ * loadout are dropped instead of using up the budget. Low priority
+ * updates also leave one token in reserve for more important ones.
+ *
+ * All changes made while an update is pending are coalesced into it.
+ */
+class PresenceScheduler: public QObject {
+    Q_OBJECT
+
+public:
+    /** Number of updates Discord accepts per window. */
+    static constexpr std::int64_t DISCORD_UPDATE_LIMIT = 5;
+    /** Length of Discord's rate limit window in milliseconds. */
+    static constexpr std::int64_t DISCORD_UPDATE_WINDOW = 20000;
+    /**
+     * Burst size of the bucket. A full burst plus the tokens regained
+     * within one window stays within DISCORD_UPDATE_LIMIT.
+     */
+    static constexpr std::int64_t BUCKET_CAPACITY = 3;
+    /** Time in milliseconds to regain one token. */
+    static constexpr std::int64_t BUCKET_REFILL_INTERVAL =
+        DISCORD_UPDATE_WINDOW / (DISCORD_UPDATE_LIMIT - BUCKET_CAPACITY);
+    /** Tokens low priority updates leave for more important ones. */
+    static constexpr std::int64_t LOW_PRIORITY_RESERVE = 1;
+    /** Minimum dwell times in milliseconds, by priority. */
+    static constexpr std::int64_t HIGH_PRIORITY_DWELL = 0;
+    static constexpr std::int64_t MEDIUM_PRIORITY_DWELL = 2000;
+    static constexpr std::int64_t LOW_PRIORITY_DWELL = 5000;
+    /** Longest time an update is held back by dwell times. */
+    static constexpr std::int64_t MAX_DWELL_DELAY = 30000;
+
+    explicit PresenceScheduler(QObject* parent = nullptr);
+    PresenceScheduler(const PresenceScheduler& other) = delete;
+    PresenceScheduler(PresenceScheduler&& other) noexcept = delete;
+
+    PresenceScheduler& operator=(const PresenceScheduler& other) = delete;
+    PresenceScheduler& operator=(PresenceScheduler&& other) noexcept =
+        delete;
+
+    /**
+     * Classify the change between two game states by the most important
+     * part of the presence it affects.
+     */
+    static UpdatePriority classifyChange(const GameState& from,
+        const GameState& to);
+
+    /** Priority of the pending update, or None if there is none. */
+    UpdatePriority getPendingPriority() const;
+
+    /** Number of update requests received. */
+    quint64 getRequestCount() const;
+
+    /** Number of updates submitted. */
+    quint64 getSubmittedCount() const;
+
+    /** Number of requests merged into an already pending update. */
+    quint64 getCoalescedCount() const;
+
+    /**
+     * Number of pending updates dropped because the state reverted to the
+     * last submitted one before they were due.
+     */
+    quint64 getDroppedCount() const;
+
+    /** Number of updates delayed by the rate limit rather than dwell. */
+    quint64 getThrottledCount() const;
+
+    /**
+     * Report that the last update did not reach Discord, e.g. because the
+     * activity was unchanged. Its token is returned to the budget.
+     */
+    void cancelSubmission();
+
+Q_SIGNALS:
+    /** The presence should be updated now. */
+    void updateDue();
+
+public Q_SLOTS:
+    /**
+     * Request an update for a new game state.
+     *
+     * The priority is derived from the last submitted state. Reverting to
+     * that state cancels any pending update it caused.
+     */
+    void requestUpdate(const GameState& state);
+
+    /**
+     * Request an update that does not stem from a game state change, e.g.
+     * because presence was toggled or display names were resolved.
+     */
+    void requestUpdate(UpdatePriority priority);
+
+private Q_SLOTS:
+    void onTimerExpired();
+
+private:
+    static std::int64_t getDwellTime(UpdatePriority priority);
+
+    void schedule();
+    void submit();
+
+    QTimer* timer_;
+    QElapsedTimer clock_;
+    TokenBucket bucket_;
+    GameState latest_state_;
+    bool has_latest_state_;
+    GameState submitted_state_;
+    bool has_submitted_state_;
+    /** Priority of the difference between the latest and submitted state. */
+    UpdatePriority state_priority_;
+    /** Priority of pending requests not tied to a game state. */
+    UpdatePriority forced_priority_;
+    /** Time on clock_ the pending update was first requested at. */
+    std::int64_t pending_since_;
+    /** Time on clock_ of the last change to the pending update. */
+    std::int64_t changed_at_;
+    bool throttled_;
+    quint64 request_count_;
+    quint64 submitted_count_;
+    quint64 coalesced_count_;
+    quint64 dropped_count_;
+    quint64 throttled_count_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,70 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/sink.hpp"
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <memory>
+
+#include "config.hpp"
+
+#if PS2RPC_WITH_DISCORD_SDK
+#   include "presence/discord-sink.hpp"
+#endif
+#include "presence/ipc-sink.hpp"
+#include "presence/recording-sink.hpp"
+
+namespace {
+
+QString& defaultSinkName() {
+#if PS2RPC_WITH_DISCORD_SDK
+    static QString name = PresenceApp::DiscordSink::NAME;
+#else
+    static QString name = PresenceApp::IpcSink::NAME;
+#endif
+    return name;
+}
+
+} // namespace
+
+namespace PresenceApp {
+
+QStringList getPresenceSinkNames() {
+    QStringList names;
+#if PS2RPC_WITH_DISCORD_SDK
+    names.append(DiscordSink::NAME);
+#endif
+    names.append(IpcSink::NAME);
+    names.append(RecordingSink::NAME);
+    return names;
+}
+
+QString getDefaultPresenceSink() {
+    return defaultSinkName();
+}
+
+int setDefaultPresenceSink(const QString& name) {
+    if (!getPresenceSinkNames().contains(name)) {
+        return -1;
+    }
+    defaultSinkName() = name;
+    return 0;
+}
+
+std::unique_ptr<PresenceSink> createPresenceSink(const QString& name) {
+#if PS2RPC_WITH_DISCORD_SDK
+    if (name == DiscordSink::NAME) {
+        return std::make_unique<DiscordSink>();
+    }
+#endif
+    if (name == IpcSink::NAME) {
+        return std::make_unique<IpcSink>();
+    }
+    if (name == RecordingSink::NAME) {
+        return std::make_unique<RecordingSink>();
+    }
+    return nullptr;
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,81 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <functional>
+#include <memory>
+
+#include "presence/activity.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Destination for the activities submitted by PresenceHandler.
+ *
+ * Requests may complete asynchronously. Sinks that need polling invoke
+ * their callbacks from within runCallbacks(), which the handler pumps from
+ * the main thread; others invoke them from the event loop. Requests that
+ * fail up front may invoke them immediately.
+ */
+class PresenceSink {
+public:
+    /** Receives 0 if the request succeeded, -1 if it failed. */
+    using Callback = std::function<void(int status)>;
+
+    PresenceSink() = default;
+    PresenceSink(const PresenceSink& other) = delete;
+    PresenceSink(PresenceSink&& other) noexcept = delete;
+    virtual ~PresenceSink() = default;
+
+    PresenceSink& operator=(const PresenceSink& other) = delete;
+    PresenceSink& operator=(PresenceSink&& other) noexcept = delete;
+
+    /** Name the sink is selected by, see createPresenceSink(). */
+    virtual QString getName() const = 0;
+
+    virtual void updateActivity(const PresenceActivity& activity,
+        Callback callback) = 0;
+    virtual void clearActivity(Callback callback) = 0;
+
+    /** Make progress on outstanding requests and invoke their callbacks. */
+    virtual void runCallbacks() = 0;
+
+    /** Whether runCallbacks() must be called for requests to complete. */
+    virtual bool needsPolling() const {
+        return true;
+    }
+};
+
+/**
+ * Get the names of all sinks available in this build.
+ */
+QStringList getPresenceSinkNames();
+
+/**
+ * Get the name of the sink created by default.
+ *
+ * This is "discord" if the app was built with the Discord Game SDK, and
+ * "ipc" otherwise.
+ */
+QString getDefaultPresenceSink();
+
+/**
+ * Change the sink created by default, e.g. to run without Discord.
+ *
+ * @param name The name of the sink.
+ * @return 0 on success, -1 if no sink of that name is available.
+ */
+int setDefaultPresenceSink(const QString& name);
+
+/**
+ * Create a presence sink by name.
+ *
+ * @param name The name of the sink.
+ * @return The new sink, or nullptr if no sink of that name is available.
+ */
+std::unique_ptr<PresenceSink> createPresenceSink(const QString& name);
+
+} // namespace PresenceApp
@@ -0,0 +1,76 @@
+// Copyright 2022 Leonhard S.
+
+#include "presence/token-bucket.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace PresenceApp {
+
+TokenBucket::TokenBucket(std::int64_t capacity, std::int64_t refill_interval)
+    : capacity_{ std::max(capacity, std::int64_t{ 1 }) }
+    , refill_interval_{ std::max(refill_interval, std::int64_t{ 1 }) }
+    , tokens_{ capacity_ }
+    , refilled_at_{ 0 }
+    , started_{ false } {}
+
+std::int64_t TokenBucket::getTokens(std::int64_t now_ms) {
+    refill(now_ms);
+    return tokens_;
+}
+
+int TokenBucket::take(std::int64_t now_ms, std::int64_t reserve) {
+    refill(now_ms);
+    if (tokens_ <= reserve) {
+        return -1;
+    }
+    --tokens_;
+    return 0;
+}
+
+std::int64_t TokenBucket::getWaitTime(
+    std::int64_t now_ms,
+    std::int64_t reserve
+) {
+    refill(now_ms);
+    auto missing = reserve + 1 - tokens_;
+    if (missing <= 0) {
+        return 0;
+    }
+    if (reserve >= capacity_) {
+        return -1;
+    }
+    return refilled_at_ + missing * refill_interval_ - now_ms;
+}
+
+void TokenBucket::refund(std::int64_t now_ms) {
+    refill(now_ms);
+    tokens_ = std::min(tokens_ + 1, capacity_);
+}
+
+void TokenBucket::reset() {
+    tokens_ = capacity_;
+    refilled_at_ = 0;
+    started_ = false;
+}
+
+void TokenBucket::refill(std::int64_t now_ms) {
+    if (!started_) {
+        refilled_at_ = now_ms;
+        started_ = true;
+    }
+    // A full bucket is not refilling; the next token starts from now
+    if (tokens_ >= capacity_) {
+        refilled_at_ = now_ms;
+        return;
+    }
+    auto gained = (now_ms - refilled_at_) / refill_interval_;
+    if (gained <= 0) {
+        return;
+    }
+    tokens_ = std::min(tokens_ + gained, capacity_);
+    refilled_at_ = tokens_ == capacity_
+        ? now_ms : refilled_at_ + gained * refill_interval_;
+}
+
+} // namespace PresenceApp
@@ -0,0 +1,71 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstdint>
+
+namespace PresenceApp {
+
+/**
+ * Token bucket rate limiter.
+ *
+ * The bucket holds up to a fixed number of tokens and regains one every
+ * refill interval, so it allows bursts up to its capacity while limiting
+ * the long-term rate. Timestamps are caller-supplied milliseconds.
+ */
+class TokenBucket {
+public:
+    /**
+     * @param capacity Maximum number of tokens; the bucket starts full.
+     * @param refill_interval Time in milliseconds to regain one token.
+     */
+    TokenBucket(std::int64_t capacity, std::int64_t refill_interval);
+
+    /**
+     * Get the number of whole tokens available.
+     *
+     * @param now_ms The current time in milliseconds. Must not decrease
+     * between calls.
+     */
+    std::int64_t getTokens(std::int64_t now_ms);
+
+    /**
+     * Take a token, unless that would leave fewer than the given reserve.
+     *
+     * @param now_ms The current time in milliseconds.
+     * @param reserve Number of tokens that must remain afterwards.
+     * @return 0 on success, -1 if not enough tokens are available.
+     */
+    int take(std::int64_t now_ms, std::int64_t reserve = 0);
+
+    /**
+     * Get the time until take() would succeed.
+     *
+     * @param now_ms The current time in milliseconds.
+     * @param reserve Number of tokens that must remain afterwards.
+     * @return The wait time in milliseconds, 0 if a token is available,
+     * or -1 if the reserve exceeds the capacity.
+     */
+    std::int64_t getWaitTime(std::int64_t now_ms, std::int64_t reserve = 0);
+
+    /**
+     * Return a token taken for an action that turned out not to be needed.
+     *
+     * @param now_ms The current time in milliseconds.
+     */
+    void refund(std::int64_t now_ms);
+
+    void reset();
+
+private:
+    void refill(std::int64_t now_ms);
+
+    std::int64_t capacity_;
+    std::int64_t refill_interval_;
+    std::int64_t tokens_;
+    /** Time the partially refilled token started refilling at. */
+    std::int64_t refilled_at_;
+    bool started_;
+};
+
+} // namespace PresenceApp
@@ -0,0 +1,103 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4324) // Padding due to alignment specifier
+#endif
+
+namespace PresenceApp {
+
+/**
+ * Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * push() may only be called from the producer thread, pop() only from the
+ * consumer thread. All other methods are safe to call from either.
+ *
+ * @tparam T Element type; must be default constructible and movable.
+ * @tparam Capacity Maximum number of elements; must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+        "Capacity must be a power of two");
+
+public:
+    SpscRingBuffer()
+        : slots_(Capacity)
+        , head_{ 0 }
+        , tail_{ 0 } {}
+    SpscRingBuffer(const SpscRingBuffer& other) = delete;
+    SpscRingBuffer(SpscRingBuffer&& other) noexcept = delete;
+
+    SpscRingBuffer& operator=(const SpscRingBuffer& other) = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer&& other) noexcept = delete;
+
+    /**
+     * Append an element to the queue.
+     *
+     * @param value The element to append.
+     * @return true on success, false if the queue is full.
+     */
+    bool push(T value) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots_[tail & (Capacity - 1)] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest element from the queue.
+     *
+     * @param value The element to be populated.
+     * @return true on success, false if the queue is empty.
+     */
+    bool pop(T* value) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *value = std::move(slots_[head & (Capacity - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const {
+        return head_.load(std::memory_order_acquire)
+            == tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t size() const {
+        // Load the head first; the tail can only have moved further since
+        const auto head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    static constexpr std::size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    // Keep the indices on separate cache lines so producer and consumer do
+    // not invalidate each other's cache on every operation.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> slots_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_;
+};
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#endif
@@ -0,0 +1,323 @@
+// Copyright 2022 Leonhard S.
+
+#include "tracker-pool.hpp"
+
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QMetaObject>
+#include <QtCore/QMetaType>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <array>
+#include <variant>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "appdata/service-id.hpp"
+#include "ess-client.hpp"
+#include "ess-replay.hpp"
+#include "ess-supervisor.hpp"
+#include "event-queue.hpp"
+#include "game/character-info.hpp"
+#include "game/state.hpp"
+#include "tracker.hpp"
+
+namespace PresenceApp {
+
+TrackerPool::TrackerPool(QObject* parent)
+    : QObject(parent)
+    , trackers_{}
+    , event_queue_{}
+    , network_thread_{}
+    , ess_client_{ nullptr }
+    , supervisor_{ nullptr }
+    , replay_{ nullptr }
+    , replay_dropped_base_{ 0 }
+    , connection_metrics_{}
+    , pipeline_metrics_{ nullptr }
+    , displayed_character_{ 0 }
+    , connection_timer_{}
+    , ess_active_{ false }
+{
+    event_queue_.reset(new EventQueue(this));
+    QObject::connect(event_queue_.get(), &EventQueue::eventsAvailable,
+        this, &TrackerPool::onEventsAvailable, Qt::QueuedConnection);
+    // Create WebSocket client for event streaming endpoint on its own thread
+    network_thread_.reset(new QThread(this));
+    network_thread_->setObjectName("ESS network thread");
+    ess_client_ = new EssClient(SERVICE_ID);
+    ess_client_->setEventQueue(event_queue_.get());
+    supervisor_ = new EssSupervisor(ess_client_, ess_client_);
+    qRegisterMetaType<ConnectionMetrics>();
+    QObject::connect(supervisor_, &EssSupervisor::metricsChanged,
+        this, &TrackerPool::onConnectionMetricsChanged);
+    ess_client_->moveToThread(network_thread_.get());
+    QObject::connect(network_thread_.get(), &QThread::finished,
+        ess_client_, &QObject::deleteLater);
+    network_thread_->start();
+    // The connection state is only updated once per event loop iteration,
+    // so swapping out the last character does not cause a reconnect.
+    connection_timer_.reset(new QTimer(this));
+    connection_timer_->setSingleShot(true);
+    connection_timer_->setInterval(0);
+    QObject::connect(connection_timer_.get(), &QTimer::timeout,
+        this, &TrackerPool::onConnectionTimerExpired);
+}
+
+TrackerPool::~TrackerPool() {
+    network_thread_->quit();
+    network_thread_->wait();
+}
+
+bool TrackerPool::contains(arx::character_id_t character_id) const {
+    return trackers_.contains(character_id);
+}
+
+const ConnectionMetrics& TrackerPool::getConnectionMetrics() const {
+    return connection_metrics_;
+}
+
+void TrackerPool::setPipelineMetrics(PipelineMetrics* metrics) {
+    pipeline_metrics_ = metrics;
+}
+
+void TrackerPool::setDisplayedCharacter(arx::character_id_t character_id) {
+    displayed_character_ = character_id;
+}
+
+void TrackerPool::startRecording(const QString& path) {
+    QMetaObject::invokeMethod(ess_client_,
+        [client = ess_client_, path]() { client->startRecording(path); },
+        Qt::QueuedConnection);
+}
+
+void TrackerPool::setEndpointBaseUrl(const QString& base_url) {
+    QMetaObject::invokeMethod(ess_client_,
+        [client = ess_client_, base_url]() {
+            client->setEndpointBaseUrl(base_url);
+        }, Qt::QueuedConnection);
+}
+
+void TrackerPool::setConnectionDeadlines(int heartbeat, int connect) {
+    QMetaObject::invokeMethod(supervisor_,
+        [supervisor = supervisor_, heartbeat, connect]() {
+            supervisor->setDeadlines(heartbeat, connect);
+        }, Qt::QueuedConnection);
+}
+
+void TrackerPool::setReconnectBackoff(int base, int max) {
+    QMetaObject::invokeMethod(supervisor_,
+        [supervisor = supervisor_, base, max]() {
+            supervisor->setBackoff(base, max);
+        }, Qt::QueuedConnection);
+}
+
+int TrackerPool::startReplay(const QString& path, double speed) {
+    if (replay_ != nullptr) {
+        return -3;
+    }
+    auto replay = new EssReplay();
+    auto status = replay->open(path);
+    if (status != 0) {
+        delete replay;
+        return status;
+    }
+    replay->setSpeed(speed);
+    replay->setEventQueue(event_queue_.get());
+    replay_dropped_base_ = event_queue_->getDroppedCount();
+    // Stay offline so replayed frames are the only input
+    if (ess_active_) {
+        ess_active_ = false;
+        QMetaObject::invokeMethod(supervisor_, &EssSupervisor::stop,
+            Qt::QueuedConnection);
+    }
+    // Run next to the client so frames are injected without a thread hop
+    replay->moveToThread(network_thread_.get());
+    QObject::connect(replay, &EssReplay::messageReady,
+        ess_client_, &EssClient::injectMessage);
+    QObject::connect(replay, &EssReplay::finished,
+        this, &TrackerPool::onReplayFinished);
+    QObject::connect(replay, &EssReplay::finished,
+        replay, &QObject::deleteLater);
+    QObject::connect(network_thread_.get(), &QThread::finished,
+        replay, &QObject::deleteLater);
+    replay_ = replay;
+    QMetaObject::invokeMethod(replay_, &EssReplay::start,
+        Qt::QueuedConnection);
+    return 0;
+}
+
+qsizetype TrackerPool::size() const {
+    return trackers_.size();
+}
+
+int TrackerPool::getState(
+    arx::character_id_t character_id,
+    GameState* state
+) const {
+    auto it = trackers_.constFind(character_id);
+    if (it == trackers_.constEnd()) {
+        return -1;
+    }
+    *state = it->getState();
+    return 0;
+}
+
+void TrackerPool::addCharacter(const CharacterData& character) {
+    if (character.id_ == 0 || trackers_.contains(character.id_)) {
+        return;
+    }
+    trackers_.emplace(character.id_, character);
+    QMetaObject::invokeMethod(ess_client_,
+        [client = ess_client_, sub = generateSubscription(character.id_)]() {
+            client->subscribe(sub);
+        }, Qt::QueuedConnection);
+    scheduleConnectionUpdate();
+}
+
+void TrackerPool::removeCharacter(arx::character_id_t character_id) {
+    if (trackers_.remove(character_id)) {
+        QMetaObject::invokeMethod(ess_client_,
+            [client = ess_client_, sub = generateSubscription(character_id)]() {
+                client->unsubscribe(sub);
+            }, Qt::QueuedConnection);
+        scheduleConnectionUpdate();
+    }
+}
+
+void TrackerPool::clear() {
+    auto character_ids = trackers_.keys();
+    for (auto character_id : character_ids) {
+        removeCharacter(character_id);
+    }
+}
+
+void TrackerPool::onConnectionMetricsChanged(
+    const ConnectionMetrics& metrics
+) {
+    // Keep a copy; the supervisor's own metrics live on the network thread
+    connection_metrics_ = metrics;
+    emit connectionMetricsChanged(connection_metrics_);
+}
+
+void TrackerPool::onEventsAvailable() {
+    auto count = event_queue_->drain(
+        [this](const QueuedEvent& event) { handleEvent(event); },
+        MAX_EVENTS_PER_BATCH);
+    // If the batch was cut short, yield to the event loop before handling
+    // the rest so a burst of events cannot starve the GUI.
+    if (count == MAX_EVENTS_PER_BATCH && !event_queue_->isEmpty()) {
+        QMetaObject::invokeMethod(this, &TrackerPool::onEventsAvailable,
+            Qt::QueuedConnection);
+    }
+}
+
+void TrackerPool::handleEvent(const QueuedEvent& event) {
+    auto dequeued = PipelineClock::now();
+    const auto& payload = event.payload_;
+    emit payloadReceived(payload);
+    auto routed = PipelineClock::now();
+    // A payload affects at most two characters: the subject and, for
+    // deaths, the attacker.
+    std::array<const ActivityTracker*, 2> changed{};
+    changed[0] = routePayload(payload.character_id, payload);
+    if (auto death = std::get_if<arx::DeathEvent>(&payload.data)) {
+        if (death->attacker_character_id != payload.character_id) {
+            changed[1] = routePayload(death->attacker_character_id, payload);
+        }
+    }
+    // Record timings before the state changes are emitted, since those
+    // may trigger a presence update right away. Changes to other characters
+    // never reach the presence, so they must not start its latency clock.
+    if (pipeline_metrics_ != nullptr) {
+        bool state_changed = false;
+        for (auto tracker : changed) {
+            if (tracker != nullptr && tracker->getState().character_id_
+                == displayed_character_) {
+                state_changed = true;
+            }
+        }
+        pipeline_metrics_->recordEvent(event.timestamps_, dequeued,
+            routed, PipelineClock::now(), state_changed);
+    }
+    for (auto tracker : changed) {
+        if (tracker != nullptr) {
+            emit stateChanged(tracker->getState());
+        }
+    }
+}
+
+void TrackerPool::onConnectionTimerExpired() {
+    if (replay_ != nullptr) {
+        return;
+    }
+    // Only hold a connection open while there is anything to track
+    if (!ess_active_ && !trackers_.isEmpty()) {
+        ess_active_ = true;
+        QMetaObject::invokeMethod(supervisor_, &EssSupervisor::start,
+            Qt::QueuedConnection);
+    }
+    else if (ess_active_ && trackers_.isEmpty()) {
+        ess_active_ = false;
+        QMetaObject::invokeMethod(supervisor_, &EssSupervisor::stop,
+            Qt::QueuedConnection);
+    }
+}
+
+void TrackerPool::onReplayFinished(qint64 frames, qint64 elapsed_ms) {
+    // The replay deletes itself
+    replay_ = nullptr;
+    emit replayFinished(frames, elapsed_ms,
+        event_queue_->getDroppedCount() - replay_dropped_base_);
+    scheduleConnectionUpdate();
+}
+
+arx::Subscription TrackerPool::generateSubscription(
+    arx::character_id_t character_id
+) {
+    return arx::Subscription(
+        // Event names
+        { "Death", "GainExperience" },
+        // Characters
+        { QString::number(character_id).toStdString() });
+}
+
+const ActivityTracker* TrackerPool::routePayload(
+    arx::character_id_t character_id,
+    const arx::EventPayload& payload
+) {
+    auto it = trackers_.find(character_id);
+    if (it == trackers_.end() || !it->handlePayload(payload)) {
+        return nullptr;
+    }
+    return &it.value();
+}
+
+void TrackerPool::scheduleConnectionUpdate() {
+    if (!connection_timer_->isActive()) {
+        connection_timer_->start();
+    }
+}
+
+} // namespace PresenceApp
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_tracker-pool.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
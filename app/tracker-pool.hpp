@@ -0,0 +1,179 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <cstddef>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "ess-client.hpp"
+#include "ess-replay.hpp"
+#include "ess-supervisor.hpp"
+#include "event-queue.hpp"
+#include "game/character-info.hpp"
+#include "game/state.hpp"
+#include "metrics/pipeline-metrics.hpp"
+#include "tracker.hpp"
+
+namespace PresenceApp {
+
+/**
+ * Tracks any number of characters over a single ESS connection.
+ *
+ * All tracked characters share one EssClient, which merges their
+ * subscriptions and only sends the changes. Incoming payloads are routed
+ * to the ActivityTracker of every tracked character involved.
+ *
+ * The EssClient runs on a dedicated network thread, so WebSocket I/O and
+ * message decoding never block the GUI. Decoded events are handed over
+ * through an EventQueue and processed in batches of at most
+ * MAX_EVENTS_PER_BATCH per event loop iteration.
+ *
+ * Instead of connecting to the ESS, the pool can replay a frame log
+ * recorded earlier, which exercises the same pipeline without network
+ * access.
+ */
+class TrackerPool: public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t MAX_EVENTS_PER_BATCH = 256;
+
+    explicit TrackerPool(QObject* parent = nullptr);
+    TrackerPool(const TrackerPool& other) = delete;
+    TrackerPool(TrackerPool&& other) noexcept = delete;
+
+    ~TrackerPool() override;
+
+    TrackerPool& operator=(const TrackerPool& other) = delete;
+    TrackerPool& operator=(TrackerPool&& other) noexcept = delete;
+
+    bool contains(arx::character_id_t character_id) const;
+    const ConnectionMetrics& getConnectionMetrics() const;
+    qsizetype size() const;
+
+    /**
+     * Get the current game state of a tracked character.
+     *
+     * @param character_id The ID of the character.
+     * @param state The game state to be populated.
+     * @return 0 on success, -1 if the character is not tracked.
+     */
+    int getState(arx::character_id_t character_id, GameState* state) const;
+
+    /**
+     * Record the timing of every handled event into the given metrics.
+     *
+     * @param metrics The metrics to record into, or nullptr to disable.
+     * Must outlive the pool.
+     */
+    void setPipelineMetrics(PipelineMetrics* metrics);
+
+    /**
+     * Set the character whose presence is shown. Only its state changes
+     * count towards the end-to-end pipeline latency.
+     */
+    void setDisplayedCharacter(arx::character_id_t character_id);
+
+    /**
+     * Record every frame received from the ESS to a frame log.
+     *
+     * @param path The path of the frame log to create.
+     */
+    void startRecording(const QString& path);
+
+    /**
+     * Connect to a different ESS endpoint, e.g. a local load generator.
+     *
+     * @param base_url The base URL of the endpoint, without query.
+     */
+    void setEndpointBaseUrl(const QString& base_url);
+
+    /**
+     * Configure when the ESS connection is considered dead.
+     *
+     * @param heartbeat Time in milliseconds allowed between heartbeats.
+     * @param connect Time in milliseconds to establish a connection.
+     */
+    void setConnectionDeadlines(int heartbeat, int connect);
+
+    /**
+     * Configure the delays between ESS reconnect attempts.
+     *
+     * @param base Delay in milliseconds before the first retry.
+     * @param max Upper bound for the delay in milliseconds.
+     */
+    void setReconnectBackoff(int base, int max);
+
+    /**
+     * Replay a recorded frame log instead of connecting to the ESS.
+     *
+     * The pool stays offline until the replay has finished.
+     *
+     * @param path The path of the frame log to replay.
+     * @param speed The playback speed relative to the recording; zero
+     * replays as fast as possible.
+     * @return 0 on success, -1 if the file could not be opened, -2 if it
+     * is not a valid frame log, and -3 if a replay is already running.
+     */
+    int startReplay(const QString& path, double speed);
+
+Q_SIGNALS:
+    void connectionMetricsChanged(const ConnectionMetrics& metrics);
+    /**
+     * @param frames The number of frames replayed.
+     * @param elapsed_ms The wall time the replay took.
+     * @param dropped The number of events dropped because the event queue
+     * was full; non-zero results are not reproducible.
+     */
+    void replayFinished(qint64 frames, qint64 elapsed_ms, quint64 dropped);
+    void payloadReceived(const arx::EventPayload& payload);
+    void stateChanged(const GameState& state);
+
+public Q_SLOTS:
+    void addCharacter(const CharacterData& character);
+    void removeCharacter(arx::character_id_t character_id);
+    void clear();
+
+private Q_SLOTS:
+    void onConnectionMetricsChanged(const ConnectionMetrics& metrics);
+    void onEventsAvailable();
+    void onConnectionTimerExpired();
+    void onReplayFinished(qint64 frames, qint64 elapsed_ms);
+
+private:
+    static arx::Subscription generateSubscription(
+        arx::character_id_t character_id);
+    void handleEvent(const QueuedEvent& event);
+    /**
+     * Forward a payload to the tracker of the given character.
+     *
+     * @return The tracker if its game state changed, nullptr otherwise.
+     */
+    const ActivityTracker* routePayload(arx::character_id_t character_id,
+        const arx::EventPayload& payload);
+    void scheduleConnectionUpdate();
+
+    QHash<arx::character_id_t, ActivityTracker> trackers_;
+    QScopedPointer<EventQueue> event_queue_;
+    QScopedPointer<QThread> network_thread_;
+    EssClient* ess_client_; // Owned by network_thread_
+    EssSupervisor* supervisor_; // Owned by ess_client_
+    EssReplay* replay_; // Owned by network_thread_
+    quint64 replay_dropped_base_;
+    ConnectionMetrics connection_metrics_;
+    PipelineMetrics* pipeline_metrics_;
+    arx::character_id_t displayed_character_;
+    QScopedPointer<QTimer> connection_timer_;
+    bool ess_active_;
+};
+
+} // namespace PresenceApp
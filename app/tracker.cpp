@@ -3,107 +3,95 @@
 #include "tracker.hpp"
 
 #include <QtCore/QDebug>
-#include <QtCore/QList>
-#include <QtCore/QObject>
-#include <QtCore/QScopedPointer>
 #include <QtCore/QString>
-#include <QtCore/QUrl>
-#include <QtCore/QUrlQuery>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkRequest>
-#include <QtNetwork/QNetworkReply>
+
+#include <cstddef>
+#include <variant>
 
 #include "arx.hpp"
 #include "arx/ess.hpp"
 
-#include "appdata/service-id.hpp"
-#include "ess-client.hpp"
 #include "game/character-info.hpp"
 #include "game/state.hpp"
-#include "utils.hpp"
-
-namespace {
 
-template <typename T>
-T integerFromApiString(const arx::json_string_t& value) {
-    return static_cast<T>(std::strtoull(value.c_str(), nullptr, 10));
-}
+namespace PresenceApp {
 
-} // namespace
+const ActivityTracker::EventHandlerTable ActivityTracker::event_handlers_ =
+    ActivityTracker::buildEventHandlerTable();
 
-namespace PresenceApp {
+ActivityTracker::EventHandlerTable ActivityTracker::buildEventHandlerTable() {
+    EventHandlerTable table{};
+    table[static_cast<std::size_t>(arx::Event::Death)] =
+        &ActivityTracker::handleDeathPayload;
+    table[static_cast<std::size_t>(arx::Event::GainExperience)] =
+        &ActivityTracker::handleGainexperiencePayload;
+    return table;
+}
 
-ActivityTracker::ActivityTracker(
-    const CharacterData& character,
-    QObject* parent
-)
-    : QObject(parent)
-    , character_{ character }
-    , state_factory_{ character.id_, character.faction_, character.server_, character.class_ }
+ActivityTracker::ActivityTracker(const CharacterData& character)
+    : state_factory_{ character.id_, character.faction_, character.server_, character.class_ }
     , current_state_{}
-    , ess_client_{}
 {
     // Set initial state via state factory
     state_factory_.buildState(&current_state_);
-    // Create WebSocket client for event streaming endpoint
-    ess_client_.reset(new EssClient(SERVICE_ID, this));
-    auto subs = generateSubscriptions();
-    std::for_each(subs.begin(), subs.end(),
-        [this](const arx::Subscription& sub) { ess_client_->subscribe(sub); });
-    ess_client_->connect();
-    QObject::connect(ess_client_.get(), &EssClient::payloadReceived,
-        this, &ActivityTracker::onPayloadReceived);
 }
 
-CharacterData ActivityTracker::getCharacter() const {
-    return character_;
+arx::character_id_t ActivityTracker::getCharacterId() const {
+    return state_factory_.getCharacterId();
+}
+
+const GameState& ActivityTracker::getState() const {
+    return current_state_;
 }
 
-void ActivityTracker::onPayloadReceived(const QString& event_name,
-    const arx::json_t& payload) {
-    emit payloadReceived(event_name, payload);
+bool ActivityTracker::handlePayload(const arx::EventPayload& payload) {
     // Update state factory based on payload
-    if (event_name == "Death") {
-        handleDeathPayload(payload);
+    auto handler = event_handlers_[static_cast<std::size_t>(payload.event)];
+    if (handler == nullptr) {
+        qDebug() << "Ignoring payload for unhandled event:"
+            << QString::fromStdString(arx::eventToEventName(payload.event));
+        return false;
     }
-    else if (event_name == "GainExperience") {
-        handleGainexperiencePayload(payload);
-    }
-    else {
-        qDebug() << "Ignoring payload for unhandled event:" << event_name;
-        return;
+    if (!(this->*handler)(payload)) {
+        return false;
     }
     // Check if the new state is different from the old state
     GameState state;
     if (state_factory_.buildState(&state)) {
         qWarning() << "Unable to build state from factory";
-        return;
+        return false;
     }
-    if (state != current_state_) {
-        current_state_ = state;
-        emit stateChanged(state);
+    if (state == current_state_) {
+        return false;
     }
+    current_state_ = state;
+    return true;
 }
 
-void ActivityTracker::handleDeathPayload(const arx::json_t& payload) {
-    bool are_we_the_baddies = integerFromApiString<arx::character_id_t>(payload["attacker_character_id"]) == character_.id_;
+bool ActivityTracker::handleDeathPayload(const arx::EventPayload& payload) {
+    const auto death_ptr = std::get_if<arx::DeathEvent>(&payload.data);
+    if (death_ptr == nullptr) {
+        return false;
+    }
+    const auto& death = *death_ptr;
+    bool are_we_the_baddies = death.attacker_character_id == getCharacterId();
     // Team
     ps2::Faction team = state_factory_.getFaction();
     // As Team ID is a new addition, we'll check it still exists to be safe
-    if (payload.contains("team_id") && payload.contains("attacker_team_id")) {
-        arx::faction_id_t team_id = integerFromApiString<arx::faction_id_t>(
-            payload[are_we_the_baddies ? "attacker_team_id" : "team_id"]);
+    if (death.team_id && death.attacker_team_id) {
+        arx::faction_id_t team_id = are_we_the_baddies
+            ? *death.attacker_team_id : *death.team_id;
         // Return status not checked as it failing is safe as the "team"
         // variable will not be updated
         ps2::faction_from_faction_id(team_id, &team);
     }
     // Class
-    arx::loadout_id_t loadout_id = integerFromApiString<arx::loadout_id_t>(
-        payload[are_we_the_baddies ? "attacker_loadout_id" : "character_loadout_id"]);
+    arx::loadout_id_t loadout_id = are_we_the_baddies
+        ? death.attacker_loadout_id : death.character_loadout_id;
     ps2::Class class_ = state_factory_.getProfileAsClass();
     if (ps2::class_from_loadout_id(loadout_id, &class_)) {
         qWarning() << "Unable to get class from loadout ID:" << loadout_id;
-        return; // Do not update state if we cannot tell what class we are
+        return false; // Do not update state if we cannot tell what class we are
     }
     // Vehicle
 
@@ -111,18 +99,17 @@ void ActivityTracker::handleDeathPayload(const arx::json_t& payload) {
     // code will use it if it returns, but it is treated as optional.
     arx::vehicle_id_t vehicle_id = 0;
     if (are_we_the_baddies) {
-        vehicle_id = integerFromApiString<arx::vehicle_id_t>(payload["attacker_vehicle_id"]);
+        vehicle_id = death.attacker_vehicle_id;
     }
-    else if (payload.contains("vehicle_id")) {
-        vehicle_id = integerFromApiString<arx::vehicle_id_t>(payload["vehicle_id"]);
+    else if (death.vehicle_id) {
+        vehicle_id = *death.vehicle_id;
     }
     ps2::Vehicle vehicle = ps2::Vehicle::None;
     ps2::vehicle_from_vehicle_id(vehicle_id, &vehicle);
     // Zone
-    arx::zone_id_t zone_id = integerFromApiString<arx::zone_id_t>(payload["zone_id"]);
     ps2::Zone zone = state_factory_.getZone();
-    if (ps2::zone_from_zone_id(zone_id, &zone)) {
-        qWarning() << "Unable to get zone from zone ID:" << zone_id;
+    if (ps2::zone_from_zone_id(payload.zone_id, &zone)) {
+        qWarning() << "Unable to get zone from zone ID:" << payload.zone_id;
     }
     // Update state factory
     if (are_we_the_baddies && vehicle != ps2::Vehicle::None) {
@@ -133,22 +120,30 @@ void ActivityTracker::handleDeathPayload(const arx::json_t& payload) {
     }
     state_factory_.setTeam(team);
     state_factory_.setZone(zone);
+    return true;
 }
 
-void ActivityTracker::handleGainexperiencePayload(const arx::json_t& payload) {
-    bool wonders_of_modern_medicine = integerFromApiString<arx::character_id_t>(payload["character_id"]) == character_.id_;
+bool ActivityTracker::handleGainexperiencePayload(
+    const arx::EventPayload& payload
+) {
+    const auto experience =
+        std::get_if<arx::GainExperienceEvent>(&payload.data);
+    if (experience == nullptr) {
+        return false;
+    }
+    bool wonders_of_modern_medicine = payload.character_id == getCharacterId();
     if (!wonders_of_modern_medicine) {
         // The character receiving experience is not the tracked character.
         // Since we do not discriminate between experience types yet, we
         // don't really learn anything from this payload.
-        return;
+        return false;
     }
     // Class
-    arx::loadout_id_t loadout_id = integerFromApiString<arx::loadout_id_t>(payload["loadout_id"]);
     ps2::Class class_ = state_factory_.getProfileAsClass();
-    if (ps2::class_from_loadout_id(loadout_id, &class_)) {
-        qWarning() << "Unable to get class from loadout ID:" << loadout_id;
-        return; // Do not update state if we cannot tell what class we are
+    if (ps2::class_from_loadout_id(experience->loadout_id, &class_)) {
+        qWarning() << "Unable to get class from loadout ID:"
+            << experience->loadout_id;
+        return false; // Do not update state if we cannot tell what class we are
     }
 
     // TODO: We could use the experience type itself to make further
@@ -156,10 +151,9 @@ void ActivityTracker::handleGainexperiencePayload(const arx::json_t& payload) {
     // assists.
 
     // Zone
-    arx::zone_id_t zone_id = integerFromApiString<arx::zone_id_t>(payload["zone_id"]);
     ps2::Zone zone = state_factory_.getZone();
-    if (ps2::zone_from_zone_id(zone_id, &zone)) {
-        qWarning() << "Unable to get zone from zone ID:" << zone_id;
+    if (ps2::zone_from_zone_id(payload.zone_id, &zone)) {
+        qWarning() << "Unable to get zone from zone ID:" << payload.zone_id;
     }
     // Update state factory
     if (state_factory_.getProfileAsVehicle() == ps2::Vehicle::None) {
@@ -169,36 +163,7 @@ void ActivityTracker::handleGainexperiencePayload(const arx::json_t& payload) {
         state_factory_.setProfile(class_);
     }
     state_factory_.setZone(zone);
-}
-
-QList<arx::Subscription> ActivityTracker::generateSubscriptions() const {
-    auto deaths = arx::Subscription(
-        // Event names
-        { "Death" },
-        // Characters
-        { QString::number(character_.id_).toStdString() });
-    auto experience = arx::Subscription(
-        // Event names
-        { "GainExperience" },
-        // Characters
-        { QString::number(character_.id_).toStdString() });
-    return QList{ deaths, experience };
+    return true;
 }
 
 } // namespace PresenceApp
-
-#if defined(_MSC_VER) && !defined(__clang__)
-#   pragma warning(push)
-#   pragma warning(disable : 4464)
-#elif defined(__clang__)
-#   pragma clang diagnostic push
-#   pragma clang diagnostic ignored "-Wreserved-identifier"
-#endif
-
-#include "moc_tracker.cpp"
-
-#if defined(_MSC_VER) && !defined(__clang__)
-#   pragma warning(pop)
-#elif defined(__clang__)
-#   pragma clang diagnostic pop
-#endif
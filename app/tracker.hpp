@@ -2,54 +2,59 @@
 
 #pragma once
 
-#include <QtCore/QList>
-#include <QtCore/QObject>
-#include <QtCore/QScopedPointer>
-#include <QtCore/QString>
+#include <array>
 
 #include "arx.hpp"
+#include "arx/ess.hpp"
 #include "ps2.hpp"
 
-#include "ess-client.hpp"
 #include "game/character-info.hpp"
 #include "game/state.hpp"
 
 namespace PresenceApp {
 
-class ActivityTracker: public QObject {
-    Q_OBJECT
-
+/**
+ * Infers the game state of a single character from event payloads.
+ *
+ * This class does not own any network resources; payloads are routed to
+ * it by a TrackerPool. Only the state factory and the last known state
+ * are kept, so the memory footprint per tracked character is constant.
+ */
+class ActivityTracker {
 public:
-    explicit ActivityTracker(
-        const CharacterData& character,
-        QObject* parent = nullptr);
-    ActivityTracker(const ActivityTracker& other) = delete;
-    ActivityTracker(ActivityTracker&& other) noexcept = delete;
+    explicit ActivityTracker(const CharacterData& character);
+
+    arx::character_id_t getCharacterId() const;
+    const GameState& getState() const;
 
-    ActivityTracker& operator=(const ActivityTracker& other) = delete;
-    ActivityTracker& operator=(ActivityTracker&& other) noexcept = delete;
+    /**
+     * Update the tracked state from the given payload.
+     *
+     * @param payload The payload to process.
+     * @return true if the game state changed, false otherwise.
+     */
+    bool handlePayload(const arx::EventPayload& payload);
 
-    CharacterData getCharacter() const;
+private:
+    /**
+     * Handler for a specific event type.
+     *
+     * @param payload The payload to process.
+     * @return true if the state factory was updated, false otherwise.
+     */
+    using EventHandler = bool (ActivityTracker::*)(
+        const arx::EventPayload& payload);
+    using EventHandlerTable = std::array<EventHandler, arx::EVENT_COUNT>;
 
-Q_SIGNALS:
-    void ready();
-    void stateChanged(GameState state);
-    void payloadReceived(const QString& event_name,
-        const arx::json_t& payload);
+    static EventHandlerTable buildEventHandlerTable();
 
-private Q_SLOTS:
-    void onPayloadReceived(const QString& event_name,
-        const arx::json_t& payload);
+    bool handleDeathPayload(const arx::EventPayload& payload);
+    bool handleGainexperiencePayload(const arx::EventPayload& payload);
 
-private:
-    QList<arx::Subscription> generateSubscriptions() const;
-    void handleDeathPayload(const arx::json_t& payload);
-    void handleGainexperiencePayload(const arx::json_t& payload);
+    static const EventHandlerTable event_handlers_;
 
-    CharacterData character_;
     GameStateFactory state_factory_;
     GameState current_state_;
-    QScopedPointer<EssClient> ess_client_;
 };
 
 } // namespace PresenceApp
@@ -2,13 +2,14 @@
 
 #include "utils.hpp"
 
+#include <span>
 #include <string>
-#include <utility>
+#include <string_view>
 
+#include <QtCore/QByteArray>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
-#include <QtCore/QUrlQuery>
 #include <QtNetwork/QNetworkReply>
 
 #include "arx.hpp"
@@ -47,19 +48,27 @@ T quotedIntegerViaJsonKey(const arx::json_t& object,
 namespace PresenceApp {
 
 QUrl qUrlFromArxQuery(const arx::Query& query) {
-    QUrl url;
-    url.setScheme(QString::fromStdString(query.getScheme()));
-    url.setHost(QString::fromStdString(query.getHost()));
-    url.setPath(QString::fromStdString(query.getPath()));
-    auto arx_query = query.getQuery();
-    QUrlQuery q;
-    std::for_each(arx_query.begin(), arx_query.end(),
-        [&q](const std::pair<std::string, std::string>& item) {
-            q.addQueryItem(QString::fromStdString(item.first),
-            QString::fromStdString(item.second));
-        });
-    url.setQuery(q);
-    return url;
+    // Serialise the whole URL into a single buffer rather than going through
+    // QUrlQuery item by item; tolerant mode percent-encodes the Census
+    // delimiters that are not valid in a URL query
+    std::string buffer;
+    query.appendUrl(&buffer);
+    return QUrl::fromEncoded(
+        QByteArray::fromRawData(
+            buffer.data(), static_cast<qsizetype>(buffer.size())),
+        QUrl::TolerantMode);
+}
+
+QUrl qUrlFromArxQuery(
+    const arx::QueryTemplate& query_template,
+    std::span<const std::string_view> values
+) {
+    std::string buffer;
+    query_template.appendUrl(&buffer, values);
+    return QUrl::fromEncoded(
+        QByteArray::fromRawData(
+            buffer.data(), static_cast<qsizetype>(buffer.size())),
+        QUrl::TolerantMode);
 }
 
 arx::json_t getJsonPayload(const QScopedPointer<QNetworkReply>& reply) {
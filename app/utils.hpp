@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 
 #include <QtCore/QScopedPointer>
 #include <QtCore/QUrl>
@@ -15,6 +17,9 @@ namespace PresenceApp {
 
 QUrl qUrlFromArxQuery(const arx::Query& query);
 
+QUrl qUrlFromArxQuery(const arx::QueryTemplate& query_template,
+    std::span<const std::string_view> values);
+
 arx::json_t getJsonPayload(const QScopedPointer<QNetworkReply>& reply);
 
 arx::character_id_t characterIdFromJson(const arx::json_t& object);
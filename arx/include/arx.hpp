@@ -3,6 +3,7 @@
 #pragma once
 
 #include "arx/query.hpp"
+#include "arx/query-template.hpp"
 #include "arx/payload.hpp"
 #include "arx/urlgen.hpp"
 #include "arx/support.hpp"
@@ -2,7 +2,10 @@
 
 #pragma once
 
+#include "arx/ess/decoder.hpp"
 #include "arx/ess/endpoint.hpp"
 #include "arx/ess/events.hpp"
+#include "arx/ess/frame-log.hpp"
 #include "arx/ess/payload.hpp"
 #include "arx/ess/subscription.hpp"
+#include "arx/ess/subscription-set.hpp"
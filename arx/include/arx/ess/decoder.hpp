@@ -0,0 +1,80 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include "arx/ess/events.hpp"
+#include "arx/ess/payload.hpp"
+#include "arx/ps2-types.hpp"
+
+namespace arx {
+
+/**
+ * Decoded payload of a "Death" event.
+ *
+ * Team IDs and the victim's vehicle ID have been added or removed from the
+ * event stream over time and are therefore optional.
+ */
+struct DeathEvent {
+    character_id_t attacker_character_id;
+    fire_mode_id_t attacker_fire_mode_id;
+    loadout_id_t attacker_loadout_id;
+    std::optional<faction_id_t> attacker_team_id;
+    vehicle_id_t attacker_vehicle_id;
+    item_id_t attacker_weapon_id;
+    loadout_id_t character_loadout_id;
+    bool is_headshot;
+    std::optional<faction_id_t> team_id;
+    std::optional<vehicle_id_t> vehicle_id;
+};
+
+/**
+ * Decoded payload of a "GainExperience" event.
+ */
+struct GainExperienceEvent {
+    std::uint32_t amount;
+    experience_id_t experience_id;
+    loadout_id_t loadout_id;
+    character_id_t other_id;
+    std::optional<faction_id_t> team_id;
+};
+
+/**
+ * Decoded payload of an ESS service message.
+ *
+ * The common fields are populated for every event. Event-specific data is
+ * only available for events with a dedicated payload type; all other events
+ * leave the data variant empty.
+ */
+struct EventPayload {
+    Event event;
+    character_id_t character_id;
+    std::int64_t timestamp;
+    world_id_t world_id;
+    zone_id_t zone_id;
+    std::variant<std::monostate, DeathEvent, GainExperienceEvent> data;
+};
+
+/**
+ * Decode an ESS message without building a JSON document.
+ *
+ * The message is scanned once and only the keys of the payload types above
+ * are read, with their quoted integer values converted in place. Unknown
+ * keys and nested values are skipped.
+ *
+ * @param message The serialised message to decode.
+ * @param type The message type to be populated.
+ * @param payload The payload to be populated for service messages.
+ * @return 0 on success, -1 if the message is not valid JSON, and -2 if a
+ * service message does not contain a valid payload.
+ */
+int decodeMessage(
+    std::string_view message,
+    MessageType* type,
+    EventPayload* payload);
+
+} // namespace arx
@@ -15,15 +15,24 @@ enum class Environment {
     PS2PS4US
 };
 
+/**
+ * Base URL of the public ESS endpoint.
+ */
+inline constexpr const char* DEFAULT_ENDPOINT_BASE_URL =
+    "wss://push.planetside2.com/streaming";
+
 /**
  * URL generator for the ESS endpoint.
  *
  * @param service_id Service ID identifying this application to the ESS.
  * @param environment Event streaming environment to connect to.
+ * @param base_url Base URL of the endpoint, e.g. to connect to a local
+ * stand-in server instead of the public one.
  * @return URL to connect to the ESS.
  */
 string_t getEndpointUrl(
     const string_t& service_id = "s:example",
-    const Environment& environment = Environment::PS2);
+    const Environment& environment = Environment::PS2,
+    const string_t& base_url = DEFAULT_ENDPOINT_BASE_URL);
 
 } // namespace arx
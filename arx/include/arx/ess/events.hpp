@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+
 #include "arx/types.hpp"
 
 namespace arx {
@@ -26,7 +29,24 @@ enum class Event {
     VehicleDestroy,
 };
 
-Event eventFromEventName(const string_t& event_name);
+/**
+ * Number of enumerators in arx::Event, including Event::Unknown.
+ *
+ * Use this to size tables indexed by event.
+ */
+inline constexpr std::size_t EVENT_COUNT =
+    static_cast<std::size_t>(Event::VehicleDestroy) + 1;
+
+/**
+ * Resolve an ESS event name to its enum value.
+ *
+ * This uses a compile-time perfect hash of all known event names, so each
+ * lookup costs one hash and at most one string comparison.
+ *
+ * @param event_name The event name to look up.
+ * @return The matching event, or Event::Unknown if the name is not known.
+ */
+Event eventFromEventName(std::string_view event_name);
 
 string_t eventToEventName(const Event& event);
 
@@ -0,0 +1,103 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+
+#include "arx/types.hpp"
+
+namespace arx {
+
+/**
+ * A raw ESS frame along with the time it was received.
+ */
+struct RecordedFrame {
+    /**
+     * Monotonic receive time in nanoseconds, relative to the start of the
+     * recording.
+     */
+    std::int64_t timestamp_ns;
+    string_t data;
+};
+
+/**
+ * Append-only writer for recorded ESS frames.
+ *
+ * A frame log starts with an eight byte header ("ARXF" followed by the
+ * format version), followed by any number of records. Each record is the
+ * receive timestamp as a 64-bit integer, the frame size as a 32-bit
+ * integer, and the raw frame bytes. All integers are little endian.
+ */
+class FrameLogWriter {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    FrameLogWriter();
+    FrameLogWriter(const FrameLogWriter& other) = delete;
+    FrameLogWriter(FrameLogWriter&& other) noexcept = delete;
+
+    FrameLogWriter& operator=(const FrameLogWriter& other) = delete;
+    FrameLogWriter& operator=(FrameLogWriter&& other) noexcept = delete;
+
+    /**
+     * Create a new frame log, replacing any existing file.
+     *
+     * @param path The path of the file to write.
+     * @return 0 on success, -1 if the file could not be opened.
+     */
+    int open(const string_t& path);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * Append a frame to the log.
+     *
+     * @param timestamp_ns The receive time of the frame in nanoseconds.
+     * @param frame The raw frame contents.
+     * @return 0 on success, -1 if the log is not open or the write failed.
+     */
+    int append(std::int64_t timestamp_ns, std::string_view frame);
+
+private:
+    std::ofstream file_;
+};
+
+/**
+ * Sequential reader for frame logs created by FrameLogWriter.
+ */
+class FrameLogReader {
+public:
+    FrameLogReader();
+    FrameLogReader(const FrameLogReader& other) = delete;
+    FrameLogReader(FrameLogReader&& other) noexcept = delete;
+
+    FrameLogReader& operator=(const FrameLogReader& other) = delete;
+    FrameLogReader& operator=(FrameLogReader&& other) noexcept = delete;
+
+    /**
+     * Open an existing frame log and validate its header.
+     *
+     * @param path The path of the file to read.
+     * @return 0 on success, -1 if the file could not be opened, and -2 if
+     * it is not a frame log of a supported version.
+     */
+    int open(const string_t& path);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * Read the next frame from the log.
+     *
+     * @param frame The frame to be populated.
+     * @return 0 on success, 1 at the end of the log, and -1 if the record
+     * is truncated or otherwise corrupt.
+     */
+    int next(RecordedFrame* frame);
+
+private:
+    std::ifstream file_;
+};
+
+} // namespace arx
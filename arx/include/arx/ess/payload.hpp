@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "arx/types.hpp"
 
 namespace arx {
@@ -48,4 +50,42 @@ MessageType getMessageType(const json_t& message);
  */
 json_t getPayload(const json_t& message);
 
+/**
+ * Borrow the payload of the given message.
+ *
+ * This performs the same checks as getPayload(), but returns a pointer into
+ * the given message rather than a copy of the payload object. Additionally,
+ * the payload's "event_name" key is guaranteed to be a string.
+ *
+ * @param message The message to extract the payload from.
+ * @return A pointer to the payload of the given message, or nullptr if the
+ * message does not contain a valid payload. The pointer is only valid for as
+ * long as the given message is.
+ */
+const json_t* findPayload(const json_t& message);
+
+/**
+ * State of a single event server endpoint as reported by a heartbeat.
+ */
+struct EndpointStatus {
+    string_t name;
+    bool online;
+};
+
+/**
+ * Read the endpoint states listed in a heartbeat message.
+ *
+ * Heartbeats report every event server endpoint under their "online" key,
+ * e.g. "EventServerEndpoint_Connery_1": "true". Entries whose state is
+ * neither a boolean nor "true" or "false" are skipped.
+ *
+ * @param message The heartbeat message to read.
+ * @param endpoints Receives the state of each endpoint listed.
+ * @return 0 on success, -1 if the message is not a heartbeat or does not
+ * list any endpoints.
+ */
+int getEndpointStatuses(
+    const json_t& message,
+    std::vector<EndpointStatus>* endpoints);
+
 } // namespace arx
@@ -0,0 +1,94 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "arx/ess/subscription.hpp"
+#include "arx/types.hpp"
+
+namespace arx {
+
+/**
+ * Merged view of any number of ESS subscriptions.
+ *
+ * The ESS keeps a single subscription per connection, consisting of the
+ * union of all event names, characters, and worlds subscribed to. This
+ * class reference counts each of these across the added subscriptions and
+ * tracks which ones have changed since the server was last updated, so
+ * that any number of changes can be sent as a minimal set of subscribe and
+ * clearSubscribe messages.
+ *
+ * Subscriptions are counted, not deduplicated: every call to add() must
+ * eventually be matched by a call to remove() with an equal subscription.
+ */
+class SubscriptionSet {
+public:
+    /**
+     * Maximum number of characters listed in a single message. Larger
+     * changes are split across multiple messages.
+     */
+    static constexpr std::size_t MAX_CHARACTERS_PER_MESSAGE = 500;
+
+    SubscriptionSet();
+
+    void add(const Subscription& subscription);
+    void remove(const Subscription& subscription);
+
+    bool isEmpty() const;
+    bool hasPendingChanges() const;
+
+    /**
+     * Build the merged subscription covering all added subscriptions.
+     */
+    Subscription toSubscription() const;
+
+    /**
+     * Build the messages required to bring the server up to date.
+     *
+     * The returned changes are considered sent; calling this again
+     * without further changes returns an empty list.
+     *
+     * @return clearSubscribe messages for removed items followed by
+     * subscribe messages for added items.
+     */
+    std::vector<string_t> takePendingMessages();
+
+    /**
+     * Mark the server state as lost, e.g. after a disconnect.
+     *
+     * The next call to takePendingMessages() will resubscribe to the
+     * entire set.
+     */
+    void invalidate();
+
+private:
+    /**
+     * Reference counted set of keys with pending additions and removals
+     * relative to the last state sent.
+     */
+    class KeySet {
+    public:
+        void add(const string_t& key);
+        void remove(const string_t& key);
+        void invalidate();
+        void clearPending();
+
+        std::vector<string_t> getKeys() const;
+
+        std::map<string_t, std::size_t> counts_;
+        std::set<string_t> added_;
+        std::set<string_t> removed_;
+    };
+
+    KeySet event_names_;
+    KeySet characters_;
+    KeySet worlds_;
+    std::size_t logical_and_count_;
+    bool logical_and_sent_;
+};
+
+} // namespace arx
@@ -0,0 +1,110 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arx/query.hpp"
+#include "arx/support.hpp"
+
+namespace arx {
+
+/**
+ * Immutable snapshot of a query, used to send many requests that only
+ * differ in the values of their search terms.
+ *
+ * The URL is serialised once on construction and split around the search
+ * term values, so generating a URL for a new set of values only writes
+ * those values. Copies share the same state and are cheap; intern()
+ * additionally shares the state between templates of identical queries.
+ */
+class QueryTemplate {
+public:
+    explicit QueryTemplate(const Query& query);
+
+    /**
+     * Get the template for a query, sharing the state of any existing
+     * template for an identical query.
+     *
+     * Thread-safe.
+     *
+     * @param query The query to create the template from.
+     * @return A template for the query.
+     */
+    static QueryTemplate intern(const Query& query);
+
+    /** Get the query the template was created from. */
+    const Query& getQuery() const;
+
+    /** Number of search terms whose values may be substituted. */
+    std::size_t getParameterCount() const;
+
+    std::string_view getPath() const;
+
+    /** Get the URL using the search term values of the original query. */
+    std::string_view getUrl() const;
+
+    /**
+     * Get the URL with the given search term values.
+     *
+     * @param values Replacement values in the order the search terms were
+     * added to the query. Missing values default to those of the original
+     * query, surplus values are ignored. Modifiers are kept.
+     * @return The request URL.
+     */
+    std::string getUrl(std::span<const std::string_view> values) const;
+
+    /**
+     * Append the URL with the given search term values to a buffer.
+     *
+     * @see getUrl(std::span<const std::string_view>)
+     */
+    void appendUrl(
+        std::string* buffer,
+        std::span<const std::string_view> values) const;
+
+    void writeUrl(
+        UrlSink* sink,
+        std::span<const std::string_view> values) const;
+
+    /** Whether both templates share the same state. */
+    bool isSharedWith(const QueryTemplate& other) const;
+
+private:
+    struct Parameter {
+        /** Item delimiter, field name, '=' and the modifier literal. */
+        std::string prefix_;
+        std::string value_;
+    };
+
+    struct State {
+        explicit State(const Query& query);
+
+        void write(
+            UrlSink* sink,
+            std::span<const std::string_view> values) const;
+        /** Size of the URL if none of the values need escaping. */
+        std::size_t getUnescapedSize(
+            std::span<const std::string_view> values) const;
+
+        Query query_;
+        std::string path_;
+        /** Scheme, host and path. */
+        std::string head_;
+        std::vector<Parameter> parameters_;
+        /** Query commands, including their leading delimiter. */
+        std::string tail_;
+        std::string url_;
+    };
+
+    explicit QueryTemplate(std::shared_ptr<const State> state);
+
+    std::shared_ptr<const State> state_;
+};
+
+} // namespace arx
@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -43,6 +45,7 @@ struct JoinData: public SupportsJoin {
         const std::string& child_field);
 
     std::string serialise() const;
+    void write(UrlSink* sink) const;
 
     std::string collection_;
     std::string on_;
@@ -64,6 +67,7 @@ struct TreeData {
         const std::string& start = "");
 
     std::string serialise() const;
+    void write(UrlSink* sink) const;
 
     std::string field_;
     bool list_;
@@ -147,12 +151,41 @@ public:
 
     std::string getUrl() const;
 
+    /**
+     * Number of characters in the URL returned by getUrl().
+     */
+    std::size_t getUrlSize() const;
+
+    /**
+     * Append the request URL to a buffer.
+     *
+     * Reusing the same buffer across calls avoids allocations entirely
+     * once it has grown to fit the longest URL.
+     *
+     * @param buffer The buffer to append the URL to.
+     */
+    void appendUrl(std::string* buffer) const;
+
+    /**
+     * Append the query string of the request URL (without the leading
+     * '?') to a buffer.
+     *
+     * @param buffer The buffer to append the query string to.
+     */
+    void appendQueryString(std::string* buffer) const;
+
+    void writeUrl(UrlSink* sink) const;
+    void writePath(UrlSink* sink) const;
+    void writeQueryString(UrlSink* sink) const;
+
     std::string getScheme() const;
     std::string getHost() const;
     std::string getPath() const;
     std::vector<std::pair<std::string, std::string>> getQuery() const;
 
 private:
+    void writeQueryItems(UrlSink* sink, std::string_view lead) const;
+
     // Request format / path configuration
     std::string service_id_;
     std::string format_;
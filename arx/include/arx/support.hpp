@@ -2,7 +2,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -23,6 +26,98 @@ SearchModifier modifierFromData(const std::string& data);
 
 std::string serialiseModifier(SearchModifier modifier);
 
+std::string_view getModifierLiteral(SearchModifier modifier);
+
+/**
+ * Destination for the URL writers of the query types.
+ *
+ * URLs are generated in two passes over the same writer: a counting sink
+ * first measures the output, then an appending sink writes it into a
+ * buffer reserved to exactly that size. See appendWithWriter().
+ */
+class UrlSink {
+public:
+    /** Create a sink that only counts the characters written to it. */
+    UrlSink();
+    /** Create a sink appending to the given buffer. */
+    explicit UrlSink(std::string* buffer);
+
+    void put(char c);
+    void put(std::string_view text);
+    void putNumber(int value);
+    /**
+     * Write text, percent-encoding the characters that would otherwise
+     * end the query item or the URL, i.e. '%', '&', '#', '+' and spaces.
+     */
+    void putEscaped(std::string_view text);
+
+    /**
+     * Write a range of strings separated by a delimiter.
+     */
+    template <typename Range>
+    void putJoined(const Range& strings, std::string_view delimiter) {
+        putJoined(strings, delimiter,
+            [](UrlSink* sink, std::string_view str) { sink->put(str); });
+    }
+
+    /**
+     * Write a range of items separated by a delimiter.
+     *
+     * @param items The items to write.
+     * @param delimiter Written between consecutive items.
+     * @param write Callable taking this sink and an item, writing the
+     * item to the sink.
+     */
+    template <typename Range, typename Writer>
+    void putJoined(
+        const Range& items,
+        std::string_view delimiter,
+        const Writer& write
+    ) {
+        bool first = true;
+        for (const auto& item : items) {
+            if (!first) {
+                put(delimiter);
+            }
+            first = false;
+            write(this, item);
+        }
+    }
+
+    /** Total number of characters written to the sink so far. */
+    std::size_t getSize() const;
+
+private:
+    std::string* buffer_;
+    std::size_t size_;
+};
+
+/**
+ * Append the output of a URL writer to a buffer.
+ *
+ * The buffer grows at most once; if its capacity already suffices, no
+ * allocation takes place at all.
+ *
+ * @param buffer The buffer to append to.
+ * @param writer Callable taking a UrlSink pointer. It is invoked twice
+ * and must produce the same output both times.
+ */
+template <typename Writer>
+void appendWithWriter(std::string* buffer, const Writer& writer) {
+    UrlSink counter;
+    writer(&counter);
+    buffer->reserve(buffer->size() + counter.getSize());
+    UrlSink sink(buffer);
+    writer(&sink);
+}
+
+template <typename Writer>
+std::string writeToString(const Writer& writer) {
+    std::string result;
+    appendWithWriter(&result, writer);
+    return result;
+}
+
 class SearchTerm {
 public:
     SearchTerm();
@@ -35,8 +130,13 @@ public:
         const std::string& field,
         const std::string& value);
 
+    std::string getField() const;
+    std::string getValue() const;
+    SearchModifier getModifier() const;
+
     std::pair<std::string, std::string> asQueryItem() const;
     std::string serialise() const;
+    void write(UrlSink* sink) const;
 
 private:
     std::string field_;
@@ -44,8 +144,57 @@ private:
     SearchModifier modifier_;
 };
 
+/**
+ * Number of characters in the given strings joined by a delimiter.
+ */
+std::size_t getJoinedSize(
+    std::span<const std::string_view> strings,
+    std::string_view delimiter);
+
+/**
+ * Append strings separated by a delimiter to a buffer.
+ *
+ * The buffer grows at most once.
+ *
+ * @param buffer The buffer to append to.
+ * @param strings The strings to join.
+ * @param delimiter Inserted between consecutive strings.
+ */
+void joinInto(
+    std::string* buffer,
+    std::span<const std::string_view> strings,
+    std::string_view delimiter);
+
+std::string join(
+    std::span<const std::string_view> strings,
+    std::string_view delimiter);
+
 std::string join(
     const std::vector<std::string>& strings,
-    const std::string& delimiter);
+    std::string_view delimiter);
+
+/**
+ * Join the results of applying a transform to each item of a range.
+ *
+ * @param items The items to join.
+ * @param delimiter Inserted between consecutive items.
+ * @param transform Callable returning a string or string view for an
+ * item. It is called twice per item, once to size the result and once to
+ * write it, so it should be cheap and must return the same text both
+ * times.
+ */
+template <typename Range, typename Transform>
+std::string joinTransformed(
+    const Range& items,
+    std::string_view delimiter,
+    const Transform& transform
+) {
+    return writeToString([&items, delimiter, &transform](UrlSink* sink) {
+        sink->putJoined(items, delimiter,
+            [&transform](UrlSink* item_sink, const auto& item) {
+                item_sink->put(std::string_view(transform(item)));
+            });
+    });
+}
 
 } // namespace arx
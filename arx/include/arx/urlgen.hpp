@@ -3,13 +3,18 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "query.hpp"
+#include "support.hpp"
 
 namespace arx {
 
+constexpr std::string_view CENSUS_SCHEME = "https";
+constexpr std::string_view CENSUS_HOST = "census.daybreakgames.com";
+
 std::string getScheme();
 
 std::string getHost();
@@ -21,6 +26,14 @@ std::string generateCensusPath(
     const std::string& ns = "ps2",
     const std::string& collection = "");
 
+void writeCensusPath(
+    UrlSink* sink,
+    std::string_view service_id,
+    std::string_view format,
+    std::string_view verb,
+    std::string_view ns,
+    std::string_view collection);
+
 std::vector<std::pair<std::string, std::string>> getQueryItems(
     const Query* query);
 
@@ -0,0 +1,370 @@
+// Copyright 2022 Leonhard S.
+
+#include "arx/ess/decoder.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "arx/ess/events.hpp"
+#include "arx/ess/payload.hpp"
+#include "arx/types.hpp"
+
+namespace {
+
+/** Top-level message keys relevant for message type detection. */
+enum class MessageKey {
+    Other,
+    Payload,
+    Service,
+    Subscription,
+    Type,
+};
+
+/** Payload keys that are decoded; all other keys are skipped. */
+enum class PayloadKey {
+    Other,
+    // Common fields
+    EventName,
+    CharacterId,
+    Timestamp,
+    WorldId,
+    ZoneId,
+    // Death
+    AttackerCharacterId,
+    AttackerFireModeId,
+    AttackerLoadoutId,
+    AttackerTeamId,
+    AttackerVehicleId,
+    AttackerWeaponId,
+    CharacterLoadoutId,
+    IsHeadshot,
+    VehicleId,
+    // GainExperience
+    Amount,
+    ExperienceId,
+    LoadoutId,
+    OtherId,
+    // Shared by Death and GainExperience
+    TeamId,
+};
+
+constexpr std::array<std::pair<std::string_view, PayloadKey>, 19>
+PAYLOAD_KEYS{ {
+    { "event_name", PayloadKey::EventName },
+    { "character_id", PayloadKey::CharacterId },
+    { "timestamp", PayloadKey::Timestamp },
+    { "world_id", PayloadKey::WorldId },
+    { "zone_id", PayloadKey::ZoneId },
+    { "attacker_character_id", PayloadKey::AttackerCharacterId },
+    { "attacker_fire_mode_id", PayloadKey::AttackerFireModeId },
+    { "attacker_loadout_id", PayloadKey::AttackerLoadoutId },
+    { "attacker_team_id", PayloadKey::AttackerTeamId },
+    { "attacker_vehicle_id", PayloadKey::AttackerVehicleId },
+    { "attacker_weapon_id", PayloadKey::AttackerWeaponId },
+    { "character_loadout_id", PayloadKey::CharacterLoadoutId },
+    { "is_headshot", PayloadKey::IsHeadshot },
+    { "vehicle_id", PayloadKey::VehicleId },
+    { "amount", PayloadKey::Amount },
+    { "experience_id", PayloadKey::ExperienceId },
+    { "loadout_id", PayloadKey::LoadoutId },
+    { "other_id", PayloadKey::OtherId },
+    { "team_id", PayloadKey::TeamId },
+} };
+
+MessageKey messageKeyFromName(std::string_view name) {
+    if (name == "payload") {
+        return MessageKey::Payload;
+    }
+    if (name == "service") {
+        return MessageKey::Service;
+    }
+    if (name == "subscription") {
+        return MessageKey::Subscription;
+    }
+    if (name == "type") {
+        return MessageKey::Type;
+    }
+    return MessageKey::Other;
+}
+
+PayloadKey payloadKeyFromName(std::string_view name) {
+    for (const auto& [key_name, key] : PAYLOAD_KEYS) {
+        if (key_name == name) {
+            return key;
+        }
+    }
+    return PayloadKey::Other;
+}
+
+/**
+ * SAX handler collecting the message type and known payload fields.
+ *
+ * Since the ESS does not guarantee key order, the event name may only be
+ * known after the event-specific fields have been read. All candidate
+ * payload types are therefore filled in parallel and the matching one is
+ * selected once the message has been read.
+ */
+class MessageDecoder: public nlohmann::json_sax<arx::json_t> {
+public:
+    bool null() override {
+        return true;
+    }
+
+    bool boolean(bool val) override {
+        return setValue(val ? 1 : 0);
+    }
+
+    bool number_integer(number_integer_t val) override {
+        return setValue(static_cast<std::uint64_t>(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        return setValue(val);
+    }
+
+    bool number_float(number_float_t, const string_t&) override {
+        return true;
+    }
+
+    bool string(string_t& val) override {
+        if (depth_ == 1) {
+            if (message_key_ == MessageKey::Service) {
+                has_service_ = true;
+                is_event_service_ = val == "event";
+            }
+            else if (message_key_ == MessageKey::Type) {
+                if (val == "serviceMessage") {
+                    event_type_ = arx::MessageType::SERVICE_MESSAGE;
+                }
+                else if (val == "heartbeat") {
+                    event_type_ = arx::MessageType::HEARTBEAT;
+                }
+            }
+            return true;
+        }
+        if (!isPayloadValue()) {
+            return true;
+        }
+        if (payload_key_ == PayloadKey::EventName) {
+            has_event_name_ = true;
+            payload_.event = arx::eventFromEventName(val);
+            return true;
+        }
+        // The ESS sends all integer fields as quoted strings
+        std::uint64_t value = 0;
+        auto result = std::from_chars(
+            val.data(), val.data() + val.size(), value);
+        if (result.ec != std::errc()) {
+            return true; // Leave malformed fields at their default value
+        }
+        return setValue(value);
+    }
+
+    bool binary(binary_t&) override {
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        ++depth_;
+        if (depth_ == 1) {
+            is_object_ = true;
+        }
+        else if (depth_ == 2 && message_key_ == MessageKey::Payload) {
+            has_payload_ = true;
+            in_payload_ = true;
+        }
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 1) {
+            message_key_ = messageKeyFromName(val);
+            if (message_key_ == MessageKey::Subscription) {
+                has_subscription_ = true;
+            }
+        }
+        else if (depth_ == 2 && in_payload_) {
+            payload_key_ = payloadKeyFromName(val);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth_ == 2) {
+            in_payload_ = false;
+        }
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth_;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+        const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+    arx::MessageType getMessageType() const {
+        if (!is_object_) {
+            return arx::MessageType::OTHER;
+        }
+        if (is_event_service_) {
+            return event_type_;
+        }
+        if (!has_service_ && has_subscription_) {
+            return arx::MessageType::SUBSCRIPTION_ECHO;
+        }
+        return arx::MessageType::OTHER;
+    }
+
+    bool hasValidPayload() const {
+        return has_payload_ && has_event_name_;
+    }
+
+    arx::EventPayload takePayload() {
+        if (payload_.event == arx::Event::Death) {
+            payload_.data = death_;
+        }
+        else if (payload_.event == arx::Event::GainExperience) {
+            payload_.data = experience_;
+        }
+        return payload_;
+    }
+
+private:
+    bool isPayloadValue() const {
+        return in_payload_ && depth_ == 2;
+    }
+
+    bool setValue(std::uint64_t value) {
+        if (!isPayloadValue()) {
+            return true;
+        }
+        switch (payload_key_) {
+        case PayloadKey::CharacterId:
+            payload_.character_id = static_cast<arx::character_id_t>(value);
+            break;
+        case PayloadKey::Timestamp:
+            payload_.timestamp = static_cast<std::int64_t>(value);
+            break;
+        case PayloadKey::WorldId:
+            payload_.world_id = static_cast<arx::world_id_t>(value);
+            break;
+        case PayloadKey::ZoneId:
+            payload_.zone_id = static_cast<arx::zone_id_t>(value);
+            break;
+        case PayloadKey::AttackerCharacterId:
+            death_.attacker_character_id =
+                static_cast<arx::character_id_t>(value);
+            break;
+        case PayloadKey::AttackerFireModeId:
+            death_.attacker_fire_mode_id =
+                static_cast<arx::fire_mode_id_t>(value);
+            break;
+        case PayloadKey::AttackerLoadoutId:
+            death_.attacker_loadout_id = static_cast<arx::loadout_id_t>(value);
+            break;
+        case PayloadKey::AttackerTeamId:
+            death_.attacker_team_id = static_cast<arx::faction_id_t>(value);
+            break;
+        case PayloadKey::AttackerVehicleId:
+            death_.attacker_vehicle_id = static_cast<arx::vehicle_id_t>(value);
+            break;
+        case PayloadKey::AttackerWeaponId:
+            death_.attacker_weapon_id = static_cast<arx::item_id_t>(value);
+            break;
+        case PayloadKey::CharacterLoadoutId:
+            death_.character_loadout_id =
+                static_cast<arx::loadout_id_t>(value);
+            break;
+        case PayloadKey::IsHeadshot:
+            death_.is_headshot = value != 0;
+            break;
+        case PayloadKey::VehicleId:
+            death_.vehicle_id = static_cast<arx::vehicle_id_t>(value);
+            break;
+        case PayloadKey::Amount:
+            experience_.amount = static_cast<std::uint32_t>(value);
+            break;
+        case PayloadKey::ExperienceId:
+            experience_.experience_id =
+                static_cast<arx::experience_id_t>(value);
+            break;
+        case PayloadKey::LoadoutId:
+            experience_.loadout_id = static_cast<arx::loadout_id_t>(value);
+            break;
+        case PayloadKey::OtherId:
+            experience_.other_id = static_cast<arx::character_id_t>(value);
+            break;
+        case PayloadKey::TeamId:
+            death_.team_id = static_cast<arx::faction_id_t>(value);
+            experience_.team_id = static_cast<arx::faction_id_t>(value);
+            break;
+        case PayloadKey::EventName:
+        case PayloadKey::Other:
+        default:
+            break;
+        }
+        return true;
+    }
+
+    int depth_ = 0;
+    bool is_object_ = false;
+    bool in_payload_ = false;
+    MessageKey message_key_ = MessageKey::Other;
+    PayloadKey payload_key_ = PayloadKey::Other;
+
+    // Message type detection
+    bool has_service_ = false;
+    bool is_event_service_ = false;
+    bool has_subscription_ = false;
+    arx::MessageType event_type_ = arx::MessageType::OTHER;
+
+    // Payload fields
+    bool has_payload_ = false;
+    bool has_event_name_ = false;
+    arx::EventPayload payload_{};
+    arx::DeathEvent death_{};
+    arx::GainExperienceEvent experience_{};
+};
+
+} // namespace
+
+namespace arx {
+
+int decodeMessage(
+    std::string_view message,
+    MessageType* type,
+    EventPayload* payload
+) {
+    MessageDecoder decoder;
+    if (!json_t::sax_parse(
+        message.data(), message.data() + message.size(), &decoder)) {
+        *type = MessageType::OTHER;
+        return -1;
+    }
+    *type = decoder.getMessageType();
+    if (*type != MessageType::SERVICE_MESSAGE) {
+        return 0;
+    }
+    if (!decoder.hasValidPayload()) {
+        return -2;
+    }
+    *payload = decoder.takePayload();
+    return 0;
+}
+
+} // namespace arx
@@ -27,10 +27,12 @@ namespace arx {
 
 string_t getEndpointUrl(
     const string_t& service_id,
-    const Environment& environment
+    const Environment& environment,
+    const string_t& base_url
 ) {
     std::stringstream ss;
-    ss << "wss://push.planetside2.com/streaming?environment="
+    ss << base_url
+        << "?environment="
         << environmentToString(environment)
         << "&service-id="
         << service_id;
@@ -2,57 +2,111 @@
 
 #include "arx/ess/events.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
 #include "arx/types.hpp"
 
-namespace arx {
+namespace {
 
-Event eventFromEventName(const string_t& event_name) {
-    if (event_name == "AchievementEarned") {
-        return Event::AchievementEarned;
-    }
-    if (event_name == "BattleRankUp") {
-        return Event::BattleRankUp;
-    }
-    if (event_name == "ContinentLock") {
-        return Event::ContinentLock;
-    }
-    if (event_name == "ContinentUnlock") {
-        return Event::ContinentUnlock;
-    }
-    if (event_name == "Death") {
-        return Event::Death;
-    }
-    if (event_name == "FacilityControl") {
-        return Event::FacilityControl;
-    }
-    if (event_name == "GainExperience") {
-        return Event::GainExperience;
-    }
-    if (event_name == "ItemAdded") {
-        return Event::ItemAdded;
-    }
-    if (event_name == "MetagameEvent") {
-        return Event::MetagameEvent;
-    }
-    if (event_name == "PlayerFacilityCapture") {
-        return Event::PlayerFacilityCapture;
-    }
-    if (event_name == "PlayerFacilityDefend") {
-        return Event::PlayerFacilityDefend;
-    }
-    if (event_name == "PlayerLogin") {
-        return Event::PlayerLogin;
-    }
-    if (event_name == "PlayerLogout") {
-        return Event::PlayerLogout;
-    }
-    if (event_name == "SkillAdded") {
-        return Event::SkillAdded;
+using arx::Event;
+
+constexpr std::array<std::pair<std::string_view, Event>,
+    arx::EVENT_COUNT - 1> EVENT_NAMES{ {
+    { "AchievementEarned", Event::AchievementEarned },
+    { "BattleRankUp", Event::BattleRankUp },
+    { "ContinentLock", Event::ContinentLock },
+    { "ContinentUnlock", Event::ContinentUnlock },
+    { "Death", Event::Death },
+    { "FacilityControl", Event::FacilityControl },
+    { "GainExperience", Event::GainExperience },
+    { "ItemAdded", Event::ItemAdded },
+    { "MetagameEvent", Event::MetagameEvent },
+    { "PlayerFacilityCapture", Event::PlayerFacilityCapture },
+    { "PlayerFacilityDefend", Event::PlayerFacilityDefend },
+    { "PlayerLogin", Event::PlayerLogin },
+    { "PlayerLogout", Event::PlayerLogout },
+    { "SkillAdded", Event::SkillAdded },
+    { "VehicleDestroy", Event::VehicleDestroy },
+} };
+
+/** Number of slots in the hash table; must be a power of two. */
+constexpr std::size_t EVENT_TABLE_SIZE = 32;
+
+/**
+ * Map a non-empty event name to a table slot.
+ *
+ * Only the length and the first and last characters are hashed; this is
+ * enough to tell all ESS event names apart for a suitable seed and is much
+ * cheaper than hashing the entire name.
+ */
+constexpr std::size_t eventNameSlot(
+    std::string_view name,
+    std::uint32_t seed
+) {
+    auto first = static_cast<std::uint8_t>(name.front());
+    auto last = static_cast<std::uint8_t>(name.back());
+    return (name.size() + first * seed + last) & (EVENT_TABLE_SIZE - 1);
+}
+
+constexpr bool isPerfectSeed(std::uint32_t seed) {
+    std::array<bool, EVENT_TABLE_SIZE> used{};
+    for (const auto& [name, event] : EVENT_NAMES) {
+        auto slot = eventNameSlot(name, seed);
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+/**
+ * Find the first seed for which no two event names share a slot.
+ *
+ * Returns 0xFFFFFFFF if none was found within the search limit.
+ */
+constexpr std::uint32_t findPerfectSeed() {
+    for (std::uint32_t seed = 1; seed < 4096; ++seed) {
+        if (isPerfectSeed(seed)) {
+            return seed;
+        }
+    }
+    return 0xFFFFFFFF;
+}
+
+constexpr std::uint32_t EVENT_HASH_SEED = findPerfectSeed();
+static_assert(EVENT_HASH_SEED != 0xFFFFFFFF,
+    "No collision-free seed found; increase EVENT_TABLE_SIZE");
+
+using EventSlot = std::pair<std::string_view, Event>;
+
+constexpr std::array<EventSlot, EVENT_TABLE_SIZE> buildEventTable() {
+    // Empty slots hold an empty name mapped to Event::Unknown
+    std::array<EventSlot, EVENT_TABLE_SIZE> table{};
+    for (const auto& entry : EVENT_NAMES) {
+        table[eventNameSlot(entry.first, EVENT_HASH_SEED)] = entry;
     }
-    if (event_name == "VehicleDestroy") {
-        return Event::VehicleDestroy;
+    return table;
+}
+
+constexpr std::array<EventSlot, EVENT_TABLE_SIZE> EVENT_TABLE =
+    buildEventTable();
+
+} // namespace
+
+namespace arx {
+
+Event eventFromEventName(std::string_view event_name) {
+    if (event_name.empty()) {
+        return Event::Unknown;
     }
-    return Event::Unknown;
+    const auto& [name, event] =
+        EVENT_TABLE[eventNameSlot(event_name, EVENT_HASH_SEED)];
+    return name == event_name ? event : Event::Unknown;
 }
 
 string_t eventToEventName(const Event& event) {
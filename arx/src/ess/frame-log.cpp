@@ -0,0 +1,141 @@
+// Copyright 2022 Leonhard S.
+
+#include "arx/ess/frame-log.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <string_view>
+
+#include "arx/types.hpp"
+
+namespace {
+
+constexpr std::array<char, 4> FRAME_LOG_MAGIC = { 'A', 'R', 'X', 'F' };
+
+// Upper bound for a single frame; anything larger means a corrupt record.
+constexpr std::uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+template <typename T>
+void writeLittleEndian(std::ofstream& file, T value) {
+    std::array<char, sizeof(T)> bytes;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>(
+            static_cast<std::uint64_t>(value) >> (8 * i) & 0xff);
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <typename T>
+bool readLittleEndian(std::ifstream& file, T* value) {
+    std::array<unsigned char, sizeof(T)> bytes;
+    if (!file.read(reinterpret_cast<char*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size()))) {
+        return false;
+    }
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        result |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+    }
+    *value = static_cast<T>(result);
+    return true;
+}
+
+} // namespace
+
+namespace arx {
+
+FrameLogWriter::FrameLogWriter()
+    : file_{} {}
+
+int FrameLogWriter::open(const string_t& path) {
+    close();
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        return -1;
+    }
+    file_.write(FRAME_LOG_MAGIC.data(), FRAME_LOG_MAGIC.size());
+    writeLittleEndian(file_, FORMAT_VERSION);
+    if (!file_) {
+        file_.close();
+        return -1;
+    }
+    return 0;
+}
+
+void FrameLogWriter::close() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+bool FrameLogWriter::isOpen() const {
+    return file_.is_open();
+}
+
+int FrameLogWriter::append(std::int64_t timestamp_ns, std::string_view frame) {
+    if (!file_.is_open() || frame.size() > MAX_FRAME_SIZE) {
+        return -1;
+    }
+    writeLittleEndian(file_, timestamp_ns);
+    writeLittleEndian(file_, static_cast<std::uint32_t>(frame.size()));
+    file_.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    return file_ ? 0 : -1;
+}
+
+FrameLogReader::FrameLogReader()
+    : file_{} {}
+
+int FrameLogReader::open(const string_t& path) {
+    close();
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        return -1;
+    }
+    std::array<char, FRAME_LOG_MAGIC.size()> magic;
+    std::uint32_t version = 0;
+    if (!file_.read(magic.data(), magic.size()) ||
+        magic != FRAME_LOG_MAGIC ||
+        !readLittleEndian(file_, &version) ||
+        version != FrameLogWriter::FORMAT_VERSION) {
+        file_.close();
+        return -2;
+    }
+    return 0;
+}
+
+void FrameLogReader::close() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+bool FrameLogReader::isOpen() const {
+    return file_.is_open();
+}
+
+int FrameLogReader::next(RecordedFrame* frame) {
+    if (!file_.is_open()) {
+        return -1;
+    }
+    std::int64_t timestamp_ns = 0;
+    if (!readLittleEndian(file_, &timestamp_ns)) {
+        // A clean end of file may only occur between records
+        return file_.gcount() == 0 ? 1 : -1;
+    }
+    std::uint32_t size = 0;
+    if (!readLittleEndian(file_, &size) || size > MAX_FRAME_SIZE) {
+        return -1;
+    }
+    frame->timestamp_ns = timestamp_ns;
+    frame->data.resize(size);
+    if (!file_.read(frame->data.data(), static_cast<std::streamsize>(size))) {
+        return -1;
+    }
+    return 0;
+}
+
+} // namespace arx
@@ -2,16 +2,19 @@
 
 #include "arx/ess/payload.hpp"
 
+#include <string_view>
+#include <vector>
+
 #include "arx/types.hpp"
 
 namespace {
 
-arx::string_t getService(const arx::json_t& message) {
+std::string_view getService(const arx::json_t& message) {
     auto it = message.find("service");
     if (it == message.end() || !it->is_string()) {
-        return "";
+        return {};
     }
-    return it->get<arx::string_t>();
+    return it->get_ref<const arx::json_string_t&>();
 }
 
 arx::MessageType getMessageTypeEvent(const arx::json_t& message) {
@@ -19,7 +22,7 @@ arx::MessageType getMessageTypeEvent(const arx::json_t& message) {
     if (it == message.end() || !it->is_string()) {
         return arx::MessageType::OTHER; // Used by initial help message
     }
-    auto type = it->get<arx::string_t>();
+    const auto& type = it->get_ref<const arx::json_string_t&>();
     if (type == "serviceMessage") {
         return arx::MessageType::SERVICE_MESSAGE;
     }
@@ -40,7 +43,7 @@ MessageType getMessageType(const json_t& message) {
         return getMessageTypeEvent(message);
     }
     // Subscription echo
-    if (service == "") {
+    if (service.empty()) {
         // Subscriptions do not have a service specified but must have a
         // top-level "subscription" key
         if (message.find("subscription") != message.end()) {
@@ -66,4 +69,48 @@ json_t getPayload(const json_t& message) {
     return payload;
 }
 
+const json_t* findPayload(const json_t& message) {
+    if (getMessageType(message) != MessageType::SERVICE_MESSAGE) {
+        return nullptr;
+    }
+    auto it = message.find("payload");
+    if (it == message.end() || !it->is_object()) {
+        return nullptr;
+    }
+    auto event_name = it->find("event_name");
+    if (event_name == it->end() || !event_name->is_string()) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+int getEndpointStatuses(
+    const json_t& message,
+    std::vector<EndpointStatus>* endpoints
+) {
+    if (getMessageType(message) != MessageType::HEARTBEAT) {
+        return -1;
+    }
+    auto it = message.find("online");
+    if (it == message.end() || !it->is_object()) {
+        return -1;
+    }
+    endpoints->clear();
+    endpoints->reserve(it->size());
+    for (const auto& [name, value] : it->items()) {
+        if (value.is_boolean()) {
+            endpoints->push_back({ name, value.get<bool>() });
+            continue;
+        }
+        if (!value.is_string()) {
+            continue;
+        }
+        const auto& state = value.get_ref<const json_string_t&>();
+        if (state == "true" || state == "false") {
+            endpoints->push_back({ name, state == "true" });
+        }
+    }
+    return 0;
+}
+
 } // namespace arx
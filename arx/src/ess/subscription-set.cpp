@@ -0,0 +1,231 @@
+// Copyright 2022 Leonhard S.
+
+#include "arx/ess/subscription-set.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "arx/ess/subscription.hpp"
+#include "arx/types.hpp"
+
+namespace {
+
+arx::json_t messageBoilerplate(const char* action) {
+    arx::json_t data;
+    data["service"] = "event";
+    data["action"] = action;
+    return data;
+}
+
+arx::json_array_t toJsonArray(
+    std::vector<arx::string_t>::const_iterator first,
+    std::vector<arx::string_t>::const_iterator last
+) {
+    arx::json_array_t data;
+    data.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    std::copy(first, last, std::back_inserter(data));
+    return data;
+}
+
+arx::json_array_t toJsonArray(const std::vector<arx::string_t>& values) {
+    return toJsonArray(values.begin(), values.end());
+}
+
+/**
+ * Split a message into several if it lists too many characters.
+ *
+ * The first message carries all other fields; any further messages only
+ * differ in the characters listed.
+ */
+void appendChunkedMessages(
+    std::vector<arx::string_t>* messages,
+    arx::json_t data,
+    const std::vector<arx::string_t>& characters
+) {
+    constexpr auto chunk_size =
+        arx::SubscriptionSet::MAX_CHARACTERS_PER_MESSAGE;
+    if (characters.empty()) {
+        messages->push_back(data.dump());
+        return;
+    }
+    for (std::size_t offset = 0; offset < characters.size();
+        offset += chunk_size) {
+        auto first = characters.begin()
+            + static_cast<std::ptrdiff_t>(offset);
+        auto last = characters.begin() + static_cast<std::ptrdiff_t>(
+            std::min(offset + chunk_size, characters.size()));
+        data["characters"] = toJsonArray(first, last);
+        messages->push_back(data.dump());
+        // Only the first message needs to repeat the world list
+        data.erase("worlds");
+    }
+}
+
+} // namespace
+
+namespace arx {
+
+void SubscriptionSet::KeySet::add(const string_t& key) {
+    auto& count = counts_[key];
+    if (count++ > 0) {
+        return;
+    }
+    // The key is new; it is either still known to the server or needs to
+    // be sent as an addition.
+    if (removed_.erase(key) == 0) {
+        added_.insert(key);
+    }
+}
+
+void SubscriptionSet::KeySet::remove(const string_t& key) {
+    auto it = counts_.find(key);
+    if (it == counts_.end()) {
+        return;
+    }
+    if (--it->second > 0) {
+        return;
+    }
+    counts_.erase(it);
+    if (added_.erase(key) == 0) {
+        removed_.insert(key);
+    }
+}
+
+void SubscriptionSet::KeySet::invalidate() {
+    removed_.clear();
+    added_.clear();
+    std::transform(counts_.begin(), counts_.end(),
+        std::inserter(added_, added_.end()),
+        [](const auto& pair) { return pair.first; });
+}
+
+void SubscriptionSet::KeySet::clearPending() {
+    added_.clear();
+    removed_.clear();
+}
+
+std::vector<string_t> SubscriptionSet::KeySet::getKeys() const {
+    std::vector<string_t> keys;
+    keys.reserve(counts_.size());
+    std::transform(counts_.begin(), counts_.end(),
+        std::back_inserter(keys),
+        [](const auto& pair) { return pair.first; });
+    return keys;
+}
+
+SubscriptionSet::SubscriptionSet()
+    : event_names_{}
+    , characters_{}
+    , worlds_{}
+    , logical_and_count_{ 0 }
+    , logical_and_sent_{ false } {}
+
+void SubscriptionSet::add(const Subscription& subscription) {
+    for (const auto& event_name : subscription.getEventNames()) {
+        event_names_.add(event_name);
+    }
+    for (const auto& character : subscription.getCharacters()) {
+        characters_.add(character);
+    }
+    for (const auto& world : subscription.getWorlds()) {
+        worlds_.add(world);
+    }
+    if (subscription.getLogicalAndFlag()) {
+        ++logical_and_count_;
+    }
+}
+
+void SubscriptionSet::remove(const Subscription& subscription) {
+    for (const auto& event_name : subscription.getEventNames()) {
+        event_names_.remove(event_name);
+    }
+    for (const auto& character : subscription.getCharacters()) {
+        characters_.remove(character);
+    }
+    for (const auto& world : subscription.getWorlds()) {
+        worlds_.remove(world);
+    }
+    if (subscription.getLogicalAndFlag() && logical_and_count_ > 0) {
+        --logical_and_count_;
+    }
+}
+
+bool SubscriptionSet::isEmpty() const {
+    return event_names_.counts_.empty();
+}
+
+bool SubscriptionSet::hasPendingChanges() const {
+    return !event_names_.added_.empty() || !event_names_.removed_.empty() ||
+        !characters_.added_.empty() || !characters_.removed_.empty() ||
+        !worlds_.added_.empty() || !worlds_.removed_.empty() ||
+        (logical_and_count_ > 0) != logical_and_sent_;
+}
+
+Subscription SubscriptionSet::toSubscription() const {
+    return Subscription(
+        event_names_.getKeys(),
+        characters_.getKeys(),
+        worlds_.getKeys(),
+        logical_and_count_ > 0);
+}
+
+std::vector<string_t> SubscriptionSet::takePendingMessages() {
+    std::vector<string_t> messages;
+    // Removals
+    std::vector<string_t> removed_events(
+        event_names_.removed_.begin(), event_names_.removed_.end());
+    std::vector<string_t> removed_characters(
+        characters_.removed_.begin(), characters_.removed_.end());
+    std::vector<string_t> removed_worlds(
+        worlds_.removed_.begin(), worlds_.removed_.end());
+    if (!removed_events.empty() || !removed_characters.empty() ||
+        !removed_worlds.empty()) {
+        json_t data = messageBoilerplate("clearSubscribe");
+        if (!removed_events.empty()) {
+            data["eventNames"] = toJsonArray(removed_events);
+        }
+        if (!removed_worlds.empty()) {
+            data["worlds"] = toJsonArray(removed_worlds);
+        }
+        appendChunkedMessages(&messages, data, removed_characters);
+    }
+    // Additions
+    bool logical_and = logical_and_count_ > 0;
+    std::vector<string_t> added_characters(
+        characters_.added_.begin(), characters_.added_.end());
+    std::vector<string_t> added_worlds(
+        worlds_.added_.begin(), worlds_.added_.end());
+    if (!event_names_.added_.empty() || !added_characters.empty() ||
+        !added_worlds.empty() || logical_and != logical_and_sent_) {
+        json_t data = messageBoilerplate("subscribe");
+        // The server expects event names with every subscription; if none
+        // were added, repeating the current ones is harmless.
+        data["eventNames"] = event_names_.added_.empty()
+            ? toJsonArray(event_names_.getKeys())
+            : toJsonArray(std::vector<string_t>(
+                event_names_.added_.begin(), event_names_.added_.end()));
+        if (!added_worlds.empty()) {
+            data["worlds"] = toJsonArray(added_worlds);
+        }
+        if (logical_and || logical_and != logical_and_sent_) {
+            data["logicalAndCharactersWithWorlds"] = logical_and;
+        }
+        appendChunkedMessages(&messages, data, added_characters);
+    }
+    event_names_.clearPending();
+    characters_.clearPending();
+    worlds_.clearPending();
+    logical_and_sent_ = logical_and;
+    return messages;
+}
+
+void SubscriptionSet::invalidate() {
+    event_names_.invalidate();
+    characters_.invalidate();
+    worlds_.invalidate();
+    logical_and_sent_ = false;
+}
+
+} // namespace arx
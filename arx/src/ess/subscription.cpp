@@ -65,7 +65,7 @@ string_t Subscription::buildUnsubscribeMessage() const {
         data["characters"] = buildCharacterList();
     }
     if (!worlds_.empty()) {
-        data["eventNames"] = buildWorldList();
+        data["worlds"] = buildWorldList();
     }
     if (logical_and_) {
         data["logicalAndCharactersWithWorlds"] = true;
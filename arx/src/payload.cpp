@@ -24,14 +24,16 @@ int validatePayload(const json_string_t& collection, const json_t& payload) {
         !payload.contains(getResultListName(collection))) {
         return -2; // Payload is missing a required key
     }
-    if (!payload["returned"].is_array()) {
+    if (!payload[getResultListName(collection)].is_array()) {
         return -3; // Return list key is not an array
     }
     return 0;
 }
 
 bool isPayloadEmpty(const json_string_t& collection, const json_t& payload) {
-    if (payload["returned"] == "0") {
+    // The API reports the count as a number, but older responses quote it
+    auto returned = payload.find("returned");
+    if (returned != payload.end() && (*returned == 0 || *returned == "0")) {
         return true;
     }
     auto key = getResultListName(collection);
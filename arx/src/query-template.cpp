@@ -0,0 +1,171 @@
+// Copyright 2022 Leonhard S.
+
+#include "arx/query-template.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arx/query.hpp"
+#include "arx/support.hpp"
+#include "arx/urlgen.hpp"
+
+namespace {
+
+/**
+ * Live template states by URL, used by QueryTemplate::intern(). The state
+ * type is private to QueryTemplate, hence the type-erased pointers.
+ */
+struct InternTable {
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<const void>> states_;
+};
+
+InternTable& getInternTable() {
+    static InternTable table;
+    return table;
+}
+
+} // namespace
+
+namespace arx {
+
+QueryTemplate::State::State(const Query& query)
+    : query_{ query }
+    , path_{ query.getPath() }
+    , head_{}
+    , parameters_{}
+    , tail_{}
+    , url_{} {
+    head_.reserve(CENSUS_SCHEME.size() + 3 + CENSUS_HOST.size()
+        + path_.size());
+    head_.append(CENSUS_SCHEME).append("://").append(CENSUS_HOST)
+        .append(path_);
+    // Search terms always come first in the query string, followed by
+    // the query commands
+    auto terms = query.getTerms();
+    parameters_.reserve(terms.size());
+    for (const auto& term : terms) {
+        Parameter parameter;
+        parameter.prefix_.push_back(parameters_.empty() ? '?' : '&');
+        parameter.prefix_.append(term.getField()).append("=")
+            .append(getModifierLiteral(term.getModifier()));
+        parameter.value_ = term.getValue();
+        parameters_.push_back(std::move(parameter));
+    }
+    Query commands = query;
+    commands.setTerms({});
+    if (commands.getUrlSize() > head_.size()) {
+        tail_.push_back(parameters_.empty() ? '?' : '&');
+        commands.appendQueryString(&tail_);
+    }
+    appendWithWriter(&url_,
+        [this](UrlSink* sink) { write(sink, {}); });
+}
+
+void QueryTemplate::State::write(
+    UrlSink* sink,
+    std::span<const std::string_view> values
+) const {
+    sink->put(head_);
+    for (std::size_t i = 0; i < parameters_.size(); ++i) {
+        sink->put(parameters_[i].prefix_);
+        sink->putEscaped(i < values.size()
+            ? values[i] : std::string_view(parameters_[i].value_));
+    }
+    sink->put(tail_);
+}
+
+std::size_t QueryTemplate::State::getUnescapedSize(
+    std::span<const std::string_view> values
+) const {
+    auto size = head_.size() + tail_.size();
+    for (std::size_t i = 0; i < parameters_.size(); ++i) {
+        size += parameters_[i].prefix_.size() + (i < values.size()
+            ? values[i].size() : parameters_[i].value_.size());
+    }
+    return size;
+}
+
+QueryTemplate::QueryTemplate(const Query& query)
+    : state_{ std::make_shared<const State>(query) } {}
+
+QueryTemplate::QueryTemplate(std::shared_ptr<const State> state)
+    : state_{ std::move(state) } {}
+
+QueryTemplate QueryTemplate::intern(const Query& query) {
+    // The URL covers everything that affects the request, which makes it
+    // a suitable identity for the query
+    auto state = std::make_shared<const State>(query);
+    auto& table = getInternTable();
+    std::lock_guard<std::mutex> lock(table.mutex_);
+    auto it = table.states_.find(state->url_);
+    if (it != table.states_.end()) {
+        auto existing = std::static_pointer_cast<const State>(
+            it->second.lock());
+        if (existing) {
+            return QueryTemplate(std::move(existing));
+        }
+    }
+    // Drop the entries of templates that no longer exist before growing
+    std::erase_if(table.states_,
+        [](const auto& entry) { return entry.second.expired(); });
+    table.states_[state->url_] = state;
+    return QueryTemplate(std::move(state));
+}
+
+const Query& QueryTemplate::getQuery() const {
+    return state_->query_;
+}
+
+std::size_t QueryTemplate::getParameterCount() const {
+    return state_->parameters_.size();
+}
+
+std::string_view QueryTemplate::getPath() const {
+    return state_->path_;
+}
+
+std::string_view QueryTemplate::getUrl() const {
+    return state_->url_;
+}
+
+std::string QueryTemplate::getUrl(
+    std::span<const std::string_view> values
+) const {
+    std::string url;
+    appendUrl(&url, values);
+    return url;
+}
+
+void QueryTemplate::appendUrl(
+    std::string* buffer,
+    std::span<const std::string_view> values
+) const {
+    // Unlike the query writers, the template does not count first: values
+    // such as batched ID lists are long, escaping them is rare, and the
+    // reservation is exact whenever nothing needs escaping. This keeps it
+    // to a single scan over the values.
+    buffer->reserve(buffer->size() + state_->getUnescapedSize(values));
+    UrlSink sink(buffer);
+    writeUrl(&sink, values);
+}
+
+void QueryTemplate::writeUrl(
+    UrlSink* sink,
+    std::span<const std::string_view> values
+) const {
+    state_->write(sink, values);
+}
+
+bool QueryTemplate::isSharedWith(const QueryTemplate& other) const {
+    return state_ == other.state_;
+}
+
+} // namespace arx
@@ -2,17 +2,25 @@
 
 #include "arx/query.hpp"
 
-#include <algorithm>
-#include <iterator>
+#include <cstddef>
 #include <initializer_list>
 #include <memory>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "arx/urlgen.hpp"
 
+namespace {
+
+template <typename T>
+void writeItem(arx::UrlSink* sink, const T& item) {
+    item.write(sink);
+}
+
+} // namespace
+
 namespace arx {
 
 std::vector<JoinData> SupportsJoin::getJoins() const {
@@ -73,46 +81,46 @@ void JoinData::setFieldNames(
 }
 
 std::string JoinData::serialise() const {
-    std::stringstream ss;
-    ss << collection_;
+    return writeToString([this](UrlSink* sink) { write(sink); });
+}
+
+void JoinData::write(UrlSink* sink) const {
+    sink->put(collection_);
     if (!on_.empty()) {
-        ss << "^on:" << on_;
+        sink->put("^on:");
+        sink->put(on_);
     }
     if (!to_.empty()) {
-        ss << "^to:" << to_;
+        sink->put("^to:");
+        sink->put(to_);
     }
     if (list_) {
-        ss << "^list:1";
+        sink->put("^list:1");
     }
     if (!show_.empty()) {
-        ss << "^show:" << arx::join(show_, "'");
+        sink->put("^show:");
+        sink->putJoined(show_, "'");
     }
     if (!hide_.empty()) {
-        ss << "^hide:" << arx::join(hide_, "'");
+        sink->put("^hide:");
+        sink->putJoined(hide_, "'");
     }
     if (!inject_at_.empty()) {
-        ss << "^inject_at:" << inject_at_;
+        sink->put("^inject_at:");
+        sink->put(inject_at_);
     }
     if (!terms_.empty()) {
-        std::vector<std::string> terms_strings;
-        terms_strings.reserve(terms_.size());
-        std::transform(terms_.begin(), terms_.end(),
-            std::back_inserter(terms_strings),
-            [](const auto& term) { return term.serialise(); });
-        ss << "^terms:" << arx::join(terms_strings, "'");
+        sink->put("^terms:");
+        sink->putJoined(terms_, "'", writeItem<SearchTerm>);
     }
     if (!outer_) {
-        ss << "^outer:0";
+        sink->put("^outer:0");
     }
     if (!joins.empty()) {
-        std::vector<std::string> joins_strings;
-        joins_strings.reserve(joins.size());
-        std::transform(joins.begin(), joins.end(),
-            std::back_inserter(joins_strings),
-            [](const auto& join) { return join.serialise(); });
-        ss << "(" << arx::join(joins_strings, ",") << ")";
+        sink->put('(');
+        sink->putJoined(joins, ",", writeItem<JoinData>);
+        sink->put(')');
     }
-    return ss.str();
 }
 
 TreeData::TreeData()
@@ -133,18 +141,22 @@ TreeData::TreeData(
     , start_{ start } {}
 
 std::string TreeData::serialise() const {
-    std::stringstream ss;
-    ss << field_;
+    return writeToString([this](UrlSink* sink) { write(sink); });
+}
+
+void TreeData::write(UrlSink* sink) const {
+    sink->put(field_);
     if (!prefix_.empty()) {
-        ss << "^prefix:" << prefix_;
+        sink->put("^prefix:");
+        sink->put(prefix_);
     }
     if (list_) {
-        ss << "^list:1";
+        sink->put("^list:1");
     }
     if (!start_.empty()) {
-        ss << "^start:" << start_;
+        sink->put("^start:");
+        sink->put(start_);
     }
-    return ss.str();
 }
 
 Query::Query(
@@ -227,6 +239,9 @@ Query& Query::operator=(const Query& other) {
         if (other.tree_) {
             tree_ = std::make_unique<TreeData>(*other.tree_);
         }
+        else {
+            tree_.reset();
+        }
     }
     return *this;
 }
@@ -380,7 +395,16 @@ void Query::setTree() {
 }
 
 void Query::setTree(const TreeData& tree) {
-    *tree_ = tree;
+    tree_ = std::make_unique<TreeData>(tree);
+}
+
+void Query::setTree(
+    const std::string& field,
+    bool list,
+    const std::string& prefix,
+    const std::string& start
+) {
+    setTree(TreeData(field, list, prefix, start));
 }
 
 bool Query::getTiming() const {
@@ -416,21 +440,129 @@ void Query::setRetry(bool retry) {
 }
 
 std::string Query::getUrl() const {
-    std::stringstream url;
-    url << getScheme() << "://" << getHost() << getPath();
-    auto query_items = getQuery();
-    std::transform(query_items.begin(), query_items.end(),
-        std::ostream_iterator<std::string>(url),
-        [query_items](const std::pair<std::string, std::string>& item) {
-            char delim = '&';
-            if (item == query_items.front()) {
-                delim = '?';
-            }
-            std::stringstream ss;
-            ss << delim << item.first << "=" << item.second;
-            return ss.str();
-        });
-    return url.str();
+    std::string url;
+    appendUrl(&url);
+    return url;
+}
+
+std::size_t Query::getUrlSize() const {
+    UrlSink counter;
+    writeUrl(&counter);
+    return counter.getSize();
+}
+
+void Query::appendUrl(std::string* buffer) const {
+    appendWithWriter(buffer, [this](UrlSink* sink) { writeUrl(sink); });
+}
+
+void Query::appendQueryString(std::string* buffer) const {
+    appendWithWriter(buffer,
+        [this](UrlSink* sink) { writeQueryString(sink); });
+}
+
+void Query::writeUrl(UrlSink* sink) const {
+    sink->put(CENSUS_SCHEME);
+    sink->put("://");
+    sink->put(CENSUS_HOST);
+    writePath(sink);
+    writeQueryItems(sink, "?");
+}
+
+void Query::writePath(UrlSink* sink) const {
+    writeCensusPath(
+        sink, service_id_, format_, verb_, namespace_, collection_);
+}
+
+void Query::writeQueryString(UrlSink* sink) const {
+    writeQueryItems(sink, "");
+}
+
+void Query::writeQueryItems(UrlSink* sink, std::string_view lead) const {
+    // Must produce the same items in the same order as getQueryItems()
+    bool first = true;
+    auto next_item = [sink, lead, &first]() {
+        sink->put(first ? lead : "&");
+        first = false;
+    };
+    auto key = [sink, &next_item](std::string_view name) {
+        next_item();
+        sink->put(name);
+        sink->put('=');
+    };
+    // Search terms
+    for (const auto& term : terms_) {
+        next_item();
+        term.write(sink);
+    }
+    // Query commands
+    if (!show_.empty()) {
+        key("c:show");
+        sink->putJoined(show_, ",");
+    }
+    if (!hide_.empty()) {
+        key("c:hide");
+        sink->putJoined(hide_, ",");
+    }
+    if (!sort_.empty()) {
+        key("c:sort");
+        sink->putJoined(sort_, ",");
+    }
+    if (!has_.empty()) {
+        key("c:has");
+        sink->putJoined(has_, ",");
+    }
+    if (!resolve_.empty()) {
+        key("c:resolve");
+        sink->putJoined(resolve_, ",");
+    }
+    if (!case_) {
+        key("c:case");
+        sink->put('0');
+    }
+    if (limit_ > 1) {
+        key("c:limit");
+        sink->putNumber(limit_);
+    }
+    if (limit_per_db_ > 1) {
+        key("c:limit_per_db");
+        sink->putNumber(limit_per_db_);
+    }
+    if (start_ > 0) {
+        key("c:start");
+        sink->putNumber(start_);
+    }
+    if (include_null_) {
+        key("c:include_null");
+        sink->put('1');
+    }
+    if (!lang_.empty()) {
+        key("c:lang");
+        sink->put(lang_);
+    }
+    if (timing_) {
+        key("c:timing");
+        sink->put('1');
+    }
+    if (exact_match_first_) {
+        key("c:exact_match_first");
+        sink->put('1');
+    }
+    if (!distinct_.empty()) {
+        key("c:distinct");
+        sink->put(distinct_);
+    }
+    if (!retry_) {
+        key("c:retry");
+        sink->put('0');
+    }
+    if (tree_) {
+        key("c:tree");
+        tree_->write(sink);
+    }
+    if (!joins.empty()) {
+        key("c:join");
+        sink->putJoined(joins, ",", writeItem<JoinData>);
+    }
 }
 
 std::string Query::getScheme() const {
@@ -442,8 +574,7 @@ std::string Query::getHost() const {
 }
 
 std::string Query::getPath() const {
-    return generateCensusPath(
-        service_id_, format_, verb_, namespace_, collection_);
+    return writeToString([this](UrlSink* sink) { writePath(sink); });
 }
 
 std::vector<std::pair<std::string, std::string>> Query::getQuery() const {
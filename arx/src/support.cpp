@@ -2,12 +2,27 @@
 
 #include "arx/support.hpp"
 
-#include <algorithm>
-#include <iterator>
-#include <sstream>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+namespace {
+
+/** Characters percent-encoded by UrlSink::putEscaped(). */
+constexpr auto RESERVED_CHARS = []() {
+    std::array<bool, 256> table{};
+    for (unsigned char c : std::string_view("%&#+ ")) {
+        table[c] = true;
+    }
+    return table;
+}();
+
+} // namespace
+
 namespace arx {
 
 SearchModifier modifierFromData(const std::string& data) {
@@ -33,6 +48,10 @@ SearchModifier modifierFromData(const std::string& data) {
 }
 
 std::string serialiseModifier(SearchModifier modifier) {
+    return std::string(getModifierLiteral(modifier));
+}
+
+std::string_view getModifierLiteral(SearchModifier modifier) {
     switch (modifier) {
     case SearchModifier::NOT_EQUAL_TO:
         return "!";
@@ -54,6 +73,57 @@ std::string serialiseModifier(SearchModifier modifier) {
     }
 }
 
+UrlSink::UrlSink()
+    : buffer_{ nullptr }
+    , size_{ 0 } {}
+
+UrlSink::UrlSink(std::string* buffer)
+    : buffer_{ buffer }
+    , size_{ 0 } {}
+
+void UrlSink::put(char c) {
+    if (buffer_) {
+        buffer_->push_back(c);
+    }
+    ++size_;
+}
+
+void UrlSink::put(std::string_view text) {
+    if (buffer_) {
+        buffer_->append(text);
+    }
+    size_ += text.size();
+}
+
+void UrlSink::putNumber(int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    put(std::string_view(
+        digits, static_cast<std::size_t>(result.ptr - digits)));
+}
+
+void UrlSink::putEscaped(std::string_view text) {
+    constexpr std::string_view hex = "0123456789ABCDEF";
+    // Copy runs of plain characters in one go, values rarely need escaping
+    std::size_t run_start = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto byte = static_cast<unsigned char>(text[i]);
+        if (!RESERVED_CHARS[byte]) {
+            continue;
+        }
+        put(text.substr(run_start, i - run_start));
+        put('%');
+        put(hex[byte >> 4]);
+        put(hex[byte & 0x0F]);
+        run_start = i + 1;
+    }
+    put(text.substr(run_start));
+}
+
+std::size_t UrlSink::getSize() const {
+    return size_;
+}
+
 SearchTerm::SearchTerm()
     : field_{ "" }
     , value_{ "" }
@@ -80,30 +150,73 @@ SearchTerm SearchTerm::createFromValue(const std::string& field,
     }
 }
 
+std::string SearchTerm::getField() const {
+    return field_;
+}
+
+std::string SearchTerm::getValue() const {
+    return value_;
+}
+
+SearchModifier SearchTerm::getModifier() const {
+    return modifier_;
+}
+
 std::pair<std::string, std::string> SearchTerm::asQueryItem() const {
     return std::make_pair(field_, serialiseModifier(modifier_) + value_);
 }
 
 std::string SearchTerm::serialise() const {
-    std::stringstream ss;
-    ss << field_ << "=" << serialiseModifier(modifier_) << value_;
-    return ss.str();
+    return writeToString([this](UrlSink* sink) { write(sink); });
+}
+
+void SearchTerm::write(UrlSink* sink) const {
+    sink->put(field_);
+    sink->put('=');
+    sink->put(getModifierLiteral(modifier_));
+    sink->putEscaped(value_);
+}
+
+std::size_t getJoinedSize(
+    std::span<const std::string_view> strings,
+    std::string_view delimiter
+) {
+    if (strings.empty()) {
+        return 0;
+    }
+    std::size_t size = delimiter.size() * (strings.size() - 1);
+    for (auto str : strings) {
+        size += str.size();
+    }
+    return size;
+}
+
+void joinInto(
+    std::string* buffer,
+    std::span<const std::string_view> strings,
+    std::string_view delimiter
+) {
+    buffer->reserve(buffer->size() + getJoinedSize(strings, delimiter));
+    UrlSink sink(buffer);
+    sink.putJoined(strings, delimiter);
+}
+
+std::string join(
+    std::span<const std::string_view> strings,
+    std::string_view delimiter
+) {
+    std::string joined;
+    joinInto(&joined, strings, delimiter);
+    return joined;
 }
 
 std::string join(
     const std::vector<std::string>& strings,
-    const std::string& delimiter
+    std::string_view delimiter
 ) {
-    std::stringstream joined;
-    std::transform(strings.cbegin(), strings.cend(),
-        std::ostream_iterator<std::string>(joined),
-        [&strings, &delimiter](const std::string& str) {
-            if (str == strings.front()) {
-                return str;
-            }
-            return delimiter + str;
-        });
-    return joined.str();
+    return writeToString([&strings, delimiter](UrlSink* sink) {
+        sink->putJoined(strings, delimiter);
+    });
 }
 
 } // namespace arx
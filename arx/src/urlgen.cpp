@@ -4,8 +4,8 @@
 
 #include <algorithm>
 #include <iterator>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -14,11 +14,11 @@
 namespace arx {
 
 std::string getScheme() {
-    return "https";
+    return std::string(CENSUS_SCHEME);
 }
 
 std::string getHost() {
-    return "census.daybreakgames.com";
+    return std::string(CENSUS_HOST);
 }
 
 std::string generateCensusPath(
@@ -28,21 +28,40 @@ std::string generateCensusPath(
     const std::string& ns,
     const std::string& collection
 ) {
-    std::stringstream path;
-    path << "/" << service_id;
+    return writeToString([&](UrlSink* sink) {
+        writeCensusPath(sink, service_id, format, verb, ns, collection);
+    });
+}
+
+void writeCensusPath(
+    UrlSink* sink,
+    std::string_view service_id,
+    std::string_view format,
+    std::string_view verb,
+    std::string_view ns,
+    std::string_view collection
+) {
+    sink->put('/');
+    sink->put(service_id);
     if (format != "json") {
-        path << "/" << format;
+        sink->put('/');
+        sink->put(format);
     }
-    path << "/" << verb << "/" << ns;
+    sink->put('/');
+    sink->put(verb);
+    sink->put('/');
+    sink->put(ns);
     if (!collection.empty()) {
-        path << "/" << collection;
+        sink->put('/');
+        sink->put(collection);
     }
-    return path.str();
 }
 
 std::vector<std::pair<std::string, std::string>> getQueryItems(
     const Query* query
 ) {
+    // Must produce the same items in the same order as
+    // Query::writeQueryItems()
     std::vector<std::pair<std::string, std::string>> items;
     // Search terms
     auto terms = query->getTerms();
@@ -110,12 +129,12 @@ std::vector<std::pair<std::string, std::string>> getQueryItems(
     }
     auto joins = query->getJoins();
     if (!joins.empty()) {
-        std::vector<std::string> join_strings;
-        join_strings.reserve(joins.size());
-        std::transform(joins.begin(), joins.end(),
-            std::back_inserter(join_strings),
-            [](const auto& join) { return join.serialise(); });
-        items.emplace_back("c:join", arx::join(join_strings, ","));
+        items.emplace_back("c:join", writeToString([&joins](UrlSink* sink) {
+            sink->putJoined(joins, ",",
+                [](UrlSink* join_sink, const JoinData& join) {
+                    join.write(join_sink);
+                });
+        }));
     }
     return items;
 }
@@ -0,0 +1,170 @@
+// Copyright 2022 Leonhard S.
+
+// Cost of generating Census API request URLs.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arx.hpp"
+
+namespace {
+
+/**
+ * Build a query whose join tree is nested the given number of levels
+ * deep, with a sibling join and a search term on every level.
+ */
+arx::Query makeDeepJoinQuery(std::int64_t depth) {
+    arx::Query query("character", "s:example");
+    query.addTerm(arx::SearchTerm("character_id", "5428713425545165425"));
+    query.setShow({ "character_id", "name.first", "faction_id" });
+    arx::JoinData innermost;
+    for (auto level = depth; level > 0; --level) {
+        auto suffix = std::to_string(level);
+        arx::JoinData join("collection_" + suffix, "parent_id", "child_id",
+            true, { "field_a", "field_b" }, {}, "level_" + suffix,
+            { arx::SearchTerm("rank", suffix,
+                arx::SearchModifier::GREATER_THAN) });
+        join.addJoin(arx::JoinData("sibling_" + suffix));
+        if (level < depth) {
+            join.addJoin(innermost);
+        }
+        innermost = join;
+    }
+    query.addJoin(innermost);
+    return query;
+}
+
+/** Shape of the batched character lookups of the app. */
+arx::Query makeBatchQuery(const std::string& ids) {
+    arx::Query query("character", "s:example");
+    query.addTerm(arx::SearchTerm("character_id", ids));
+    query.setShow({ "character_id", "name.first", "faction_id",
+        "profile_id" });
+    query.setLimit(100);
+    query.addJoin(arx::JoinData("characters_world", "", "", false,
+        { "world_id" }, {}, "world"));
+    return query;
+}
+
+/** Comma-separated list of the given number of character IDs. */
+std::string makeIdList(std::int64_t count) {
+    std::string ids;
+    for (std::int64_t i = 0; i < count; ++i) {
+        if (!ids.empty()) {
+            ids.push_back(',');
+        }
+        ids.append(std::to_string(5428713425545165425 + i));
+    }
+    return ids;
+}
+
+void BM_QueryGetUrl_Simple(benchmark::State& state) {
+    // The character lookup performed by the app
+    arx::Query query("character", "s:example");
+    query.addTerm(arx::SearchTerm("character_id", "5428713425545165425"));
+    query.addJoin(arx::JoinData("characters_world"));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(query.getUrl());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryGetUrl_Simple);
+
+void BM_QueryGetUrl_Nested(benchmark::State& state) {
+    arx::Query query("character", "s:example");
+    query.addTerm(arx::SearchTerm("name.first_lower", "auroram"));
+    query.setShow({ "character_id", "name.first", "faction_id" });
+    query.setLimit(10);
+    query.setResolve({ "world", "outfit" });
+    auto stats = arx::JoinData("characters_stat_history", "", "", true,
+        { "stat_name", "all_time" }, {}, "stats");
+    stats.addJoin(arx::JoinData("characters_weapon_stat", "", "", true));
+    query.addJoin(stats);
+    query.addJoin(arx::JoinData("characters_online_status"));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(query.getUrl());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryGetUrl_Nested);
+
+void BM_QueryGetUrl_DeepJoins(benchmark::State& state) {
+    auto query = makeDeepJoinQuery(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(query.getUrl());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryGetUrl_DeepJoins)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_QueryAppendUrl_DeepJoins(benchmark::State& state) {
+    // Reusing the buffer, as a client sending many requests would
+    auto query = makeDeepJoinQuery(state.range(0));
+    std::string buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        query.appendUrl(&buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations()
+        * static_cast<std::int64_t>(buffer.size()));
+}
+BENCHMARK(BM_QueryAppendUrl_DeepJoins)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_QueryBatch_Build(benchmark::State& state) {
+    // Building the query from scratch for every batch
+    auto ids = makeIdList(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeBatchQuery(ids).getUrl());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryBatch_Build)->Arg(1)->Arg(100);
+
+void BM_QueryBatch_Template(benchmark::State& state) {
+    auto query_template = arx::QueryTemplate::intern(makeBatchQuery(""));
+    auto ids = makeIdList(state.range(0));
+    std::string_view values[] = { ids };
+    std::string buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        query_template.appendUrl(&buffer, values);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryBatch_Template)->Arg(1)->Arg(100);
+
+void BM_QueryTemplate_DeepJoins(benchmark::State& state) {
+    // Join depth no longer matters once the template is built
+    arx::QueryTemplate query_template(makeDeepJoinQuery(state.range(0)));
+    std::string_view values[] = { "5428713425545165426" };
+    std::string buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        query_template.appendUrl(&buffer, values);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryTemplate_DeepJoins)->Arg(1)->Arg(16);
+
+void BM_Join_Strings(benchmark::State& state) {
+    // c:show style field lists; repeated entries are deliberate
+    std::vector<std::string> fields;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        fields.push_back("field_" + std::to_string(i % 8));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(arx::join(fields, ","));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Join_Strings)->Arg(4)->Arg(64);
+
+} // namespace
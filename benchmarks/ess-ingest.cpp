@@ -0,0 +1,178 @@
+// Copyright 2022 Leonhard S.
+
+// Per-message cost of the ESS ingestion path: parsing a frame into a JSON
+// document and classifying it, compared against the typed decoder the app
+// uses. Also covers building subscription messages.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+namespace {
+
+const std::string DEATH_MESSAGE =
+    R"({"payload":{"attacker_character_id":"5428010618035589553",)"
+    R"("attacker_fire_mode_id":"7419","attacker_loadout_id":"15",)"
+    R"("attacker_team_id":"3","attacker_vehicle_id":"0",)"
+    R"("attacker_weapon_id":"7214","character_id":"5428713425545165425",)"
+    R"("character_loadout_id":"4","event_name":"Death",)"
+    R"("is_critical":"0","is_headshot":"1","team_id":"2",)"
+    R"("timestamp":"1667563154","vehicle_id":"0","world_id":"10",)"
+    R"("zone_id":"2"},"service":"event","type":"serviceMessage"})";
+
+const std::string EXPERIENCE_MESSAGE =
+    R"({"payload":{"amount":"150","character_id":"5428713425545165425",)"
+    R"("event_name":"GainExperience","experience_id":"4",)"
+    R"("loadout_id":"4","other_id":"5428010618035589553",)"
+    R"("team_id":"2","timestamp":"1667563155","world_id":"10",)"
+    R"("zone_id":"2"},"service":"event","type":"serviceMessage"})";
+
+const std::string HEARTBEAT_MESSAGE =
+    R"({"online":{"EventServerEndpoint_Connery_1":"true",)"
+    R"("EventServerEndpoint_Miller_10":"true",)"
+    R"("EventServerEndpoint_Cobalt_13":"true",)"
+    R"("EventServerEndpoint_Emerald_17":"true",)"
+    R"("EventServerEndpoint_Jaeger_19":"true",)"
+    R"("EventServerEndpoint_Soltech_40":"true"},)"
+    R"("service":"event","type":"heartbeat"})";
+
+/**
+ * Frames in roughly the proportions seen for a tracked character.
+ */
+std::vector<std::string> sampleMessages() {
+    std::vector<std::string> messages;
+    for (int i = 0; i < 16; ++i) {
+        messages.push_back(EXPERIENCE_MESSAGE);
+    }
+    for (int i = 0; i < 2; ++i) {
+        messages.push_back(DEATH_MESSAGE);
+    }
+    messages.push_back(HEARTBEAT_MESSAGE);
+    return messages;
+}
+
+std::int64_t totalBytes(const std::vector<std::string>& messages) {
+    std::int64_t bytes = 0;
+    for (const auto& message : messages) {
+        bytes += static_cast<std::int64_t>(message.size());
+    }
+    return bytes;
+}
+
+void setCounters(
+    benchmark::State& state,
+    const std::vector<std::string>& messages
+) {
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(messages.size()));
+    state.SetBytesProcessed(state.iterations() * totalBytes(messages));
+}
+
+void BM_EssParse_Json(benchmark::State& state) {
+    const auto messages = sampleMessages();
+    for (auto _ : state) {
+        for (const auto& message : messages) {
+            auto json = arx::json_t::parse(message, nullptr, false);
+            benchmark::DoNotOptimize(json);
+        }
+    }
+    setCounters(state, messages);
+}
+BENCHMARK(BM_EssParse_Json);
+
+void BM_EssClassify_GetPayload(benchmark::State& state) {
+    // Previous ingestion path: parse, classify, and copy the payload
+    const auto messages = sampleMessages();
+    for (auto _ : state) {
+        for (const auto& message : messages) {
+            auto json = arx::json_t::parse(message, nullptr, false);
+            if (arx::getMessageType(json)
+                == arx::MessageType::SERVICE_MESSAGE) {
+                auto payload = arx::getPayload(json);
+                benchmark::DoNotOptimize(payload);
+            }
+        }
+    }
+    setCounters(state, messages);
+}
+BENCHMARK(BM_EssClassify_GetPayload);
+
+void BM_EssClassify_FindPayload(benchmark::State& state) {
+    const auto messages = sampleMessages();
+    for (auto _ : state) {
+        for (const auto& message : messages) {
+            auto json = arx::json_t::parse(message, nullptr, false);
+            if (arx::getMessageType(json)
+                == arx::MessageType::SERVICE_MESSAGE) {
+                benchmark::DoNotOptimize(arx::findPayload(json));
+            }
+        }
+    }
+    setCounters(state, messages);
+}
+BENCHMARK(BM_EssClassify_FindPayload);
+
+void BM_EssDecode_Typed(benchmark::State& state) {
+    const auto messages = sampleMessages();
+    arx::MessageType type;
+    arx::EventPayload payload;
+    for (auto _ : state) {
+        for (const auto& message : messages) {
+            benchmark::DoNotOptimize(
+                arx::decodeMessage(message, &type, &payload));
+        }
+        benchmark::DoNotOptimize(payload);
+    }
+    setCounters(state, messages);
+}
+BENCHMARK(BM_EssDecode_Typed);
+
+std::vector<std::string> sampleCharacters(std::size_t count) {
+    std::vector<std::string> characters;
+    characters.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        characters.push_back(std::to_string(5428010618035589553ULL + i));
+    }
+    return characters;
+}
+
+void BM_Subscription_BuildSubscribeMessage(benchmark::State& state) {
+    const arx::Subscription subscription(
+        { "Death", "GainExperience" },
+        sampleCharacters(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(subscription.buildSubscribeMessage());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Subscription_BuildSubscribeMessage)->Arg(1)->Arg(100);
+
+void BM_SubscriptionSet_AddAndFlush(benchmark::State& state) {
+    // Cost of tracking one more character in an existing set
+    const auto characters = sampleCharacters(
+        static_cast<std::size_t>(state.range(0)));
+    arx::SubscriptionSet set;
+    for (const auto& character : characters) {
+        set.add(arx::Subscription({ "Death", "GainExperience" },
+            { character }));
+    }
+    set.takePendingMessages();
+    const arx::Subscription extra(
+        { "Death", "GainExperience" }, { "5428713425545165425" });
+    for (auto _ : state) {
+        set.add(extra);
+        benchmark::DoNotOptimize(set.takePendingMessages());
+        set.remove(extra);
+        benchmark::DoNotOptimize(set.takePendingMessages());
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_SubscriptionSet_AddAndFlush)->Arg(1)->Arg(100);
+
+} // namespace
@@ -0,0 +1,214 @@
+// Copyright 2022 Leonhard S.
+
+// Per-message cost of resolving an ESS event name and dispatching it to its
+// handler. The "Legacy" benchmarks reproduce the previous implementation of
+// a linear chain of string comparisons; the others use the perfect hash in
+// arx::eventFromEventName and an enum-indexed handler table.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+namespace {
+
+arx::Event legacyEventFromEventName(const std::string& event_name) {
+    if (event_name == "AchievementEarned") {
+        return arx::Event::AchievementEarned;
+    }
+    if (event_name == "BattleRankUp") {
+        return arx::Event::BattleRankUp;
+    }
+    if (event_name == "ContinentLock") {
+        return arx::Event::ContinentLock;
+    }
+    if (event_name == "ContinentUnlock") {
+        return arx::Event::ContinentUnlock;
+    }
+    if (event_name == "Death") {
+        return arx::Event::Death;
+    }
+    if (event_name == "FacilityControl") {
+        return arx::Event::FacilityControl;
+    }
+    if (event_name == "GainExperience") {
+        return arx::Event::GainExperience;
+    }
+    if (event_name == "ItemAdded") {
+        return arx::Event::ItemAdded;
+    }
+    if (event_name == "MetagameEvent") {
+        return arx::Event::MetagameEvent;
+    }
+    if (event_name == "PlayerFacilityCapture") {
+        return arx::Event::PlayerFacilityCapture;
+    }
+    if (event_name == "PlayerFacilityDefend") {
+        return arx::Event::PlayerFacilityDefend;
+    }
+    if (event_name == "PlayerLogin") {
+        return arx::Event::PlayerLogin;
+    }
+    if (event_name == "PlayerLogout") {
+        return arx::Event::PlayerLogout;
+    }
+    if (event_name == "SkillAdded") {
+        return arx::Event::SkillAdded;
+    }
+    if (event_name == "VehicleDestroy") {
+        return arx::Event::VehicleDestroy;
+    }
+    return arx::Event::Unknown;
+}
+
+/**
+ * Stand-in for the tracker, counting the events handled.
+ */
+struct Handlers {
+    using Handler = void (Handlers::*)();
+
+    void onDeath() { ++deaths; }
+    void onGainExperience() { ++experience; }
+    void onVehicleDestroy() { ++vehicles; }
+    void onPlayerFacilityCapture() { ++captures; }
+
+    std::size_t deaths = 0;
+    std::size_t experience = 0;
+    std::size_t vehicles = 0;
+    std::size_t captures = 0;
+};
+
+std::array<Handlers::Handler, arx::EVENT_COUNT> buildHandlerTable() {
+    std::array<Handlers::Handler, arx::EVENT_COUNT> table{};
+    table[static_cast<std::size_t>(arx::Event::Death)] =
+        &Handlers::onDeath;
+    table[static_cast<std::size_t>(arx::Event::GainExperience)] =
+        &Handlers::onGainExperience;
+    table[static_cast<std::size_t>(arx::Event::VehicleDestroy)] =
+        &Handlers::onVehicleDestroy;
+    table[static_cast<std::size_t>(arx::Event::PlayerFacilityCapture)] =
+        &Handlers::onPlayerFacilityCapture;
+    return table;
+}
+
+/**
+ * Event names in roughly the proportions seen on a busy world.
+ */
+std::vector<std::string> sampleEventNames() {
+    std::vector<std::string> names;
+    for (int i = 0; i < 64; ++i) {
+        names.emplace_back("GainExperience");
+    }
+    for (int i = 0; i < 8; ++i) {
+        names.emplace_back("Death");
+    }
+    for (int i = 0; i < 4; ++i) {
+        names.emplace_back("VehicleDestroy");
+    }
+    names.emplace_back("PlayerFacilityCapture");
+    names.emplace_back("PlayerFacilityDefend");
+    names.emplace_back("PlayerLogin");
+    names.emplace_back("PlayerLogout");
+    return names;
+}
+
+void BM_EventLookup_Legacy(benchmark::State& state) {
+    const auto names = sampleEventNames();
+    for (auto _ : state) {
+        for (const auto& name : names) {
+            benchmark::DoNotOptimize(legacyEventFromEventName(name));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(names.size()));
+}
+BENCHMARK(BM_EventLookup_Legacy);
+
+void BM_EventLookup_PerfectHash(benchmark::State& state) {
+    const auto names = sampleEventNames();
+    for (auto _ : state) {
+        for (const auto& name : names) {
+            benchmark::DoNotOptimize(arx::eventFromEventName(name));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(names.size()));
+}
+BENCHMARK(BM_EventLookup_PerfectHash);
+
+void BM_EventDispatch_Legacy(benchmark::State& state) {
+    // Previous tracker behaviour: compare the event name against every
+    // handled event in turn.
+    const auto names = sampleEventNames();
+    Handlers handlers;
+    for (auto _ : state) {
+        for (const auto& name : names) {
+            if (name == "Death") {
+                handlers.onDeath();
+            }
+            else if (name == "GainExperience") {
+                handlers.onGainExperience();
+            }
+            else if (name == "VehicleDestroy") {
+                handlers.onVehicleDestroy();
+            }
+            else if (name == "PlayerFacilityCapture") {
+                handlers.onPlayerFacilityCapture();
+            }
+        }
+        benchmark::DoNotOptimize(handlers);
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(names.size()));
+}
+BENCHMARK(BM_EventDispatch_Legacy);
+
+void BM_EventDispatch_Table(benchmark::State& state) {
+    // Event names are resolved once by the decoder, so the tracker only
+    // indexes the handler table.
+    std::vector<arx::Event> events;
+    for (const auto& name : sampleEventNames()) {
+        events.push_back(arx::eventFromEventName(name));
+    }
+    const auto table = buildHandlerTable();
+    Handlers handlers;
+    for (auto _ : state) {
+        for (auto event : events) {
+            auto handler = table[static_cast<std::size_t>(event)];
+            if (handler != nullptr) {
+                (handlers.*handler)();
+            }
+        }
+        benchmark::DoNotOptimize(handlers);
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(events.size()));
+}
+BENCHMARK(BM_EventDispatch_Table);
+
+void BM_EventResolveAndDispatch_Table(benchmark::State& state) {
+    const auto names = sampleEventNames();
+    const auto table = buildHandlerTable();
+    Handlers handlers;
+    for (auto _ : state) {
+        for (const auto& name : names) {
+            auto event = arx::eventFromEventName(name);
+            auto handler = table[static_cast<std::size_t>(event)];
+            if (handler != nullptr) {
+                (handlers.*handler)();
+            }
+        }
+        benchmark::DoNotOptimize(handlers);
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(names.size()));
+}
+BENCHMARK(BM_EventResolveAndDispatch_Table);
+
+} // namespace
@@ -0,0 +1,58 @@
+// Copyright 2022 Leonhard S.
+
+// Cost of mapping Census API IDs to game data enums. Every ID is looked up
+// in turn, including unknown ones.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "arx/ps2-types.hpp"
+
+#include "class.hpp"
+#include "vehicle.hpp"
+#include "zone.hpp"
+
+namespace {
+
+void BM_ClassFromLoadoutId(benchmark::State& state) {
+    constexpr arx::loadout_id_t max_id = 64;
+    ps2::Class cls;
+    for (auto _ : state) {
+        for (arx::loadout_id_t id = 0; id < max_id; ++id) {
+            benchmark::DoNotOptimize(ps2::class_from_loadout_id(id, &cls));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(max_id));
+}
+BENCHMARK(BM_ClassFromLoadoutId);
+
+void BM_ZoneFromZoneId(benchmark::State& state) {
+    constexpr arx::zone_id_t max_id = 512;
+    ps2::Zone zone;
+    for (auto _ : state) {
+        for (arx::zone_id_t id = 0; id < max_id; ++id) {
+            benchmark::DoNotOptimize(ps2::zone_from_zone_id(id, &zone));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(max_id));
+}
+BENCHMARK(BM_ZoneFromZoneId);
+
+void BM_VehicleFromVehicleId(benchmark::State& state) {
+    constexpr arx::vehicle_id_t max_id = 2048;
+    ps2::Vehicle vehicle;
+    for (auto _ : state) {
+        for (arx::vehicle_id_t id = 0; id < max_id; ++id) {
+            benchmark::DoNotOptimize(
+                ps2::vehicle_from_vehicle_id(id, &vehicle));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(max_id));
+}
+BENCHMARK(BM_VehicleFromVehicleId);
+
+} // namespace
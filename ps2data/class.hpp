@@ -2,11 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "arx/ps2-types.hpp"
 
 #include "faction.hpp"
+#include "lookup.hpp"
 
 namespace ps2 {
 
@@ -20,6 +25,137 @@ enum class Class {
     MAX,
 };
 
+inline constexpr std::size_t CLASS_COUNT =
+    static_cast<std::size_t>(Class::MAX) + 1;
+
+/**
+ * Static data for an infantry class.
+ *
+ * Loadout and profile IDs are listed per playable faction, in the order
+ * NC, TR, VS, NSO.
+ */
+struct ClassData {
+    Class value;
+    std::string_view display_name;
+    std::string_view image_key;
+    std::array<arx::loadout_id_t, 4> loadout_ids;
+    std::array<arx::profile_id_t, 4> profile_ids;
+};
+
+inline constexpr std::array<ClassData, CLASS_COUNT> CLASS_TABLE = {{
+    { Class::Infiltrator, "Infiltrator", "infiltrator",
+        { 1, 8, 15, 28 }, { 2, 10, 17, 190 } },
+    { Class::LightAssault, "Light Assault", "light_assault",
+        { 3, 10, 17, 29 }, { 4, 12, 19, 191 } },
+    { Class::CombatMedic, "Combat Medic", "combat_medic",
+        { 4, 11, 18, 30 }, { 5, 13, 20, 192 } },
+    { Class::Engineer, "Engineer", "engineer",
+        { 5, 12, 19, 31 }, { 6, 14, 21, 193 } },
+    { Class::HeavyAssault, "Heavy Assault", "heavy_assault",
+        { 6, 13, 20, 32 }, { 7, 15, 22, 194 } },
+    { Class::MAX, "MAX", "max",
+        { 7, 14, 21, 45 }, { 8, 16, 23, 252 } },
+}};
+static_assert(detail::isIndexedByEnum(CLASS_TABLE),
+    "CLASS_TABLE must list every class once, in enum order");
+
+namespace detail {
+
+inline constexpr auto LOADOUT_ID_INDEX = [] {
+    IdIndex<Class, 45> index;
+    for (const auto& row : CLASS_TABLE) {
+        for (auto id : row.loadout_ids) {
+            index.insert(id, row.value);
+        }
+    }
+    return index;
+}();
+static_assert(LOADOUT_ID_INDEX.isValid(), "Duplicate loadout ID");
+
+inline constexpr auto PROFILE_ID_INDEX = [] {
+    IdIndex<Class, 252> index;
+    for (const auto& row : CLASS_TABLE) {
+        for (auto id : row.profile_ids) {
+            index.insert(id, row.value);
+        }
+    }
+    return index;
+}();
+static_assert(PROFILE_ID_INDEX.isValid(), "Duplicate profile ID");
+
+} // namespace detail
+
+/**
+ * Return the class enum value for a given Census API loadout ID.
+ *
+ * @param loadout_id The Census API loadout ID.
+ * @return The class, or std::nullopt if the ID is unknown.
+ */
+constexpr std::optional<Class> class_from_loadout_id(
+    arx::loadout_id_t loadout_id
+) {
+    return detail::LOADOUT_ID_INDEX.find(loadout_id);
+}
+
+/**
+ * Return the class enum value for a given Census API profile ID.
+ *
+ * @param profile_id The Census API profile ID.
+ * @return The class, or std::nullopt if the ID is unknown.
+ */
+constexpr std::optional<Class> class_from_profile_id(
+    arx::profile_id_t profile_id
+) {
+    return detail::PROFILE_ID_INDEX.find(profile_id);
+}
+
+/**
+ * Return the display name for a given class enum value.
+ *
+ * @param cls The class enum value.
+ * @return The display name, or an empty string for invalid values.
+ */
+constexpr std::string_view class_to_display_name(Class cls) {
+    auto index = static_cast<std::size_t>(cls);
+    return index < CLASS_COUNT
+        ? CLASS_TABLE[index].display_name : std::string_view();
+}
+
+/**
+ * Return the Rich Presence image key for a given class enum value.
+ *
+ * @param cls The class enum value.
+ * @return The image key, or an empty string for invalid values.
+ */
+constexpr std::string_view class_to_image_key(Class cls) {
+    auto index = static_cast<std::size_t>(cls);
+    return index < CLASS_COUNT
+        ? CLASS_TABLE[index].image_key : std::string_view();
+}
+
+// Per-faction IDs are indexed by Faction enum value, minus one for NS
+static_assert(static_cast<int>(Faction::NC) == 1
+    && static_cast<int>(Faction::TR) == 2
+    && static_cast<int>(Faction::VS) == 3
+    && static_cast<int>(Faction::NSO) == 4);
+
+/**
+ * Return the Census API profile ID for a given class enum value.
+ *
+ * @param cls The class enum value.
+ * @param faction The faction of the profile to return.
+ * @return The Census API profile ID, or 0 if there is no such profile.
+ */
+constexpr arx::profile_id_t class_to_profile_id(Class cls, Faction faction) {
+    auto index = static_cast<std::size_t>(cls);
+    auto faction_index = static_cast<std::size_t>(faction);
+    if (index >= CLASS_COUNT || faction == Faction::NS
+        || faction_index >= FACTION_COUNT) {
+        return 0;
+    }
+    return CLASS_TABLE[index].profile_ids[faction_index - 1];
+}
+
 /**
  * Return the class enum value for a given Census API loadout ID.
  *
@@ -47,13 +183,4 @@ int class_from_profile_id(arx::profile_id_t profile_id, Class* cls);
  */
 int class_to_display_name(Class cls, std::string* display_name);
 
-/**
- * Return the Census API profile ID for a given class enum value.
- *
- * @param cls The class enum value.
- * @param faction The faction of the profile to return.
- * @return The Census API profile ID.
- */
-arx::profile_id_t class_to_profile_id(Class cls, Faction faction);
-
 } // namespace ps2
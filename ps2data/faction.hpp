@@ -2,10 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "arx/ps2-types.hpp"
 
+#include "lookup.hpp"
+
 namespace ps2 {
 
 /** Enumeration of factions in PlanetSide 2. */
@@ -17,6 +23,87 @@ enum class Faction {
     NSO,
 };
 
+inline constexpr std::size_t FACTION_COUNT =
+    static_cast<std::size_t>(Faction::NSO) + 1;
+
+/** Static data for a faction. */
+struct FactionData {
+    Faction value;
+    arx::faction_id_t faction_id;
+    std::string_view tag;
+    std::string_view display_name;
+};
+
+inline constexpr std::array<FactionData, FACTION_COUNT> FACTION_TABLE = {{
+    { Faction::NS, 0, "NS", "Nanite Systems" },
+    { Faction::NC, 2, "NC", "New Conglomerate" },
+    { Faction::TR, 3, "TR", "Terran Republic" },
+    { Faction::VS, 1, "VS", "Vanu Sovereignty" },
+    { Faction::NSO, 4, "NSO", "Nanite Systems Operatives" },
+}};
+static_assert(detail::isIndexedByEnum(FACTION_TABLE),
+    "FACTION_TABLE must list every faction once, in enum order");
+
+namespace detail {
+
+inline constexpr auto FACTION_ID_INDEX = [] {
+    IdIndex<Faction, 4> index;
+    for (const auto& row : FACTION_TABLE) {
+        index.insert(row.faction_id, row.value);
+    }
+    return index;
+}();
+static_assert(FACTION_ID_INDEX.isValid(), "Duplicate faction ID");
+
+} // namespace detail
+
+/**
+ * Return the faction enum value for a given Census API faction ID.
+ *
+ * @param faction_id The Census API faction ID.
+ * @return The faction, or std::nullopt if the ID is unknown.
+ */
+constexpr std::optional<Faction> faction_from_faction_id(
+    arx::faction_id_t faction_id
+) {
+    return detail::FACTION_ID_INDEX.find(faction_id);
+}
+
+/**
+ * Return the display name for a given faction enum value.
+ *
+ * @param faction The faction enum value.
+ * @return The display name, or an empty string for invalid values.
+ */
+constexpr std::string_view faction_to_display_name(Faction faction) {
+    auto index = static_cast<std::size_t>(faction);
+    return index < FACTION_COUNT
+        ? FACTION_TABLE[index].display_name : std::string_view();
+}
+
+/**
+ * Return the faction tag for a given faction enum value.
+ *
+ * @param faction The faction enum value.
+ * @return The faction tag, or an empty string for invalid values.
+ */
+constexpr std::string_view faction_to_tag(Faction faction) {
+    auto index = static_cast<std::size_t>(faction);
+    return index < FACTION_COUNT
+        ? FACTION_TABLE[index].tag : std::string_view();
+}
+
+/**
+ * Return the Census API faction ID for a given faction enum value.
+ *
+ * @param faction The faction enum value.
+ * @return The Census API faction ID.
+ */
+constexpr arx::faction_id_t faction_to_faction_id(Faction faction) {
+    auto index = static_cast<std::size_t>(faction);
+    return index < FACTION_COUNT ? FACTION_TABLE[index].faction_id : 0;
+}
+
 /**
  * Return the faction enum value for a given Census API faction ID.
  *
@@ -44,12 +131,4 @@ int faction_to_display_name(Faction faction, std::string* display_name);
  */
 int faction_to_tag(Faction faction, std::string* tag);
 
-/**
- * Return the Census API faction ID for a given faction enum value.
- *
- * @param faction The faction enum value.
- * @return The Census API faction ID.
- */
-arx::faction_id_t faction_to_faction_id(Faction faction);
-
 } // namespace ps2
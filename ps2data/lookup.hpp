@@ -0,0 +1,80 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ps2::detail {
+
+/**
+ * Check that a table has exactly one row per enum value, in enum order.
+ *
+ * This lets enum-to-data lookups index the table directly.
+ */
+template <typename Table>
+constexpr bool isIndexedByEnum(const Table& table) {
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        if (static_cast<std::size_t>(table[i].value) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Dense map from Census API IDs to enum values, built at compile time.
+ *
+ * Lookups are a bounds check and a single array access.
+ *
+ * @tparam Enum The enum type mapped to; must have fewer than 255 values.
+ * @tparam MaxId The largest ID that may be inserted.
+ */
+template <typename Enum, std::size_t MaxId>
+class IdIndex {
+public:
+    constexpr IdIndex()
+        : slots_{}
+        , valid_{ true }
+    {
+        slots_.fill(NO_ENTRY);
+    }
+
+    /**
+     * Map an ID to an enum value.
+     *
+     * Inserting an ID twice or exceeding MaxId marks the index as invalid.
+     */
+    constexpr void insert(std::uint64_t id, Enum value) {
+        if (id > MaxId || slots_[id] != NO_ENTRY) {
+            valid_ = false;
+            return;
+        }
+        slots_[id] = static_cast<std::uint8_t>(value);
+    }
+
+    constexpr std::optional<Enum> find(std::uint64_t id) const {
+        if (id > MaxId || slots_[id] == NO_ENTRY) {
+            return std::nullopt;
+        }
+        return static_cast<Enum>(slots_[id]);
+    }
+
+    /**
+     * Whether every ID was unique and in range; check this in a
+     * static_assert next to the index.
+     */
+    constexpr bool isValid() const {
+        return valid_;
+    }
+
+private:
+    static constexpr std::uint8_t NO_ENTRY = 0xff;
+
+    std::array<std::uint8_t, MaxId + 1> slots_;
+    bool valid_;
+};
+
+} // namespace ps2::detail
@@ -2,10 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "arx/ps2-types.hpp"
 
+#include "lookup.hpp"
+
 namespace ps2 {
 
 /** Enumeration of game servers in PlanetSide 2. */
@@ -18,23 +24,63 @@ enum class Server {
     SolTech,
 };
 
+inline constexpr std::size_t SERVER_COUNT =
+    static_cast<std::size_t>(Server::SolTech) + 1;
+
+/** Static data for a game server. */
+struct ServerData {
+    Server value;
+    arx::world_id_t world_id;
+    std::string_view display_name;
+};
+
+inline constexpr std::array<ServerData, SERVER_COUNT> SERVER_TABLE = {{
+    { Server::Cobalt, 13, "Cobalt" },
+    { Server::Connery, 1, "Connery" },
+    { Server::Emerald, 17, "Emerald" },
+    { Server::Jaeger, 19, "Jaeger" },
+    { Server::Miller, 10, "Miller" },
+    { Server::SolTech, 40, "SolTech" },
+}};
+static_assert(detail::isIndexedByEnum(SERVER_TABLE),
+    "SERVER_TABLE must list every server once, in enum order");
+
+namespace detail {
+
+inline constexpr auto WORLD_ID_INDEX = [] {
+    IdIndex<Server, 40> index;
+    for (const auto& row : SERVER_TABLE) {
+        index.insert(row.world_id, row.value);
+    }
+    return index;
+}();
+static_assert(WORLD_ID_INDEX.isValid(), "Duplicate world ID");
+
+} // namespace detail
+
 /**
  * Return the server enum value for a given Census API world ID.
  *
  * @param world_id The Census API world ID.
- * @param server The server enum value to be populated.
- * @return 0 on success, -1 on failure.
+ * @return The server, or std::nullopt if the ID is unknown.
  */
-int server_from_world_id(arx::world_id_t world_id, Server* server);
+constexpr std::optional<Server> server_from_world_id(
+    arx::world_id_t world_id
+) {
+    return detail::WORLD_ID_INDEX.find(world_id);
+}
 
 /**
  * Return the display name for a given server enum value.
  *
  * @param server The server enum value.
- * @param display_name The display name to be populated.
- * @return 0 on success, -1 on failure.
+ * @return The display name, or an empty string for invalid values.
  */
-int server_to_display_name(Server server, std::string* display_name);
+constexpr std::string_view server_to_display_name(Server server) {
+    auto index = static_cast<std::size_t>(server);
+    return index < SERVER_COUNT
+        ? SERVER_TABLE[index].display_name : std::string_view();
+}
 
 /**
  * Return the Census API world ID for a given server enum value.
@@ -42,6 +88,27 @@ int server_to_display_name(Server server, std::string* display_name);
  * @param server The server enum value.
  * @return The Census API world ID.
  */
-arx::world_id_t server_to_world_id(Server server);
+constexpr arx::world_id_t server_to_world_id(Server server) {
+    auto index = static_cast<std::size_t>(server);
+    return index < SERVER_COUNT ? SERVER_TABLE[index].world_id : 0;
+}
+
+/**
+ * Return the server enum value for a given Census API world ID.
+ *
+ * @param world_id The Census API world ID.
+ * @param server The server enum value to be populated.
+ * @return 0 on success, -1 on failure.
+ */
+int server_from_world_id(arx::world_id_t world_id, Server* server);
+
+/**
+ * Return the display name for a given server enum value.
+ *
+ * @param server The server enum value.
+ * @param display_name The display name to be populated.
+ * @return 0 on success, -1 on failure.
+ */
+int server_to_display_name(Server server, std::string* display_name);
 
 } // namespace ps2
@@ -2,10 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "arx/ps2-types.hpp"
 
+#include "lookup.hpp"
+
 namespace ps2 {
 
 /**
@@ -40,6 +46,105 @@ enum class Vehicle {
     Dervish,
 };
 
+inline constexpr std::size_t VEHICLE_COUNT =
+    static_cast<std::size_t>(Vehicle::Dervish) + 1;
+
+/**
+ * Static data for a vehicle.
+ *
+ * Some vehicles have several Census API IDs, e.g. one per faction; only
+ * the first id_count entries of vehicle_ids are used.
+ */
+struct VehicleData {
+    Vehicle value;
+    std::string_view display_name;
+    std::string_view image_key;
+    std::size_t id_count;
+    std::array<arx::vehicle_id_t, 3> vehicle_ids;
+};
+
+inline constexpr std::array<VehicleData, VEHICLE_COUNT> VEHICLE_TABLE = {{
+    { Vehicle::None, "", "", 1, { 0 } },
+    { Vehicle::Flash, "Flash", "flash", 1, { 1 } },
+    { Vehicle::Sunderer, "Sunderer", "sunderer", 1, { 2 } },
+    { Vehicle::Lightning, "Lightning", "lightning", 1, { 3 } },
+    { Vehicle::Magrider, "Magrider", "magrider", 1, { 4 } },
+    { Vehicle::Vanguard, "Vanguard", "vanguard", 1, { 5 } },
+    { Vehicle::Prowler, "Prowler", "prowler", 1, { 6 } },
+    { Vehicle::Scythe, "Scythe", "scythe", 1, { 7 } },
+    { Vehicle::Reaver, "Reaver", "reaver", 1, { 8 } },
+    { Vehicle::Mosquito, "Mosquito", "mosquito", 1, { 9 } },
+    { Vehicle::Liberator, "Liberator", "liberator", 1, { 10 } },
+    { Vehicle::Galaxy, "Galaxy", "galaxy", 1, { 11 } },
+    { Vehicle::Harasser, "Harasser", "harasser", 1, { 12 } },
+    { Vehicle::Valkyrie, "Valkyrie", "valkyrie", 1, { 14 } },
+    { Vehicle::Ant, "Ant", "ant", 1, { 15 } },
+    { Vehicle::AiTurret, "AI Turret", "ai_turret", 1, { 100 } },
+    { Vehicle::AaTurret, "AA Turret", "aa_turret", 1, { 150 } },
+    { Vehicle::AvTurret, "AV Turret", "av_turret", 1, { 151 } },
+    { Vehicle::Colossus, "Colossus", "colossus", 1, { 2007 } },
+    { Vehicle::Bastion, "Bastion", "bastion", 1, { 2019 } },
+    { Vehicle::Javelin, "Javelin", "javelin", 3, { 2033, 2125, 2129 } },
+    { Vehicle::Interceptor, "Interceptor", "interceptor",
+        3, { 2122, 2023, 2124 } },
+    { Vehicle::Dervish, "Dervish", "dervish", 1, { 2136 } },
+}};
+static_assert(detail::isIndexedByEnum(VEHICLE_TABLE),
+    "VEHICLE_TABLE must list every vehicle once, in enum order");
+
+namespace detail {
+
+inline constexpr auto VEHICLE_ID_INDEX = [] {
+    IdIndex<Vehicle, 2136> index;
+    for (const auto& row : VEHICLE_TABLE) {
+        for (std::size_t i = 0; i < row.id_count; ++i) {
+            index.insert(row.vehicle_ids[i], row.value);
+        }
+    }
+    return index;
+}();
+static_assert(VEHICLE_ID_INDEX.isValid(), "Duplicate vehicle ID");
+
+} // namespace detail
+
+/**
+ * Return the vehicle enum value for a given Census API vehicle ID.
+ *
+ * @param vehicle_id The Census API vehicle ID.
+ * @return The vehicle, or std::nullopt if the ID is unknown.
+ */
+constexpr std::optional<Vehicle> vehicle_from_vehicle_id(
+    arx::vehicle_id_t vehicle_id
+) {
+    return detail::VEHICLE_ID_INDEX.find(vehicle_id);
+}
+
+/**
+ * Return the display name for a given vehicle enum value.
+ *
+ * @param vehicle The vehicle enum value.
+ * @return The display name, or an empty string for Vehicle::None and
+ * invalid values.
+ */
+constexpr std::string_view vehicle_to_display_name(Vehicle vehicle) {
+    auto index = static_cast<std::size_t>(vehicle);
+    return index < VEHICLE_COUNT
+        ? VEHICLE_TABLE[index].display_name : std::string_view();
+}
+
+/**
+ * Return the Rich Presence image key for a given vehicle enum value.
+ *
+ * @param vehicle The vehicle enum value.
+ * @return The image key, or an empty string for Vehicle::None and invalid
+ * values.
+ */
+constexpr std::string_view vehicle_to_image_key(Vehicle vehicle) {
+    auto index = static_cast<std::size_t>(vehicle);
+    return index < VEHICLE_COUNT
+        ? VEHICLE_TABLE[index].image_key : std::string_view();
+}
+
 /**
  * Return the vehicle enum value for a given Census API vehicle ID.
  *
@@ -2,10 +2,16 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "arx/ps2-types.hpp"
 
+#include "lookup.hpp"
+
 namespace ps2 {
 
 /** Enumeration of playable zones in PlanetSide 2. */
@@ -21,6 +27,89 @@ enum class Zone {
     Sanctuary,
     Tutorial,
 };
+
+inline constexpr std::size_t ZONE_COUNT =
+    static_cast<std::size_t>(Zone::Tutorial) + 1;
+
+/**
+ * Static data for a zone.
+ *
+ * Some zones have several Census API IDs, e.g. one per faction; only the
+ * first id_count entries of zone_ids are used. Zones without a Rich
+ * Presence image have an empty image key.
+ */
+struct ZoneData {
+    Zone value;
+    std::string_view display_name;
+    std::string_view image_key;
+    std::size_t id_count;
+    std::array<arx::zone_id_t, 3> zone_ids;
+};
+
+inline constexpr std::array<ZoneData, ZONE_COUNT> ZONE_TABLE = {{
+    { Zone::Indar, "Indar", "indar", 1, { 2 } },
+    { Zone::Hossin, "Hossin", "hossin", 1, { 4 } },
+    { Zone::Amerish, "Amerish", "amerish", 1, { 6 } },
+    { Zone::Esamir, "Esamir", "esamir", 1, { 8 } },
+    { Zone::Koltyr, "Koltyr", "", 1, { 14 } },
+    { Zone::VrTraining, "VR Training", "", 3, { 96, 97, 98 } },
+    { Zone::Oshur, "Oshur", "oshur", 1, { 344 } },
+    { Zone::Desolation, "Desolation", "", 1, { 361 } },
+    { Zone::Sanctuary, "Sanctuary", "sanctuary", 1, { 362 } },
+    { Zone::Tutorial, "Tutorial", "", 1, { 364 } },
+}};
+static_assert(detail::isIndexedByEnum(ZONE_TABLE),
+    "ZONE_TABLE must list every zone once, in enum order");
+
+namespace detail {
+
+inline constexpr auto ZONE_ID_INDEX = [] {
+    IdIndex<Zone, 364> index;
+    for (const auto& row : ZONE_TABLE) {
+        for (std::size_t i = 0; i < row.id_count; ++i) {
+            index.insert(row.zone_ids[i], row.value);
+        }
+    }
+    return index;
+}();
+static_assert(ZONE_ID_INDEX.isValid(), "Duplicate zone ID");
+
+} // namespace detail
+
+/**
+ * Return the zone enum value for a given Census API zone ID.
+ *
+ * @param zone_id The Census API zone ID.
+ * @return The zone, or std::nullopt if the ID is unknown.
+ */
+constexpr std::optional<Zone> zone_from_zone_id(arx::zone_id_t zone_id) {
+    return detail::ZONE_ID_INDEX.find(zone_id);
+}
+
+/**
+ * Return the display name for a given zone enum value.
+ *
+ * @param zone The zone enum value.
+ * @return The display name, or an empty string for invalid values.
+ */
+constexpr std::string_view zone_to_display_name(Zone zone) {
+    auto index = static_cast<std::size_t>(zone);
+    return index < ZONE_COUNT
+        ? ZONE_TABLE[index].display_name : std::string_view();
+}
+
+/**
+ * Return the Rich Presence image key for a given zone enum value.
+ *
+ * @param zone The zone enum value.
+ * @return The image key, or an empty string if the zone has no image.
+ */
+constexpr std::string_view zone_to_image_key(Zone zone) {
+    auto index = static_cast<std::size_t>(zone);
+    return index < ZONE_COUNT
+        ? ZONE_TABLE[index].image_key : std::string_view();
+}
+
 /**
  * Return the zone enum value for a given Census API zone ID.
  *
@@ -29,6 +118,7 @@ enum class Zone {
  * @return 0 on success, -1 on failure.
  */
 int zone_from_zone_id(arx::zone_id_t zone_id, Zone* zone);
+
 /**
  * Return the display name for a given zone enum value.
  *
@@ -0,0 +1,71 @@
+// Copyright 2022 Leonhard S.
+
+// Local stand-in for the Census REST API. Point the app at it using
+//
+//     ps2-rich-presence --census-url http://localhost:8766
+//
+// to exercise character and reference data lookups without network
+// access or a service ID.
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <cstdint>
+#include <random>
+
+#include "stub-server.hpp"
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("census-stub");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Local stand-in for the PS2 Census REST API.");
+    parser.addHelpOption();
+    QCommandLineOption port_option("port",
+        "Listen on <port>.", "port", "8766");
+    QCommandLineOption data_option("data",
+        "Serve records from the <collection>.json files in <dir>.", "dir");
+    QCommandLineOption latency_option("latency",
+        "Delay every response by <ms> milliseconds.", "ms", "0");
+    QCommandLineOption error_option("error-rate",
+        "Answer <fraction> of all requests with an API error.", "fraction",
+        "0");
+    QCommandLineOption seed_option("seed",
+        "Seed for the random number generator.", "seed");
+    parser.addOptions({ port_option, data_option, latency_option,
+        error_option, seed_option });
+    parser.process(app);
+
+    bool port_ok = false;
+    bool latency_ok = false;
+    bool error_ok = false;
+    auto port = parser.value(port_option).toUShort(&port_ok);
+    auto latency = parser.value(latency_option).toInt(&latency_ok);
+    auto error_rate = parser.value(error_option).toDouble(&error_ok);
+    if (!port_ok || !latency_ok || latency < 0 || !error_ok
+        || error_rate < 0.0 || error_rate > 1.0) {
+        qCritical() << "Invalid numeric option, see --help";
+        return 1;
+    }
+    std::uint64_t seed = parser.isSet(seed_option)
+        ? parser.value(seed_option).toULongLong()
+        : std::random_device()();
+
+    CensusStub::StubServer server(seed);
+    if (parser.isSet(data_option)
+        && server.loadData(parser.value(data_option)) < 0) {
+        qCritical() << "Data directory not found:"
+            << parser.value(data_option);
+        return 1;
+    }
+    server.setLatency(latency);
+    server.setErrorRate(error_rate);
+    if (server.listen(port) != 0) {
+        return 1;
+    }
+    return app.exec();
+}
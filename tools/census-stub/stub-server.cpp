@@ -0,0 +1,317 @@
+// Copyright 2022 Leonhard S.
+
+#include "stub-server.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtCore/QUrlQuery>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+/** Requests with larger headers are rejected. */
+constexpr qsizetype MAX_HEADER_SIZE = 64 * 1024;
+
+struct SyntheticFaction {
+    const char* faction_id;
+    const char* profile_id;
+};
+
+// Light Assault profiles of each playable faction
+constexpr std::array<SyntheticFaction, 4> SYNTHETIC_FACTIONS = {{
+    { "1", "19" },
+    { "2", "4" },
+    { "3", "12" },
+    { "4", "191" },
+}};
+
+constexpr std::array<const char*, 6> SYNTHETIC_WORLDS = {
+    "1", "10", "13", "17", "19", "40"
+};
+
+QJsonObject syntheticCharacter(quint64 id, const QString& name) {
+    const auto& faction = SYNTHETIC_FACTIONS[id % SYNTHETIC_FACTIONS.size()];
+    QJsonObject character;
+    character["character_id"] = QString::number(id);
+    character["name"] = QJsonObject{
+        { "first", name },
+        { "first_lower", name.toLower() },
+    };
+    character["faction_id"] = faction.faction_id;
+    character["profile_id"] = faction.profile_id;
+    character["world"] = QJsonObject{
+        { "world_id", SYNTHETIC_WORLDS[id % SYNTHETIC_WORLDS.size()] },
+    };
+    return character;
+}
+
+QByteArray httpResponse(int status, const char* reason,
+    const QByteArray& body
+) {
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " "
+        + reason + "\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size())
+        + "\r\n\r\n";
+    response += body;
+    return response;
+}
+
+} // namespace
+
+namespace CensusStub {
+
+StubServer::StubServer(std::uint64_t seed, QObject* parent)
+    : QObject{ parent }
+    , server_{}
+    , stats_timer_{}
+    , buffers_{}
+    , collections_{}
+    , rng_{ seed }
+    , latency_ms_{ 0 }
+    , error_rate_{ 0.0 }
+    , connections_{ 0 }
+    , requests_{ 0 }
+    , errors_{ 0 }
+{
+    QObject::connect(&server_, &QTcpServer::newConnection,
+        this, &StubServer::onNewConnection);
+    stats_timer_.setInterval(STATS_INTERVAL);
+    QObject::connect(&stats_timer_, &QTimer::timeout,
+        this, &StubServer::onStatsTimerExpired);
+}
+
+int StubServer::loadData(const QString& path) {
+    QDir dir(path);
+    if (!dir.exists()) {
+        return -1;
+    }
+    int loaded = 0;
+    for (const auto& name : dir.entryList({ "*.json" }, QDir::Files)) {
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Unable to read" << file.fileName();
+            continue;
+        }
+        auto document = QJsonDocument::fromJson(file.readAll());
+        if (!document.isArray()) {
+            qWarning() << "Ignoring" << file.fileName()
+                << "- expected an array of records";
+            continue;
+        }
+        auto collection = name.chopped(5);
+        collections_.insert(collection, document.array());
+        qDebug() << "Loaded" << document.array().size() << collection
+            << "records";
+        ++loaded;
+    }
+    return loaded;
+}
+
+void StubServer::setLatency(int latency_ms) {
+    latency_ms_ = latency_ms;
+}
+
+void StubServer::setErrorRate(double error_rate) {
+    error_rate_ = error_rate;
+}
+
+int StubServer::listen(quint16 port) {
+    if (!server_.listen(QHostAddress::LocalHost, port)) {
+        qCritical() << "Unable to listen on port" << port << "-"
+            << server_.errorString();
+        return -1;
+    }
+    qDebug() << "Census stub listening on" << "http://localhost:" +
+        QString::number(server_.serverPort());
+    stats_timer_.start();
+    return 0;
+}
+
+void StubServer::onNewConnection() {
+    while (server_.hasPendingConnections()) {
+        auto socket = server_.nextPendingConnection();
+        ++connections_;
+        buffers_.insert(socket, QByteArray());
+        QObject::connect(socket, &QTcpSocket::readyRead, this,
+            [this, socket]() { handleData(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, this,
+            [this, socket]() {
+                buffers_.remove(socket);
+                socket->deleteLater();
+            });
+    }
+}
+
+void StubServer::onStatsTimerExpired() {
+    if (requests_ == 0) {
+        return;
+    }
+    qDebug() << requests_ << "requests over" << connections_
+        << "connections," << errors_ << "simulated errors";
+}
+
+void StubServer::handleData(QTcpSocket* socket) {
+    auto& buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+    // Pipelined requests are answered in the order they were received
+    while (true) {
+        auto header_end = buffer.indexOf("\r\n\r\n");
+        if (header_end < 0) {
+            if (buffer.size() > MAX_HEADER_SIZE) {
+                socket->disconnectFromHost();
+            }
+            return;
+        }
+        auto lines = buffer.left(header_end).split('\n');
+        buffer.remove(0, header_end + 4);
+        auto request_line = lines.front().trimmed().split(' ');
+        bool close = false;
+        for (qsizetype i = 1; i < lines.size(); ++i) {
+            auto line = lines[i].trimmed();
+            auto separator = line.indexOf(':');
+            if (separator < 0) {
+                continue;
+            }
+            auto name = line.left(separator).trimmed().toLower();
+            auto value = line.mid(separator + 1).trimmed().toLower();
+            if (name == "connection" && value == "close") {
+                close = true;
+            }
+        }
+        QByteArray response;
+        if (request_line.size() != 3) {
+            response = httpResponse(400, "Bad Request", "{}");
+        }
+        else {
+            response = handleRequest(request_line[0],
+                QUrl(QString::fromUtf8(request_line[1])));
+        }
+        auto write = [socket, response, close]() {
+            socket->write(response);
+            if (close) {
+                socket->disconnectFromHost();
+            }
+        };
+        if (latency_ms_ > 0) {
+            QTimer::singleShot(latency_ms_, socket, write);
+        }
+        else {
+            write();
+        }
+        if (close) {
+            return;
+        }
+    }
+}
+
+QByteArray StubServer::handleRequest(
+    const QByteArray& method,
+    const QUrl& url
+) {
+    ++requests_;
+    if (method != "GET") {
+        return httpResponse(405, "Method Not Allowed", "{}");
+    }
+    // Paths look like /s:<service_id>/get/<namespace>/<collection>
+    auto segments = url.path().split('/', Qt::SkipEmptyParts);
+    if (segments.size() != 4 || segments[1] != "get") {
+        return httpResponse(404, "Not Found", "{}");
+    }
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if (error_rate_ > 0.0 && chance(rng_) < error_rate_) {
+        // The real API reports overload in the payload, not the status
+        ++errors_;
+        return httpResponse(200, "OK",
+            R"({"error":"Service Unavailable: Too many requests"})");
+    }
+    const auto& collection = segments[3];
+    QUrlQuery query(url);
+    auto limit = query.queryItemValue("c:limit").toInt();
+    if (limit <= 0) {
+        limit = 1;
+    }
+    auto id_field = collection + "_id";
+    QJsonArray records;
+    if (query.hasQueryItem(id_field)) {
+        records = findRecords(collection, id_field,
+            query.queryItemValue(id_field).split(',', Qt::SkipEmptyParts));
+    }
+    else if (collection == "character"
+        && query.hasQueryItem("name.first_lower")) {
+        // Derive a stable ID from the name so repeated lookups agree
+        auto name = query.queryItemValue("name.first_lower");
+        auto id = 5428000000000000000ULL
+            + (static_cast<quint64>(qHash(name)) % 1000000000ULL);
+        if (!name.isEmpty()) {
+            name[0] = name[0].toUpper();
+            records.append(syntheticCharacter(id, name));
+        }
+    }
+    while (records.size() > limit) {
+        records.removeLast();
+    }
+    QJsonObject payload;
+    payload[collection + "_list"] = records;
+    payload["returned"] = records.size();
+    return httpResponse(200, "OK",
+        QJsonDocument(payload).toJson(QJsonDocument::Compact));
+}
+
+QJsonArray StubServer::findRecords(
+    const QString& collection,
+    const QString& id_field,
+    const QStringList& ids
+) const {
+    QJsonArray records;
+    auto data = collections_.value(collection);
+    for (const auto& id : ids) {
+        bool found = false;
+        for (const auto& record : data) {
+            if (record.toObject()[id_field].toString() == id) {
+                records.append(record);
+                found = true;
+                break;
+            }
+        }
+        if (!found && collection == "character") {
+            records.append(syntheticCharacter(
+                id.toULongLong(), "Stub" + id.right(6)));
+        }
+    }
+    return records;
+}
+
+} // namespace CensusStub
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_stub-server.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
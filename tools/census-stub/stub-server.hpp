@@ -0,0 +1,95 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <cstdint>
+#include <random>
+
+namespace CensusStub {
+
+/**
+ * Local stand-in for the Census REST API.
+ *
+ * Serves "get" queries over plain HTTP/1.1 with keep-alive and request
+ * pipelining. Records are taken from JSON files named after their
+ * collection, e.g. "zone.json" containing an array of zone objects, and
+ * filtered by the comma-separated ID term of the query. Characters not
+ * found in the data files are synthesised so any character ID resolves.
+ *
+ * Latency and transient API errors can be simulated to exercise client
+ * side connection reuse and retries.
+ */
+class StubServer: public QObject {
+    Q_OBJECT
+
+public:
+    /** Interval in milliseconds between statistics log lines. */
+    static constexpr int STATS_INTERVAL = 5000;
+
+    StubServer(std::uint64_t seed, QObject* parent = nullptr);
+    StubServer(const StubServer& other) = delete;
+    StubServer(StubServer&& other) noexcept = delete;
+
+    StubServer& operator=(const StubServer& other) = delete;
+    StubServer& operator=(StubServer&& other) noexcept = delete;
+
+    /**
+     * Load collection records from the JSON files in a directory.
+     *
+     * @param path The directory containing the data files.
+     * @return The number of collections loaded, or -1 if the directory
+     * does not exist.
+     */
+    int loadData(const QString& path);
+
+    /**
+     * Delay each response by the given number of milliseconds.
+     */
+    void setLatency(int latency_ms);
+
+    /**
+     * Answer the given fraction of requests with an API error payload.
+     */
+    void setErrorRate(double error_rate);
+
+    /**
+     * Start listening for clients.
+     *
+     * @param port The local port to listen on.
+     * @return 0 on success, -1 if the port could not be bound.
+     */
+    int listen(quint16 port);
+
+private Q_SLOTS:
+    void onNewConnection();
+    void onStatsTimerExpired();
+
+private:
+    void handleData(QTcpSocket* socket);
+    QByteArray handleRequest(const QByteArray& method, const QUrl& url);
+    QJsonArray findRecords(const QString& collection,
+        const QString& id_field, const QStringList& ids) const;
+
+    QTcpServer server_;
+    QTimer stats_timer_;
+    QHash<QTcpSocket*, QByteArray> buffers_;
+    QHash<QString, QJsonArray> collections_;
+    std::mt19937_64 rng_;
+    int latency_ms_;
+    double error_rate_;
+    std::uint64_t connections_;
+    std::uint64_t requests_;
+    std::uint64_t errors_;
+};
+
+} // namespace CensusStub
@@ -0,0 +1,83 @@
+// Copyright 2022 Leonhard S.
+
+// Local stand-in for the Discord client's RPC IPC socket. Start it, then
+// run the app with the IPC presence sink:
+//
+//     ps2-rich-presence --presence-sink ipc
+//
+// Both look for the socket in $XDG_RUNTIME_DIR (or $TMPDIR, $TMP, $TEMP,
+// /tmp) on Unix, so setting that to a scratch directory keeps the stub
+// from clashing with a running Discord client.
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QString>
+
+#include <cstdint>
+#include <random>
+
+#include "stub-server.hpp"
+
+namespace {
+
+QString defaultSocketName() {
+#if defined(Q_OS_WIN)
+    return "discord-ipc-0";
+#else
+    for (const char* variable :
+        { "XDG_RUNTIME_DIR", "TMPDIR", "TMP", "TEMP" }) {
+        auto value = qEnvironmentVariable(variable);
+        if (!value.isEmpty()) {
+            return value + "/discord-ipc-0";
+        }
+    }
+    return "/tmp/discord-ipc-0";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("discord-stub");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Local stand-in for the Discord client's RPC IPC socket.");
+    parser.addHelpOption();
+    QCommandLineOption socket_option("socket",
+        "Listen on the socket at <path>.", "path", defaultSocketName());
+    QCommandLineOption latency_option("latency",
+        "Delay every response by <ms> milliseconds.", "ms", "0");
+    QCommandLineOption error_option("error-rate",
+        "Reject <fraction> of all commands with an error.", "fraction",
+        "0");
+    QCommandLineOption seed_option("seed",
+        "Seed for the random number generator.", "seed");
+    parser.addOptions({ socket_option, latency_option, error_option,
+        seed_option });
+    parser.process(app);
+
+    bool latency_ok = false;
+    bool error_ok = false;
+    auto latency = parser.value(latency_option).toInt(&latency_ok);
+    auto error_rate = parser.value(error_option).toDouble(&error_ok);
+    if (!latency_ok || latency < 0 || !error_ok || error_rate < 0.0
+        || error_rate > 1.0) {
+        qCritical() << "Invalid numeric option, see --help";
+        return 1;
+    }
+    std::uint64_t seed = parser.isSet(seed_option)
+        ? parser.value(seed_option).toULongLong()
+        : std::random_device()();
+
+    DiscordStub::StubServer server(seed);
+    server.setLatency(latency);
+    server.setErrorRate(error_rate);
+    if (server.listen(parser.value(socket_option)) != 0) {
+        return 1;
+    }
+    return app.exec();
+}
@@ -0,0 +1,282 @@
+// Copyright 2022 Leonhard S.
+
+#include "stub-server.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <cstdint>
+#include <random>
+
+namespace {
+
+// Opcodes of the Discord RPC IPC protocol
+constexpr std::uint32_t OP_HANDSHAKE = 0;
+constexpr std::uint32_t OP_FRAME = 1;
+constexpr std::uint32_t OP_CLOSE = 2;
+constexpr std::uint32_t OP_PING = 3;
+constexpr std::uint32_t OP_PONG = 4;
+
+constexpr qsizetype HEADER_SIZE = 8;
+constexpr std::uint32_t MAX_PAYLOAD_SIZE = 64 * 1024;
+
+// Close codes used by the Discord client
+constexpr int CLOSE_INVALID_CLIENT_ID = 4000;
+constexpr int CLOSE_UNSUPPORTED_VERSION = 4004;
+constexpr int CLOSE_INVALID_FRAME = 4005;
+
+// Error codes of command responses
+constexpr int ERROR_UNKNOWN_COMMAND = 4000;
+constexpr int ERROR_INVALID_PAYLOAD = 4005;
+
+QByteArray encodeFrame(std::uint32_t opcode, const QByteArray& payload) {
+    QByteArray frame(HEADER_SIZE, Qt::Uninitialized);
+    auto* data = reinterpret_cast<uchar*>(frame.data());
+    qToLittleEndian(opcode, data);
+    qToLittleEndian(static_cast<std::uint32_t>(payload.size()), data + 4);
+    return frame + payload;
+}
+
+QJsonObject errorResponse(const QJsonObject& command, int code,
+    const QString& message
+) {
+    return QJsonObject{
+        { "cmd", command["cmd"] },
+        { "evt", "ERROR" },
+        { "nonce", command["nonce"] },
+        { "data", QJsonObject{ { "code", code }, { "message", message } } },
+    };
+}
+
+} // namespace
+
+namespace DiscordStub {
+
+StubServer::StubServer(std::uint64_t seed, QObject* parent)
+    : QObject{ parent }
+    , server_{}
+    , stats_timer_{}
+    , connections_{}
+    , rng_{ seed }
+    , latency_ms_{ 0 }
+    , error_rate_{ 0.0 }
+    , connection_count_{ 0 }
+    , activity_count_{ 0 }
+    , clear_count_{ 0 }
+    , errors_{ 0 }
+{
+    QObject::connect(&server_, &QLocalServer::newConnection,
+        this, &StubServer::onNewConnection);
+    stats_timer_.setInterval(STATS_INTERVAL);
+    QObject::connect(&stats_timer_, &QTimer::timeout,
+        this, &StubServer::onStatsTimerExpired);
+}
+
+void StubServer::setLatency(int latency_ms) {
+    latency_ms_ = latency_ms;
+}
+
+void StubServer::setErrorRate(double error_rate) {
+    error_rate_ = error_rate;
+}
+
+int StubServer::listen(const QString& name) {
+    // Sockets left behind by a previous run would make listen() fail
+    QLocalServer::removeServer(name);
+    if (!server_.listen(name)) {
+        qCritical() << "Unable to listen on" << name << "-"
+            << server_.errorString();
+        return -1;
+    }
+    qDebug() << "Discord stub listening on" << server_.fullServerName();
+    stats_timer_.start();
+    return 0;
+}
+
+void StubServer::onNewConnection() {
+    while (server_.hasPendingConnections()) {
+        auto socket = server_.nextPendingConnection();
+        ++connection_count_;
+        connections_.insert(socket, Connection{ QByteArray(), false });
+        QObject::connect(socket, &QLocalSocket::readyRead, this,
+            [this, socket]() { handleData(socket); });
+        QObject::connect(socket, &QLocalSocket::disconnected, this,
+            [this, socket]() {
+                connections_.remove(socket);
+                socket->deleteLater();
+            });
+    }
+}
+
+void StubServer::onStatsTimerExpired() {
+    if (activity_count_ == 0 && clear_count_ == 0) {
+        return;
+    }
+    qDebug() << activity_count_ << "activities and" << clear_count_
+        << "clears over" << connection_count_ << "connections," << errors_
+        << "simulated errors";
+}
+
+void StubServer::handleData(QLocalSocket* socket) {
+    auto& buffer = connections_[socket].buffer_;
+    buffer.append(socket->readAll());
+    while (buffer.size() >= HEADER_SIZE) {
+        const auto* data = reinterpret_cast<const uchar*>(buffer.constData());
+        auto opcode = qFromLittleEndian<std::uint32_t>(data);
+        auto length = qFromLittleEndian<std::uint32_t>(data + 4);
+        if (length > MAX_PAYLOAD_SIZE) {
+            send(socket, OP_CLOSE, QJsonObject{
+                { "code", CLOSE_INVALID_FRAME },
+                { "message", "Frame too large" },
+            });
+            socket->disconnectFromServer();
+            return;
+        }
+        auto size = static_cast<qsizetype>(length);
+        if (buffer.size() < HEADER_SIZE + size) {
+            return;
+        }
+        auto payload = buffer.mid(HEADER_SIZE, size);
+        buffer.remove(0, HEADER_SIZE + size);
+        handleFrame(socket, opcode, payload);
+        if (!connections_.contains(socket)) {
+            return;
+        }
+    }
+}
+
+void StubServer::handleFrame(
+    QLocalSocket* socket,
+    std::uint32_t opcode,
+    const QByteArray& payload
+) {
+    auto message = QJsonDocument::fromJson(payload).object();
+    auto& connection = connections_[socket];
+    if (!connection.handshaken_) {
+        if (opcode != OP_HANDSHAKE || message["v"].toInt() != 1) {
+            send(socket, OP_CLOSE, QJsonObject{
+                { "code", CLOSE_UNSUPPORTED_VERSION },
+                { "message", "Expected a version 1 handshake" },
+            });
+            socket->disconnectFromServer();
+            return;
+        }
+        if (message["client_id"].toString().isEmpty()) {
+            send(socket, OP_CLOSE, QJsonObject{
+                { "code", CLOSE_INVALID_CLIENT_ID },
+                { "message", "Invalid Client ID" },
+            });
+            socket->disconnectFromServer();
+            return;
+        }
+        connection.handshaken_ = true;
+        qDebug() << "Client" << message["client_id"].toString()
+            << "connected";
+        send(socket, OP_FRAME, QJsonObject{
+            { "cmd", "DISPATCH" },
+            { "evt", "READY" },
+            { "data", QJsonObject{
+                { "v", 1 },
+                { "user", QJsonObject{
+                    { "id", "0" },
+                    { "username", "stub" },
+                } },
+            } },
+        });
+        return;
+    }
+    switch (opcode) {
+    case OP_FRAME: {
+        auto response = handleCommand(message);
+        if (latency_ms_ > 0) {
+            QTimer::singleShot(latency_ms_, socket,
+                [this, socket, response]() {
+                    send(socket, OP_FRAME, response);
+                });
+        }
+        else {
+            send(socket, OP_FRAME, response);
+        }
+        break;
+    }
+    case OP_PING:
+        socket->write(encodeFrame(OP_PONG, payload));
+        break;
+    case OP_CLOSE:
+        socket->disconnectFromServer();
+        break;
+    default:
+        break;
+    }
+}
+
+QJsonObject StubServer::handleCommand(const QJsonObject& command) {
+    if (command["cmd"].toString() != "SET_ACTIVITY") {
+        return errorResponse(command, ERROR_UNKNOWN_COMMAND,
+            "Unknown command: " + command["cmd"].toString());
+    }
+    auto args = command["args"].toObject();
+    if (!args["pid"].isDouble()) {
+        return errorResponse(command, ERROR_INVALID_PAYLOAD,
+            "Missing pid");
+    }
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if (error_rate_ > 0.0 && chance(rng_) < error_rate_) {
+        ++errors_;
+        return errorResponse(command, ERROR_INVALID_PAYLOAD,
+            "Simulated error");
+    }
+    auto activity = args["activity"].toObject();
+    if (activity.isEmpty()) {
+        ++clear_count_;
+        qDebug() << "Cleared activity";
+    }
+    else {
+        ++activity_count_;
+        qDebug().noquote() << "Activity:"
+            << QJsonDocument(activity).toJson(QJsonDocument::Compact);
+    }
+    return QJsonObject{
+        { "cmd", "SET_ACTIVITY" },
+        { "evt", QJsonValue::Null },
+        { "nonce", command["nonce"] },
+        { "data", activity.isEmpty()
+            ? QJsonValue(QJsonValue::Null) : QJsonValue(activity) },
+    };
+}
+
+void StubServer::send(
+    QLocalSocket* socket,
+    std::uint32_t opcode,
+    const QJsonObject& message
+) {
+    socket->write(encodeFrame(opcode,
+        QJsonDocument(message).toJson(QJsonDocument::Compact)));
+}
+
+} // namespace DiscordStub
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_stub-server.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
@@ -0,0 +1,90 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <cstdint>
+#include <random>
+
+namespace DiscordStub {
+
+/**
+ * Local stand-in for the Discord client's RPC IPC socket.
+ *
+ * Accepts the handshake of any client ID and answers SET_ACTIVITY
+ * commands, logging every activity received. Other commands are answered
+ * with an error, as the real client does for unauthorised ones.
+ *
+ * Latency and rejected commands can be simulated to exercise the
+ * client's request coalescing and error handling.
+ */
+class StubServer: public QObject {
+    Q_OBJECT
+
+public:
+    /** Interval in milliseconds between statistics log lines. */
+    static constexpr int STATS_INTERVAL = 5000;
+
+    StubServer(std::uint64_t seed, QObject* parent = nullptr);
+    StubServer(const StubServer& other) = delete;
+    StubServer(StubServer&& other) noexcept = delete;
+
+    StubServer& operator=(const StubServer& other) = delete;
+    StubServer& operator=(StubServer&& other) noexcept = delete;
+
+    /**
+     * Delay each response by the given number of milliseconds.
+     */
+    void setLatency(int latency_ms);
+
+    /**
+     * Reject the given fraction of commands with an error response.
+     */
+    void setErrorRate(double error_rate);
+
+    /**
+     * Start listening for clients.
+     *
+     * @param name The socket path, or pipe name on Windows.
+     * @return 0 on success, -1 if the socket could not be created.
+     */
+    int listen(const QString& name);
+
+private Q_SLOTS:
+    void onNewConnection();
+    void onStatsTimerExpired();
+
+private:
+    struct Connection {
+        QByteArray buffer_;
+        bool handshaken_;
+    };
+
+    void handleData(QLocalSocket* socket);
+    void handleFrame(QLocalSocket* socket, std::uint32_t opcode,
+        const QByteArray& payload);
+    QJsonObject handleCommand(const QJsonObject& command);
+    void send(QLocalSocket* socket, std::uint32_t opcode,
+        const QJsonObject& message);
+
+    QLocalServer server_;
+    QTimer stats_timer_;
+    QHash<QLocalSocket*, Connection> connections_;
+    std::mt19937_64 rng_;
+    int latency_ms_;
+    double error_rate_;
+    std::uint64_t connection_count_;
+    std::uint64_t activity_count_;
+    std::uint64_t clear_count_;
+    std::uint64_t errors_;
+};
+
+} // namespace DiscordStub
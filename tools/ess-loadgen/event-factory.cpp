@@ -0,0 +1,393 @@
+// Copyright 2022 Leonhard S.
+
+#include "event-factory.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+namespace {
+
+// Characters in the pool get IDs in the range of real PS2 characters
+constexpr arx::character_id_t CHARACTER_ID_BASE = 5428000000000000000ULL;
+
+// World names used in heartbeat messages
+const char* worldName(arx::world_id_t world_id) {
+    switch (world_id) {
+    case 1:
+        return "Connery";
+    case 10:
+        return "Miller";
+    case 13:
+        return "Cobalt";
+    case 17:
+        return "Emerald";
+    case 19:
+        return "Jaeger";
+    case 40:
+        return "SolTech";
+    default:
+        return "World";
+    }
+}
+
+std::string toString(std::uint64_t value) {
+    return std::to_string(value);
+}
+
+template <typename T>
+T pick(std::mt19937_64& rng, const std::vector<T>& values) {
+    std::uniform_int_distribution<std::size_t> index(0, values.size() - 1);
+    return values[index(rng)];
+}
+
+std::uint64_t randomId(std::mt19937_64& rng, std::uint64_t max) {
+    return std::uniform_int_distribution<std::uint64_t>(1, max)(rng);
+}
+
+std::vector<arx::string_t> toStrings(const arx::json_t& values) {
+    std::vector<arx::string_t> strings;
+    if (!values.is_array()) {
+        return strings;
+    }
+    for (const auto& value : values) {
+        if (value.is_string()) {
+            strings.push_back(value.get<arx::string_t>());
+        }
+    }
+    return strings;
+}
+
+template <typename T>
+bool parseInteger(std::string_view text, T* value) {
+    auto [ptr, ec] = std::from_chars(
+        text.data(), text.data() + text.size(), *value);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+} // namespace
+
+namespace LoadGen {
+
+LoadProfile defaultLoadProfile() {
+    return LoadProfile{
+        {
+            { arx::Event::GainExperience, 80.0 },
+            { arx::Event::Death, 10.0 },
+            { arx::Event::VehicleDestroy, 5.0 },
+            { arx::Event::PlayerFacilityDefend, 2.0 },
+            { arx::Event::PlayerFacilityCapture, 1.0 },
+            { arx::Event::PlayerLogin, 1.0 },
+            { arx::Event::PlayerLogout, 1.0 },
+        },
+        { 1, 10, 13, 17, 19, 40 },
+        10000,
+        0.0,
+    };
+}
+
+int parseEventMix(
+    const arx::string_t& mix,
+    std::vector<std::pair<arx::Event, double>>* weights
+) {
+    std::vector<std::pair<arx::Event, double>> result;
+    std::string_view rest = mix;
+    while (!rest.empty()) {
+        auto end = rest.find(',');
+        auto item = rest.substr(0, end);
+        rest = end == std::string_view::npos
+            ? std::string_view() : rest.substr(end + 1);
+        auto colon = item.find(':');
+        if (colon == std::string_view::npos) {
+            return -1;
+        }
+        auto event = arx::eventFromEventName(item.substr(0, colon));
+        double weight = 0.0;
+        try {
+            weight = std::stod(std::string(item.substr(colon + 1)));
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+        if (event == arx::Event::Unknown || weight < 0.0) {
+            return -1;
+        }
+        result.emplace_back(event, weight);
+    }
+    if (result.empty()) {
+        return -1;
+    }
+    *weights = std::move(result);
+    return 0;
+}
+
+SubscriptionFilter::SubscriptionFilter()
+    : all_events_{ false }
+    , all_characters_{ false }
+    , all_worlds_{ false }
+    , logical_and_{ false }
+    , events_{}
+    , characters_{}
+    , worlds_{} {}
+
+int SubscriptionFilter::apply(const arx::json_t& message) {
+    auto action = message.find("action");
+    if (action == message.end() || !action->is_string()) {
+        return -1;
+    }
+    bool subscribe = *action == "subscribe";
+    if (!subscribe && *action != "clearSubscribe") {
+        return -1;
+    }
+    auto all = message.find("all");
+    if (!subscribe && all != message.end() && *all == "true") {
+        clear();
+        return 0;
+    }
+    for (const auto& name : toStrings(message.value("eventNames",
+        arx::json_t::array()))) {
+        if (name == "all") {
+            all_events_ = subscribe;
+            continue;
+        }
+        auto event = arx::eventFromEventName(name);
+        if (subscribe) {
+            events_.insert(event);
+        }
+        else {
+            events_.erase(event);
+        }
+    }
+    for (const auto& id : toStrings(message.value("characters",
+        arx::json_t::array()))) {
+        if (id == "all") {
+            all_characters_ = subscribe;
+            continue;
+        }
+        arx::character_id_t character_id = 0;
+        if (!parseInteger(id, &character_id)) {
+            continue;
+        }
+        auto it = std::find(
+            characters_.begin(), characters_.end(), character_id);
+        if (subscribe && it == characters_.end()) {
+            characters_.push_back(character_id);
+        }
+        else if (!subscribe && it != characters_.end()) {
+            characters_.erase(it);
+        }
+    }
+    for (const auto& id : toStrings(message.value("worlds",
+        arx::json_t::array()))) {
+        if (id == "all") {
+            all_worlds_ = subscribe;
+            continue;
+        }
+        arx::world_id_t world_id = 0;
+        if (!parseInteger(id, &world_id)) {
+            continue;
+        }
+        if (subscribe) {
+            worlds_.insert(world_id);
+        }
+        else {
+            worlds_.erase(world_id);
+        }
+    }
+    auto logical_and = message.find("logicalAndCharactersWithWorlds");
+    if (subscribe && logical_and != message.end()
+        && logical_and->is_boolean()) {
+        logical_and_ = logical_and->get<bool>();
+    }
+    return 0;
+}
+
+bool SubscriptionFilter::isEmpty() const {
+    if (!all_events_ && events_.empty()) {
+        return true;
+    }
+    return !all_characters_ && characters_.empty()
+        && !all_worlds_ && worlds_.empty();
+}
+
+bool SubscriptionFilter::matchesEvent(arx::Event event) const {
+    return all_events_ || events_.contains(event);
+}
+
+arx::json_t SubscriptionFilter::buildEcho() const {
+    arx::json_t event_names = arx::json_t::array();
+    if (all_events_) {
+        event_names.push_back("all");
+    }
+    for (auto event : events_) {
+        event_names.push_back(arx::eventToEventName(event));
+    }
+    arx::json_t worlds = arx::json_t::array();
+    if (all_worlds_) {
+        worlds.push_back("all");
+    }
+    for (auto world_id : worlds_) {
+        worlds.push_back(toString(world_id));
+    }
+    arx::json_t echo;
+    echo["subscription"]["characterCount"] = all_characters_
+        ? 0 : characters_.size();
+    echo["subscription"]["eventNames"] = event_names;
+    echo["subscription"]["logicalAndCharactersWithWorlds"] = logical_and_;
+    echo["subscription"]["worlds"] = worlds;
+    return echo;
+}
+
+void SubscriptionFilter::clear() {
+    all_events_ = false;
+    all_characters_ = false;
+    all_worlds_ = false;
+    logical_and_ = false;
+    events_.clear();
+    characters_.clear();
+    worlds_.clear();
+}
+
+EventFactory::EventFactory(const LoadProfile& profile, std::uint64_t seed)
+    : profile_{ profile }
+    , rng_{ seed }
+    , character_distribution_{}
+{
+    std::vector<double> weights(std::max<std::size_t>(
+        profile_.character_pool_size_, 1));
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = 1.0 / std::pow(static_cast<double>(i + 1),
+            profile_.character_skew_);
+    }
+    character_distribution_ = std::discrete_distribution<std::size_t>(
+        weights.begin(), weights.end());
+}
+
+int EventFactory::makeEvent(
+    const SubscriptionFilter& filter,
+    std::int64_t timestamp,
+    arx::string_t* frame
+) {
+    // Restrict the event mix to the subscribed events
+    std::vector<arx::Event> events;
+    std::vector<double> weights;
+    for (const auto& [event, weight] : profile_.event_weights_) {
+        if (filter.matchesEvent(event)) {
+            events.push_back(event);
+            weights.push_back(weight);
+        }
+    }
+    if (events.empty() || filter.isEmpty()) {
+        return -1;
+    }
+    std::discrete_distribution<std::size_t> event_distribution(
+        weights.begin(), weights.end());
+    auto event = events[event_distribution(rng_)];
+    auto character_id = pickCharacter(filter);
+    arx::json_t payload;
+    payload["event_name"] = arx::eventToEventName(event);
+    payload["character_id"] = toString(character_id);
+    payload["timestamp"] = std::to_string(timestamp);
+    payload["world_id"] = toString(pickWorld(filter));
+    payload["zone_id"] = toString(pick(rng_,
+        std::vector<std::uint64_t>{ 2, 4, 6, 8, 344 }));
+    switch (event) {
+    case arx::Event::Death:
+    case arx::Event::VehicleDestroy:
+        payload["attacker_character_id"] = toString(pickPoolCharacter());
+        payload["attacker_loadout_id"] = toString(randomId(rng_, 32));
+        payload["attacker_team_id"] = toString(randomId(rng_, 4));
+        payload["attacker_vehicle_id"] = toString(
+            event == arx::Event::VehicleDestroy ? randomId(rng_, 15) : 0);
+        payload["attacker_weapon_id"] = toString(randomId(rng_, 80000));
+        payload["team_id"] = toString(randomId(rng_, 4));
+        if (event == arx::Event::Death) {
+            payload["attacker_fire_mode_id"] = toString(
+                randomId(rng_, 100000));
+            payload["character_loadout_id"] = toString(randomId(rng_, 32));
+            payload["is_critical"] = "0";
+            payload["is_headshot"] = toString(randomId(rng_, 4) == 1);
+            payload["vehicle_id"] = "0";
+        }
+        else {
+            payload["facility_id"] = "0";
+            payload["faction_id"] = toString(randomId(rng_, 4));
+            payload["vehicle_id"] = toString(randomId(rng_, 15));
+        }
+        break;
+    case arx::Event::GainExperience:
+        payload["amount"] = toString(randomId(rng_, 500));
+        payload["experience_id"] = toString(randomId(rng_, 2000));
+        payload["loadout_id"] = toString(randomId(rng_, 32));
+        payload["other_id"] = toString(pickPoolCharacter());
+        payload["team_id"] = toString(randomId(rng_, 4));
+        break;
+    case arx::Event::PlayerFacilityCapture:
+    case arx::Event::PlayerFacilityDefend:
+        payload["facility_id"] = toString(randomId(rng_, 400000));
+        payload["outfit_id"] = toString(randomId(rng_, 1000000));
+        break;
+    default:
+        break;
+    }
+    arx::json_t message;
+    message["payload"] = std::move(payload);
+    message["service"] = "event";
+    message["type"] = "serviceMessage";
+    *frame = message.dump();
+    return 0;
+}
+
+arx::string_t EventFactory::makeHeartbeat() const {
+    arx::json_t online = arx::json_t::object();
+    for (auto world_id : profile_.worlds_) {
+        online[arx::string_t("EventServerEndpoint_") + worldName(world_id)
+            + "_" + toString(world_id)] = "true";
+    }
+    arx::json_t message;
+    message["online"] = std::move(online);
+    message["service"] = "event";
+    message["type"] = "heartbeat";
+    return message.dump();
+}
+
+arx::string_t EventFactory::makeConnectionStateChanged() {
+    return R"({"connected":"true","service":"push",)"
+        R"("type":"connectionStateChanged"})";
+}
+
+arx::character_id_t EventFactory::pickCharacter(
+    const SubscriptionFilter& filter
+) {
+    // Explicit characters take precedence; they are what the app uses
+    if (!filter.all_characters_ && !filter.characters_.empty()) {
+        return pick(rng_, filter.characters_);
+    }
+    return pickPoolCharacter();
+}
+
+arx::character_id_t EventFactory::pickPoolCharacter() {
+    return CHARACTER_ID_BASE + character_distribution_(rng_);
+}
+
+arx::world_id_t EventFactory::pickWorld(const SubscriptionFilter& filter) {
+    if (!filter.all_worlds_ && !filter.worlds_.empty()) {
+        return pick(rng_, std::vector<arx::world_id_t>(
+            filter.worlds_.begin(), filter.worlds_.end()));
+    }
+    return pick(rng_, profile_.worlds_);
+}
+
+} // namespace LoadGen
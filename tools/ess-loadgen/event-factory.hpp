@@ -0,0 +1,126 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+namespace LoadGen {
+
+/**
+ * Shape of the generated event stream.
+ */
+struct LoadProfile {
+    /** Relative weight of every event type to generate. */
+    std::vector<std::pair<arx::Event, double>> event_weights_;
+    /** Worlds to generate events for, unless subscribed to specific ones. */
+    std::vector<arx::world_id_t> worlds_;
+    /** Number of distinct characters for "all" character subscriptions. */
+    std::size_t character_pool_size_;
+    /**
+     * Zipf exponent of the character distribution; 0 picks characters
+     * uniformly, larger values concentrate events on fewer characters.
+     */
+    double character_skew_;
+};
+
+/**
+ * Default event mix, roughly matching a busy world.
+ */
+LoadProfile defaultLoadProfile();
+
+/**
+ * Parse an event mix of the form "Death:10,GainExperience:80".
+ *
+ * @param mix The event mix to parse.
+ * @param weights The event weights to be populated.
+ * @return 0 on success, -1 if the mix is malformed or names an unknown
+ * event.
+ */
+int parseEventMix(
+    const arx::string_t& mix,
+    std::vector<std::pair<arx::Event, double>>* weights);
+
+/**
+ * Server-side view of a client's ESS subscription.
+ *
+ * Mirrors the union semantics of the ESS: subscribe messages add to the
+ * current subscription, clearSubscribe messages remove from it.
+ */
+class SubscriptionFilter {
+public:
+    SubscriptionFilter();
+
+    /**
+     * Apply a subscribe or clearSubscribe message.
+     *
+     * @param message The message received from the client.
+     * @return 0 on success, -1 if the message is not a subscription
+     * action.
+     */
+    int apply(const arx::json_t& message);
+
+    bool isEmpty() const;
+    bool matchesEvent(arx::Event event) const;
+
+    /**
+     * Build the subscription echo sent in response to subscription
+     * changes.
+     */
+    arx::json_t buildEcho() const;
+
+    bool all_events_;
+    bool all_characters_;
+    bool all_worlds_;
+    bool logical_and_;
+    std::set<arx::Event> events_;
+    std::vector<arx::character_id_t> characters_;
+    std::set<arx::world_id_t> worlds_;
+
+private:
+    void clear();
+};
+
+/**
+ * Generates ESS frames for a load profile.
+ */
+class EventFactory {
+public:
+    EventFactory(const LoadProfile& profile, std::uint64_t seed);
+
+    /**
+     * Generate a random service message matching the given subscription.
+     *
+     * @param filter The subscription of the receiving client.
+     * @param timestamp The event timestamp in seconds since the epoch.
+     * @param frame The serialised frame to be populated.
+     * @return 0 on success, -1 if the subscription matches none of the
+     * events in the profile.
+     */
+    int makeEvent(
+        const SubscriptionFilter& filter,
+        std::int64_t timestamp,
+        arx::string_t* frame);
+
+    arx::string_t makeHeartbeat() const;
+
+    static arx::string_t makeConnectionStateChanged();
+
+private:
+    arx::character_id_t pickCharacter(const SubscriptionFilter& filter);
+    arx::character_id_t pickPoolCharacter();
+    arx::world_id_t pickWorld(const SubscriptionFilter& filter);
+
+    LoadProfile profile_;
+    std::mt19937_64 rng_;
+    std::discrete_distribution<std::size_t> character_distribution_;
+};
+
+} // namespace LoadGen
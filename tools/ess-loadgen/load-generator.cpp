@@ -0,0 +1,204 @@
+// Copyright 2022 Leonhard S.
+
+#include "load-generator.hpp"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtNetwork/QHostAddress>
+#include <QtWebSockets/QWebSocket>
+#include <QtWebSockets/QWebSocketServer>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "event-factory.hpp"
+
+namespace LoadGen {
+
+LoadGenerator::LoadGenerator(
+    const LoadProfile& profile,
+    std::uint64_t seed,
+    QObject* parent
+)
+    : QObject{ parent }
+    , server_{ "ess-loadgen", QWebSocketServer::NonSecureMode }
+    , clients_{}
+    , factory_{ profile, seed }
+    , rate_{ 1000.0 }
+    , clock_{}
+    , tick_timer_{}
+    , heartbeat_timer_{}
+    , stats_timer_{}
+    , events_sent_{ 0 }
+    , bytes_sent_{ 0 }
+{
+    QObject::connect(&server_, &QWebSocketServer::newConnection,
+        this, &LoadGenerator::onNewConnection);
+    tick_timer_.setTimerType(Qt::PreciseTimer);
+    tick_timer_.setInterval(TICK_INTERVAL);
+    QObject::connect(&tick_timer_, &QTimer::timeout,
+        this, &LoadGenerator::onTick);
+    heartbeat_timer_.setInterval(30000);
+    QObject::connect(&heartbeat_timer_, &QTimer::timeout,
+        this, &LoadGenerator::onHeartbeat);
+    stats_timer_.setInterval(1000);
+    QObject::connect(&stats_timer_, &QTimer::timeout,
+        this, &LoadGenerator::onReportStats);
+}
+
+int LoadGenerator::listen(quint16 port) {
+    if (!server_.listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Unable to listen on port" << port << "-"
+            << server_.errorString();
+        return -1;
+    }
+    qInfo().noquote() << "Listening on" << server_.serverUrl().toString();
+    clock_.start();
+    tick_timer_.start();
+    heartbeat_timer_.start();
+    stats_timer_.start();
+    return 0;
+}
+
+void LoadGenerator::setRate(double events_per_second) {
+    rate_ = events_per_second;
+}
+
+void LoadGenerator::setHeartbeatInterval(int interval) {
+    heartbeat_timer_.setInterval(interval);
+}
+
+void LoadGenerator::onNewConnection() {
+    while (auto socket = server_.nextPendingConnection()) {
+        QObject::connect(socket, &QWebSocket::disconnected,
+            this, &LoadGenerator::onClientDisconnected);
+        QObject::connect(socket, &QWebSocket::textMessageReceived,
+            this, &LoadGenerator::onTextMessageReceived);
+        // Clients start sending events from the current point in time
+        auto elapsed = static_cast<double>(clock_.nsecsElapsed()) / 1e9;
+        clients_.insert(socket, ClientState{ SubscriptionFilter(),
+            static_cast<std::int64_t>(std::floor(elapsed * rate_)) });
+        socket->sendTextMessage(QString::fromStdString(
+            EventFactory::makeConnectionStateChanged()));
+        qInfo() << "Client connected from"
+            << socket->peerAddress().toString();
+    }
+}
+
+void LoadGenerator::onClientDisconnected() {
+    auto socket = qobject_cast<QWebSocket*>(sender());
+    if (socket == nullptr) {
+        return;
+    }
+    clients_.remove(socket);
+    socket->deleteLater();
+    qInfo() << "Client disconnected";
+}
+
+void LoadGenerator::onTextMessageReceived(const QString& message) {
+    auto socket = qobject_cast<QWebSocket*>(sender());
+    auto it = clients_.find(socket);
+    if (it == clients_.end()) {
+        return;
+    }
+    auto json = arx::json_t::parse(message.toStdString(), nullptr, false);
+    if (json.is_discarded()) {
+        qWarning() << "Ignoring malformed message:" << message;
+        return;
+    }
+    // Like the real service, echo commands are sent back verbatim
+    if (json.value("action", "") == "echo") {
+        auto payload = json.find("payload");
+        if (payload != json.end()) {
+            socket->sendTextMessage(
+                QString::fromStdString(payload->dump()));
+        }
+        return;
+    }
+    if (it->filter_.apply(json) != 0) {
+        qWarning() << "Ignoring unsupported message:" << message;
+        return;
+    }
+    socket->sendTextMessage(QString::fromStdString(
+        it->filter_.buildEcho().dump()));
+}
+
+void LoadGenerator::onTick() {
+    auto elapsed = static_cast<double>(clock_.nsecsElapsed()) / 1e9;
+    auto target = static_cast<std::int64_t>(std::floor(elapsed * rate_));
+    auto timestamp = QDateTime::currentSecsSinceEpoch();
+    arx::string_t frame;
+    for (auto it = clients_.begin(); it != clients_.end(); ++it) {
+        auto& client = it.value();
+        // Skip any events that could not be sent in time, e.g. while the
+        // client was not subscribed to anything.
+        client.sent_ = std::max(client.sent_,
+            target - MAX_EVENTS_PER_TICK);
+        if (client.filter_.isEmpty()) {
+            client.sent_ = target;
+            continue;
+        }
+        while (client.sent_ < target) {
+            if (factory_.makeEvent(client.filter_, timestamp, &frame) != 0) {
+                client.sent_ = target;
+                break;
+            }
+            it.key()->sendTextMessage(QString::fromStdString(frame));
+            ++client.sent_;
+            ++events_sent_;
+            bytes_sent_ += static_cast<std::int64_t>(frame.size());
+        }
+    }
+}
+
+void LoadGenerator::onHeartbeat() {
+    auto message = QString::fromStdString(factory_.makeHeartbeat());
+    for (auto it = clients_.cbegin(); it != clients_.cend(); ++it) {
+        it.key()->sendTextMessage(message);
+    }
+}
+
+void LoadGenerator::onReportStats() {
+    if (clients_.isEmpty()) {
+        return;
+    }
+    qint64 backlog = 0;
+    for (auto it = clients_.cbegin(); it != clients_.cend(); ++it) {
+        backlog += it.key()->bytesToWrite();
+    }
+    qInfo().noquote() << QString(
+        "%1 clients, %2 events/s, %3 KiB/s, %4 KiB unsent")
+        .arg(clients_.size())
+        .arg(events_sent_)
+        .arg(bytes_sent_ / 1024)
+        .arg(backlog / 1024);
+    events_sent_ = 0;
+    bytes_sent_ = 0;
+}
+
+} // namespace LoadGen
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(push)
+#   pragma warning(disable : 4464)
+#elif defined(__clang__)
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
+#include "moc_load-generator.cpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   pragma warning(pop)
+#elif defined(__clang__)
+#   pragma clang diagnostic pop
+#endif
@@ -0,0 +1,93 @@
+// Copyright 2022 Leonhard S.
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtWebSockets/QWebSocket>
+#include <QtWebSockets/QWebSocketServer>
+
+#include <cstdint>
+
+#include "event-factory.hpp"
+
+namespace LoadGen {
+
+/**
+ * Local stand-in for the ESS endpoint.
+ *
+ * Accepts any number of WebSocket clients and tracks their subscriptions
+ * like the real service. Every client with a non-empty subscription
+ * receives service messages matching it at the configured rate, as well
+ * as regular heartbeats.
+ */
+class LoadGenerator: public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * Interval in milliseconds between batches of generated events.
+     */
+    static constexpr int TICK_INTERVAL = 1;
+
+    /**
+     * Upper bound for the events sent to a client per tick, so a stalled
+     * event loop does not result in an unbounded burst.
+     */
+    static constexpr std::int64_t MAX_EVENTS_PER_TICK = 1000;
+
+    LoadGenerator(const LoadProfile& profile, std::uint64_t seed,
+        QObject* parent = nullptr);
+    LoadGenerator(const LoadGenerator& other) = delete;
+    LoadGenerator(LoadGenerator&& other) noexcept = delete;
+
+    LoadGenerator& operator=(const LoadGenerator& other) = delete;
+    LoadGenerator& operator=(LoadGenerator&& other) noexcept = delete;
+
+    /**
+     * Start listening for clients.
+     *
+     * @param port The local port to listen on.
+     * @return 0 on success, -1 if the port could not be bound.
+     */
+    int listen(quint16 port);
+
+    /**
+     * Set the number of events sent to each client per second.
+     */
+    void setRate(double events_per_second);
+
+    /**
+     * Set the interval between heartbeat messages in milliseconds.
+     */
+    void setHeartbeatInterval(int interval);
+
+private Q_SLOTS:
+    void onNewConnection();
+    void onClientDisconnected();
+    void onTextMessageReceived(const QString& message);
+    void onTick();
+    void onHeartbeat();
+    void onReportStats();
+
+private:
+    struct ClientState {
+        SubscriptionFilter filter_;
+        std::int64_t sent_;
+    };
+
+    QWebSocketServer server_;
+    QHash<QWebSocket*, ClientState> clients_;
+    EventFactory factory_;
+    double rate_;
+    QElapsedTimer clock_;
+    QTimer tick_timer_;
+    QTimer heartbeat_timer_;
+    QTimer stats_timer_;
+    std::int64_t events_sent_;
+    std::int64_t bytes_sent_;
+};
+
+} // namespace LoadGen
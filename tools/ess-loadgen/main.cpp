@@ -0,0 +1,122 @@
+// Copyright 2022 Leonhard S.
+
+// Synthetic ESS load generator. Point the app at it using
+//
+//     ps2-rich-presence --ess-url ws://localhost:8765/streaming
+//
+// to test the ingestion pipeline at arbitrary event rates without network
+// access.
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "arx.hpp"
+#include "arx/ess.hpp"
+
+#include "event-factory.hpp"
+#include "load-generator.hpp"
+
+namespace {
+
+int parseWorlds(const QString& text, std::vector<arx::world_id_t>* worlds) {
+    std::vector<arx::world_id_t> result;
+    for (const auto& item : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        auto world_id = item.trimmed().toUInt(&ok);
+        if (!ok || world_id == 0 || world_id > 255) {
+            return -1;
+        }
+        result.push_back(static_cast<arx::world_id_t>(world_id));
+    }
+    if (result.empty()) {
+        return -1;
+    }
+    *worlds = std::move(result);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ess-loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Local stand-in for the PS2 event streaming service.");
+    parser.addHelpOption();
+    QCommandLineOption port_option("port",
+        "Listen on <port>.", "port", "8765");
+    QCommandLineOption rate_option("rate",
+        "Send <events> events per second to each client.", "events", "1000");
+    QCommandLineOption characters_option("characters",
+        "Draw events for \"all\" character subscriptions from <count> "
+        "characters.", "count", "10000");
+    QCommandLineOption skew_option("skew",
+        "Zipf exponent of the character distribution; 0 is uniform.",
+        "exponent", "0");
+    QCommandLineOption worlds_option("worlds",
+        "Comma-separated world IDs to generate events for.", "worlds",
+        "1,10,13,17,19,40");
+    QCommandLineOption mix_option("mix",
+        "Event mix as comma-separated Event:weight pairs, e.g. "
+        "\"GainExperience:80,Death:10\".", "mix");
+    QCommandLineOption heartbeat_option("heartbeat",
+        "Send a heartbeat every <seconds> seconds.", "seconds", "30");
+    QCommandLineOption seed_option("seed",
+        "Seed for the random number generator.", "seed");
+    parser.addOptions({ port_option, rate_option, characters_option,
+        skew_option, worlds_option, mix_option, heartbeat_option,
+        seed_option });
+    parser.process(app);
+
+    auto profile = LoadGen::defaultLoadProfile();
+    bool port_ok = false;
+    bool rate_ok = false;
+    bool characters_ok = false;
+    bool skew_ok = false;
+    bool heartbeat_ok = false;
+    auto port = parser.value(port_option).toUShort(&port_ok);
+    auto rate = parser.value(rate_option).toDouble(&rate_ok);
+    profile.character_pool_size_ =
+        parser.value(characters_option).toULongLong(&characters_ok);
+    profile.character_skew_ = parser.value(skew_option).toDouble(&skew_ok);
+    auto heartbeat = parser.value(heartbeat_option).toInt(&heartbeat_ok);
+    if (!port_ok || !rate_ok || rate < 0.0 || !characters_ok
+        || profile.character_pool_size_ == 0 || !skew_ok
+        || profile.character_skew_ < 0.0 || !heartbeat_ok
+        || heartbeat <= 0) {
+        qCritical() << "Invalid numeric option, see --help";
+        return 1;
+    }
+    if (parseWorlds(parser.value(worlds_option), &profile.worlds_) != 0) {
+        qCritical() << "Invalid world list:" << parser.value(worlds_option);
+        return 1;
+    }
+    if (parser.isSet(mix_option) && LoadGen::parseEventMix(
+        parser.value(mix_option).toStdString(),
+        &profile.event_weights_) != 0) {
+        qCritical() << "Invalid event mix:" << parser.value(mix_option);
+        return 1;
+    }
+    std::uint64_t seed = parser.isSet(seed_option)
+        ? parser.value(seed_option).toULongLong()
+        : std::random_device()();
+
+    LoadGen::LoadGenerator generator(profile, seed);
+    generator.setRate(rate);
+    generator.setHeartbeatInterval(heartbeat * 1000);
+    if (generator.listen(port) != 0) {
+        return 1;
+    }
+    return app.exec();
+}